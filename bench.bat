@@ -0,0 +1,9 @@
+@echo off
+echo Building AI Expense Manager with diagnostics...
+g++ -O2 -DAIEXPENSE_DIAGNOSTICS -o bench.exe src/main.cpp -std=c++17 -lwinhttp -lws2_32
+if %ERRORLEVEL% EQU 0 (
+    echo Build successful!
+    echo Run with: bench.exe, then [d] on the main menu
+) else (
+    echo Build failed!
+)
@@ -1,6 +1,6 @@
 @echo off
 echo Building AI Expense Manager...
-g++ -o main.exe src/main.cpp -std=c++17
+g++ -O2 -o main.exe src/main.cpp -std=c++17 -lwinhttp -lws2_32
 if %ERRORLEVEL% EQU 0 (
     echo Build successful!
     echo Run with: main.exe
@@ -1,101 +1,612 @@
 #pragma once
 
 #include "../include/nlohmann/json.hpp"
-#include <array>
-#include <cstdio>
-#include <cstdlib>
-#include <iostream>
+#include "HttpClient.h"
+#include "RequestPolicy.h"
+#include "ResponseCache.h"
+#include "SseParser.h"
+#include "ToolRegistry.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
-#include <sstream>
-#include <stdexcept>
+#include <mutex>
 #include <string>
 #include <vector>
 
 using json = nlohmann::json;
 
+/**
+ * AIRequest - one chat turn running on a background worker
+ *
+ * HOW IT WORKS:
+ * =============
+ * AIModule::chatAsync() returns this handle at once while a worker thread
+ * sends the request and streams the reply into it. The UI thread polls
+ * takeNewText() to print what has arrived, or waits on the future, and
+ * may cancel() at any time: the cancel token breaks the transport's
+ * blocking read, so the worker lets go within milliseconds. Every request
+ * has its own time limit and its own copy of the conversation, so several
+ * can run side by side.
+ */
+class AIRequest {
+public:
+  enum class State { Running, Completed, Failed, Cancelled, TimedOut };
+
+  State getState() const { return state; }
+  bool isFinished() const { return state != State::Running; }
+
+  void cancel() { cancelToken.cancel(); }
+
+  // Wait up to timeoutMs; true once the request has finished
+  bool waitFor(int timeoutMs) const {
+    return result.wait_for(std::chrono::milliseconds(timeoutMs)) == std::future_status::ready;
+  }
+
+  // The reply, or an error message, once finished
+  const std::shared_future<std::string> &getResult() const { return result; }
+
+  // Reply text that arrived since the last call
+  std::string takeNewText() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string text;
+    text.swap(pendingText);
+    return text;
+  }
+
+  // -1 until the first token arrived
+  double getFirstTokenMs() const { return firstTokenMs; }
+
+  // Answered from the response cache without a request
+  bool isFromCache() const { return fromCache; }
+
+  // Requests sent for the turn (more than one when the model called
+  // tools), their total payload size and the tool calls run (valid once
+  // finished)
+  size_t getRoundTrips() const { return roundTrips; }
+  size_t getRequestBytes() const { return requestBytes; }
+  size_t getToolCalls() const { return toolCalls; }
+
+  // Requests sent again after a transient failure, or hedged (valid once
+  // finished)
+  size_t getRetries() const { return retries; }
+
+  // Until finished, or so far
+  double getElapsedMs() const {
+    return isFinished() ? elapsedMs.load() : msSince(started);
+  }
+
+  // Record the turn in the history it was sent from: the reply on
+  // success, otherwise the unanswered question is taken back out
+  void finishTurn(json &conversation_history) const {
+    if (state == State::Completed) {
+      conversation_history.push_back({{"role", "assistant"}, {"content", result.get()}});
+    } else if (!conversation_history.empty() &&
+               conversation_history.back().value("role", "") == "user" &&
+               conversation_history.back().value("content", "") == question) {
+      conversation_history.erase(conversation_history.size() - 1);
+    }
+  }
+
+private:
+  friend class AIModule;
+
+  explicit AIRequest(std::string question)
+      : question(std::move(question)), result(promise.get_future().share()),
+        started(std::chrono::steady_clock::now()) {}
+
+  static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  void appendText(const std::string &text) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingText += text;
+  }
+
+  void finish(State final, const std::string &reply, double firstToken) {
+    firstTokenMs = firstToken;
+    elapsedMs = msSince(started);
+    state = final;
+    promise.set_value(reply);
+  }
+
+  std::string question;
+  std::promise<std::string> promise;
+  std::shared_future<std::string> result;
+  std::chrono::steady_clock::time_point started;
+  std::atomic<State> state{State::Running};
+  std::atomic<double> firstTokenMs{-1};
+  std::atomic<double> elapsedMs{0};
+  bool fromCache = false; // set before the handle is returned
+  size_t roundTrips = 0;  // these four are set before finish()
+  size_t requestBytes = 0;
+  size_t toolCalls = 0;
+  size_t retries = 0;
+  HttpCancelToken cancelToken;
+  std::mutex mutex; // guards pendingText
+  std::string pendingText;
+};
+
 class AIModule {
 public:
-  static std::string chat(const std::string &user_input,
-                          json &conversation_history) {
-    const std::string api_key =
-        "sk-or-v1-"
-        "338cd2242baa61a1b2ea72f4fcc373c98e96328906c5ea6634cc6017df87c01f";
+  // Receives each piece of a streamed reply as it arrives
+  using TokenCallback = std::function<void(const std::string &token)>;
+
+  // Time limit of a chat turn unless the caller picks one
+  static constexpr int DEFAULT_TIMEOUT_MS = 60000;
+
+  static constexpr const char *MODEL = "openai/gpt-3.5-turbo";
+
+  // A model reply asking for tools is answered locally this many times
+  // at most before the turn gives up
+  static constexpr size_t MAX_TOOL_ROUNDS = 4;
 
+  // One chat turn, not streamed. With tools, the model may call them and
+  // get their results in follow-up requests before it answers.
+  static std::string chat(const std::string &user_input, json &conversation_history,
+                          std::shared_ptr<const ToolRegistry> tools = nullptr) {
     // Add user message to history
     conversation_history.push_back({{"role", "user"}, {"content", user_input}});
 
-    // Prepare JSON payload
-    json payload = {{"model", "openai/gpt-3.5-turbo"}, // Default model
-                    {"messages", conversation_history}};
+    // Asked before against the same data: answer from the cache
+    CacheSlot slot = cacheSlot(conversation_history, tools.get());
+    std::string cached;
+    if (slot.lookup(cached)) {
+      conversation_history.push_back({{"role", "assistant"}, {"content", cached}});
+      return cached;
+    }
 
-    std::string payload_str = payload.dump();
+    Completion completion = complete(conversation_history, [](const std::string &) {}, nullptr,
+                                     DEFAULT_TIMEOUT_MS, tools.get(), false);
+    recordLastTurn(completion);
+    if (completion.ok) {
+      // Add AI response to history
+      conversation_history.push_back({{"role", "assistant"}, {"content", completion.text}});
+      if (!completion.interrupted) slot.store(completion.text);
+    }
+    return completion.text;
+  }
 
-    // Write to temp file
-    std::string temp_filename = "temp_request.json";
-    FILE *temp_file = fopen(temp_filename.c_str(), "w");
-    if (temp_file) {
-      fprintf(temp_file, "%s", payload_str.c_str());
-      fclose(temp_file);
-    } else {
-      return "Error: Failed to create temp file!";
+  // Like chat(), but asks for a streamed (SSE) completion and passes the
+  // reply to onToken piece by piece. Returns the whole reply, or an error
+  // message if nothing was streamed (onToken is then never called).
+  static std::string chatStream(const std::string &user_input,
+                                json &conversation_history,
+                                const TokenCallback &onToken,
+                                std::shared_ptr<const ToolRegistry> tools = nullptr) {
+    conversation_history.push_back({{"role", "user"}, {"content", user_input}});
+
+    auto started = std::chrono::steady_clock::now();
+    CacheSlot slot = cacheSlot(conversation_history, tools.get());
+    std::string cached;
+    if (slot.lookup(cached)) {
+      onToken(cached);
+      Completion hit;
+      hit.firstTokenMs = hit.totalMs = AIRequest::msSince(started);
+      recordLastTurn(hit);
+      conversation_history.push_back({{"role", "assistant"}, {"content", cached}});
+      return cached;
     }
 
-    std::string command =
-        "curl.exe -s -X POST https://openrouter.ai/api/v1/chat/completions "
-        "-H \"Content-Type: application/json\" "
-        "-H \"Authorization: Bearer " +
-        api_key +
-        "\" "
-        "-d @" +
-        temp_filename;
+    Completion completion =
+        complete(conversation_history, onToken, nullptr, DEFAULT_TIMEOUT_MS, tools.get());
+    recordLastTurn(completion);
 
-    try {
-      std::string response_str = exec(command.c_str());
+    if (completion.ok) {
+      conversation_history.push_back({{"role", "assistant"}, {"content", completion.text}});
+      if (!completion.interrupted) slot.store(completion.text);
+    }
+    return completion.text;
+  }
+
+  // Streamed chat turn on a background worker. The user message is added
+  // to the history now; call finishTurn() on the request once it is done.
+  // Tools run on the worker too.
+  static std::shared_ptr<AIRequest> chatAsync(const std::string &user_input,
+                                              json &conversation_history,
+                                              std::shared_ptr<const ToolRegistry> tools = nullptr,
+                                              int timeoutMs = DEFAULT_TIMEOUT_MS) {
+    conversation_history.push_back({{"role", "user"}, {"content", user_input}});
+
+    std::shared_ptr<AIRequest> request(new AIRequest(user_input));
+    CacheSlot slot = cacheSlot(conversation_history, tools.get());
+    std::string cached;
+    if (slot.lookup(cached)) {
+      request->fromCache = true;
+      request->appendText(cached);
+      request->finish(AIRequest::State::Completed, cached, AIRequest::msSince(request->started));
+      return request;
+    }
+
+    json messages = conversation_history; // the worker's own copy
+    workers().start(request, [request, messages, timeoutMs, slot, tools] {
+      Completion completion = complete(
+          messages, [&request](const std::string &token) { request->appendText(token); },
+          &request->cancelToken, timeoutMs, tools.get());
+
+      AIRequest::State state = AIRequest::State::Completed;
+      if (completion.cancelled) {
+        state = AIRequest::State::Cancelled;
+      } else if (completion.timedOut) {
+        state = AIRequest::State::TimedOut;
+      } else if (!completion.ok) {
+        state = AIRequest::State::Failed;
+      } else if (!completion.interrupted) {
+        slot.store(completion.text);
+      }
+      request->roundTrips = completion.roundTrips;
+      request->requestBytes = completion.requestBytes;
+      request->toolCalls = completion.toolCalls;
+      request->retries = completion.retries;
+      request->finish(state, completion.text, completion.firstTokenMs);
+    });
+    return request;
+  }
+
+  // Time to the first streamed token of the last chatStream (-1: none)
+  static double getLastFirstTokenMs() { return lastFirstTokenMs; }
 
-      // Cleanup temp file
-      remove(temp_filename.c_str());
+  // Time until the last chatStream reply was complete
+  static double getLastResponseMs() { return lastResponseMs; }
 
-      // Parse response
-      try {
-        auto response_json = json::parse(response_str);
+  // Requests and payload bytes the last chat / chatStream turn took
+  static size_t getLastRoundTrips() { return lastRoundTrips; }
+  static size_t getLastRequestBytes() { return lastRequestBytes; }
 
-        if (response_json.contains("error")) {
-          return "API Error: " + response_json["error"].dump();
-        } else if (response_json.contains("choices") &&
-                   !response_json["choices"].empty()) {
-          std::string ai_content =
-              response_json["choices"][0]["message"]["content"];
+  // Swap the transport, e.g. for one pointed at a local mock server.
+  // Returns the previous one so it can be put back; requests already
+  // running keep the one they started with.
+  static std::shared_ptr<HttpTransport> setTransport(std::shared_ptr<HttpTransport> replacement) {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    std::swap(transport, replacement);
+    return replacement;
+  }
 
-          // Add AI response to history
-          conversation_history.push_back(
-              {{"role", "assistant"}, {"content", ai_content}});
+  static void setEndpoint(const std::string &url) {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    endpoint = url;
+  }
+
+  static std::string currentEndpoint() {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    return endpoint;
+  }
+
+  // Timeouts, retries and hedging for requests through the default
+  // transport (a transport set with setTransport() is used as it is)
+  static void setRequestPolicy(const RequestPolicy &policy) {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    requestPolicy = policy;
+    if (auto wrapped = std::dynamic_pointer_cast<PolicyHttpTransport>(transport)) {
+      wrapped->setPolicy(policy);
+    }
+  }
+
+  // Answer repeated questions from this cache (nullptr: always ask).
+  // Returns the previous cache so it can be put back.
+  static std::shared_ptr<ResponseCache> setResponseCache(std::shared_ptr<ResponseCache> cache) {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    std::swap(responseCache, cache);
+    return cache;
+  }
 
-          return ai_content;
-        } else {
-          return "Unexpected response format: " + response_str;
+  static std::shared_ptr<ResponseCache> currentResponseCache() {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    return responseCache;
+  }
+
+  // Version of the data the conversations are about (the ledger and the
+  // budgets), part of every cache key so replies about older data are
+  // never reused
+  static void setDataVersionSource(std::function<uint64_t()> source) {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    dataVersion = std::move(source);
+  }
+
+private:
+  // Outcome of one completion request
+  struct Completion {
+    std::string text; // the reply, or an error message
+    bool ok = false;  // text is a reply
+    bool interrupted = false; // the reply broke off; text is what arrived (never cached)
+    bool cancelled = false;
+    bool timedOut = false;
+    double firstTokenMs = -1;
+    double totalMs = 0;
+    size_t roundTrips = 0;   // requests sent (one more per round of tool calls)
+    size_t requestBytes = 0; // their payloads together
+    size_t toolCalls = 0;
+    size_t retries = 0;      // requests sent again by the request policy
+  };
+
+  // Where a conversation's reply is found or stored in the cache
+  struct CacheSlot {
+    std::shared_ptr<ResponseCache> cache; // null when caching is off
+    std::string key;
+
+    bool lookup(std::string &reply) const { return cache && cache->get(key, reply); }
+    void store(const std::string &reply) const {
+      if (cache) cache->put(key, reply);
+    }
+  };
+
+  // Background threads for chatAsync. Requests still running at exit are
+  // cancelled so joining the threads doesn't wait on the network.
+  class Workers {
+  public:
+    ~Workers() {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto &weak : running) {
+        if (auto request = weak.lock()) request->cancel();
+      }
+    }
+
+    void start(const std::shared_ptr<AIRequest> &request, std::function<void()> job) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        running.erase(std::remove_if(running.begin(), running.end(),
+                                     [](const std::weak_ptr<AIRequest> &weak) {
+                                       auto r = weak.lock();
+                                       return !r || r->isFinished();
+                                     }),
+                      running.end());
+        running.push_back(request);
+      }
+      pool.submit(std::move(job));
+    }
+
+  private:
+    WorkerPool pool{4}; // destroyed (joined) after the destructor body ran
+    std::mutex mutex;   // guards running
+    std::vector<std::weak_ptr<AIRequest>> running;
+  };
+
+  static inline std::mutex settingsMutex; // guards transport, endpoint and the cache settings
+  static inline std::shared_ptr<HttpTransport> transport;
+  static inline RequestPolicy requestPolicy;
+  static inline std::string endpoint = "https://openrouter.ai/api/v1/chat/completions";
+  static inline std::shared_ptr<ResponseCache> responseCache;
+  static inline std::function<uint64_t()> dataVersion;
+  static inline std::atomic<double> lastFirstTokenMs{-1};
+  static inline std::atomic<double> lastResponseMs{0};
+  static inline std::atomic<size_t> lastRoundTrips{0};
+  static inline std::atomic<size_t> lastRequestBytes{0};
+
+  static void recordLastTurn(const Completion &completion) {
+    lastFirstTokenMs = completion.firstTokenMs;
+    lastResponseMs = completion.totalMs;
+    lastRoundTrips = completion.roundTrips;
+    lastRequestBytes = completion.requestBytes;
+  }
+
+  static Workers &workers() {
+    static Workers instance;
+    return instance;
+  }
+
+  // Replies given with tools offered are cached apart from plain ones
+  static CacheSlot cacheSlot(const json &messages, const ToolRegistry *tools) {
+    CacheSlot slot;
+    std::function<uint64_t()> version;
+    {
+      std::lock_guard<std::mutex> lock(settingsMutex);
+      slot.cache = responseCache;
+      version = dataVersion;
+    }
+    if (slot.cache) {
+      std::string model = std::string(MODEL) + (tools && !tools->empty() ? "+tools" : "");
+      slot.key = ResponseCache::makeKey(model, messages, version ? version() : 0);
+    }
+    return slot;
+  }
+
+  // Created on first use and kept, so its connections stay warm
+  static std::shared_ptr<HttpTransport> currentTransport() {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    if (!transport) {
+      transport = std::make_shared<PolicyHttpTransport>(createDefaultTransport(), requestPolicy);
+    }
+    return transport;
+  }
+
+  static HttpHeaders requestHeaders() {
+    const std::string api_key =
+        "sk-or-v1-"
+        "338cd2242baa61a1b2ea72f4fcc373c98e96328906c5ea6634cc6017df87c01f";
+    return {{"Content-Type", "application/json"}, {"Authorization", "Bearer " + api_key}};
+  }
+
+  // Ask for a completion of the messages, streamed unless stream is
+  // false. Tokens go to onToken as they arrive; a body that isn't an event
+  // stream (API errors, servers that ignore "stream") is read like a normal
+  // completion. When the reply asks for tool calls instead, they are run
+  // and their results sent back in another request, until the model
+  // answers (at most MAX_TOOL_ROUNDS rounds of calls).
+  static Completion complete(const json &messages, const TokenCallback &onToken,
+                             HttpCancelToken *cancel, int timeoutMs,
+                             const ToolRegistry *tools = nullptr, bool stream = true) {
+    auto started = std::chrono::steady_clock::now();
+    auto elapsedMs = [&started] {
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                       started).count();
+    };
+
+    Completion completion;
+    json conversation = messages; // plus the tool calls and results of this turn
+    std::string content;          // reply text of all rounds
+    std::string error;            // why the turn stopped short ("" if it didn't)
+    auto addText = [&](const std::string &text) {
+      if (text.empty()) return;
+      if (completion.firstTokenMs < 0) completion.firstTokenMs = elapsedMs();
+      content += text;
+      onToken(text);
+    };
+
+    while (true) {
+      json payload = {{"model", MODEL}, {"messages", conversation}};
+      if (stream) payload["stream"] = true;
+      if (tools && !tools->empty()) payload["tools"] = tools->getSchema();
+
+      json toolCalls = json::array();
+      bool sawDone = false; // a stream without its [DONE] event was cut short
+      SseParser parser([&](const std::string &data) {
+        if (data == "[DONE]") {
+          sawDone = true;
+          return true;
         }
+        try {
+          json chunk = json::parse(data);
+          if (chunk.contains("error")) {
+            error = "API Error: " + chunk["error"].dump();
+            return false;
+          }
+          if (chunk.contains("choices") && !chunk["choices"].empty()) {
+            const json &delta = chunk["choices"][0].value("delta", json::object());
+            if (delta.contains("content") && delta["content"].is_string()) {
+              addText(delta["content"].get<std::string>());
+            }
+            if (delta.contains("tool_calls") && delta["tool_calls"].is_array()) {
+              mergeToolCalls(toolCalls, delta["tool_calls"]);
+            }
+          }
+        } catch (json::exception &) {
+          // Skip events that aren't completion chunks
+        }
+        return true;
+      });
+
+      HttpRequestOptions options;
+      options.cancel = cancel;
+      options.timeoutMs = std::max(1, timeoutMs - static_cast<int>(elapsedMs()));
+      std::string plainBody;
+      options.onBody = [&](const char *data, size_t size) {
+        if (parser.getEventCount() == 0) plainBody.append(data, size);
+        return parser.feed(data, size);
+      };
+
+      std::string body = payload.dump();
+      completion.roundTrips++;
+      completion.requestBytes += body.size();
+      HttpResponse response =
+          currentTransport()->post(currentEndpoint(), requestHeaders(), body, options);
+      parser.finish();
+      completion.retries += static_cast<size_t>(std::max(0, response.attempts - 1));
+      completion.cancelled = cancel && cancel->isCancelled();
+      completion.timedOut = response.timedOut;
+
+      if (completion.cancelled || !error.empty()) break;
+      if (!response.error.empty()) {
+        error = "Error executing request: " + response.error;
+        break;
+      }
+      if (parser.getEventCount() > 0 && !sawDone) {
+        error = "The reply stream ended early";
+        break;
+      }
+      if (parser.getEventCount() == 0) {
+        std::string text;
+        if (!readCompletion(plainBody, text, &toolCalls)) {
+          error = text;
+          break;
+        }
+        addText(text);
+      } else if (content.empty() && toolCalls.empty()) {
+        error = "Unexpected response format: empty stream";
+        break;
+      }
+
+      if (toolCalls.empty()) break; // the answer
+      if (!tools || completion.roundTrips > MAX_TOOL_ROUNDS) {
+        error = "The model kept asking for tools";
+        break;
+      }
 
-      } catch (json::parse_error &e) {
-        return "JSON Parse Error: " + std::string(e.what());
+      // Run the calls and send their results back
+      conversation.push_back(
+          {{"role", "assistant"}, {"content", nullptr}, {"tool_calls", toolCalls}});
+      for (const auto &call : toolCalls) {
+        const json &function = call.value("function", json::object());
+        std::string result =
+            tools->call(function.value("name", ""), function.value("arguments", ""));
+        completion.toolCalls++;
+        conversation.push_back(
+            {{"role", "tool"}, {"tool_call_id", call.value("id", "")}, {"content", result}});
       }
+    }
+    completion.totalMs = elapsedMs();
+
+    if (content.empty()) {
+      completion.text = completion.cancelled ? "Request cancelled" : error;
+      completion.ok = !completion.cancelled && error.empty();
+      return completion;
+    }
 
-    } catch (std::exception &e) {
-      remove(temp_filename.c_str());
-      return "Error executing request: " + std::string(e.what());
+    // Keep what arrived even if the stream broke off
+    if (!completion.cancelled && !error.empty()) {
+      completion.interrupted = true;
+      onToken("\n[Reply interrupted: " + error + "]");
     }
+    completion.text = content;
+    completion.ok = !completion.cancelled;
+    return completion;
   }
 
-private:
-  static std::string exec(const char *cmd) {
-    std::array<char, 128> buffer;
-    std::string result;
-    std::unique_ptr<FILE, decltype(&_pclose)> pipe(_popen(cmd, "r"), _pclose);
-    if (!pipe) {
-      throw std::runtime_error("popen() failed!");
+  // Fold streamed tool call pieces into whole calls: each delta names the
+  // call by index and carries part of its id, name or arguments
+  static void mergeToolCalls(json &calls, const json &deltas) {
+    for (const auto &delta : deltas) {
+      size_t index = delta.value("index", static_cast<size_t>(0));
+      while (calls.size() <= index) {
+        calls.push_back({{"id", ""},
+                         {"type", "function"},
+                         {"function", {{"name", ""}, {"arguments", ""}}}});
+      }
+      json &call = calls[index];
+      if (delta.contains("id") && delta["id"].is_string()) call["id"] = delta["id"];
+      const json &function = delta.value("function", json::object());
+      for (const char *field : {"name", "arguments"}) {
+        if (function.contains(field) && function[field].is_string()) {
+          call["function"][field] =
+              call["function"][field].get<std::string>() + function[field].get<std::string>();
+        }
+      }
     }
-    while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr) {
-      result += buffer.data();
+  }
+
+  // Reply text of a complete (non-streamed) response, and the tool calls
+  // it asks for if toolCalls is given. False if the text is an error
+  // message instead.
+  static bool readCompletion(const std::string &response_str, std::string &reply,
+                             json *toolCalls = nullptr) {
+    try {
+      auto response_json = json::parse(response_str);
+
+      if (response_json.contains("error")) {
+        reply = "API Error: " + response_json["error"].dump();
+        return false;
+      } else if (response_json.contains("choices") &&
+                 !response_json["choices"].empty()) {
+        const json &message = response_json["choices"][0].value("message", json::object());
+        reply = message.contains("content") && message["content"].is_string()
+                    ? message["content"].get<std::string>()
+                    : "";
+        if (toolCalls && message.contains("tool_calls") && message["tool_calls"].is_array()) {
+          *toolCalls = message["tool_calls"];
+        }
+        return true;
+      } else {
+        reply = "Unexpected response format: " + response_str;
+        return false;
+      }
+
+    } catch (json::parse_error &e) {
+      reply = "JSON Parse Error: " + std::string(e.what());
+      return false;
     }
-    return result;
   }
 };
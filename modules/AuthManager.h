@@ -1,8 +1,17 @@
 #pragma once
 #include "User.h"
 #include "FileHandler.h"
+#include "SessionKey.h"
+#include <memory>
 using namespace std;
 
+/**
+ * AuthManager - setup, login and the session key
+ *
+ * The password is only used to derive the SessionKey (see SessionKey.h),
+ * once per login; the key, not the password, encrypts the data files.
+ * Data from before session keys is re-encrypted on its first login.
+ */
 class AuthManager
 {
 public:
@@ -21,11 +30,14 @@ public:
             return false;
         }
 
-        // Create user and save (encrypt with password)
-        User newUser(username, password);
+        // Derive the session key, then create the user and save (encrypted with the key)
+        shared_ptr<const SessionKey> key = SessionKey::create(password);
+        User newUser(username, "");
         FileHandler::ensureDataDirectory();
-        FileHandler::writeUserToFile(newUser, password);
+        FileHandler::writeKeyParams(key->getParams());
+        FileHandler::writeUserToFile(newUser, *key);
         currentUser = newUser;
+        sessionKey = key;
 
         return true;
     }
@@ -33,26 +45,94 @@ public:
     // Login user
     static bool login(const string &password)
     {
-        // Try to decrypt and read user file with provided password
-        User storedUser = FileHandler::readUserFromFile(password);
+        shared_ptr<const SessionKey> key;
+        SessionKey::Params params;
+        if (FileHandler::readKeyParams(params))
+        {
+            // The stored check value tells whether the password derives the right key
+            key = SessionKey::derive(password, params.salt, params.iterations);
+            if (!key->matches(params.check))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // Data from before session keys: the password itself was the key
+            User storedUser = FileHandler::readUserFromFile(password);
+            if (storedUser.getUsername().empty() || storedUser.getPassword() != password)
+            {
+                return false;
+            }
+            key = SessionKey::create(password);
+            FileHandler::writeKeyParams(key->getParams());
+        }
 
-        // If decryption succeeded and we got a valid user, check if password matches
-        // (If password was wrong, readUserFromFile returns empty user)
-        if (!storedUser.getUsername().empty() && storedUser.getPassword() == password)
+        // Move any file still encrypted with the password over to the key
+        // (also finishes a migration that was interrupted)
+        FileHandler::migrateToSessionKey(FileHandler::userFile(), password, *key);
+        FileHandler::migrateToSessionKey(FileHandler::transactionsFile(), password, *key);
+        FileHandler::migrateToSessionKey(FileHandler::aiCacheFile(), password, *key);
+
+        // A ledger header written with another key means the ledger isn't
+        // this user's (e.g. a data folder copied over): don't open it
+        LedgerHeader header;
+        FileHandler::readLedgerHeader(*key, header);
+        if (!header.keyCheck.empty() && !key->matches(header.keyCheck))
         {
-            currentUser = storedUser;
-            return true;
+            cerr << "Error: The transactions file is encrypted with a different key.\n";
+            return false;
         }
 
-        return false;
+        User storedUser = FileHandler::readUserFromFile(*key);
+        if (storedUser.getUsername().empty())
+        {
+            return false;
+        }
+        if (!storedUser.getPassword().empty())
+        {
+            // Old user files kept the password; the key check replaces it
+            storedUser.setPassword("");
+            FileHandler::writeUserToFile(storedUser, *key);
+        }
+
+        currentUser = storedUser;
+        sessionKey = key;
+        return true;
+    }
+
+    static bool isLoggedIn()
+    {
+        return sessionKey != nullptr;
+    }
+
+    // Forget the user and the session key (the key is wiped once nothing holds it)
+    static void logout()
+    {
+        currentUser = User();
+        sessionKey.reset();
     }
 
     // Get current user
-    static User getCurrentUser()
+    static const User &getCurrentUser()
     {
         return currentUser;
     }
 
+    // The key derived at login (a key that encrypts nothing before then)
+    static const SessionKey &getSessionKey()
+    {
+        static const SessionKey noKey;
+        return sessionKey ? *sessionKey : noKey;
+    }
+
+    // Shared ownership of the key, for work that may outlive the caller
+    static shared_ptr<const SessionKey> shareSessionKey()
+    {
+        return sessionKey;
+    }
+
 private:
     static inline User currentUser;
+    static inline shared_ptr<const SessionKey> sessionKey;
 };
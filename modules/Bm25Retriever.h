@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Categorizer.h"
+#include "LedgerIndex.h"
+#include "TextSearch.h"
+#include "Transaction.h"
+
+/**
+ * Bm25Retriever - the ledger rows most relevant to a question
+ *
+ * HOW IT WORKS:
+ * =============
+ * The question is split into words like the LedgerIndex term index
+ * (case-folded), with filler words dropped and month names shortened to
+ * the index's month terms ("March" -> "mar"). Each remaining term that
+ * occurs in the ledger adds its Okapi BM25 weight to the rows in its
+ * bitmap:
+ *
+ *   idf(t) * (k1 + 1) / (1 + k1 * (1 - b + b * length / averageLength))
+ *
+ * (descriptions are short, so term frequency is taken as 1). Scores are
+ * accumulated in a dense array and only the rows touched by a posting
+ * list are visited, so a question costs O(postings of its terms), a few
+ * milliseconds on a million rows. Ties go to the newer row.
+ */
+class Bm25Retriever {
+public:
+  static constexpr double K1 = 1.2;
+  static constexpr double B = 0.75;
+  static constexpr size_t DEFAULT_TOP_K = 8;
+
+  struct Hit {
+    uint32_t row;
+    double score;
+  };
+
+  // Best rows first, at most k (none if no term of the question is indexed)
+  static std::vector<Hit> search(const LedgerIndex &index, const std::string &question,
+                                 size_t k = DEFAULT_TOP_K) {
+    std::vector<Hit> hits;
+    if (index.size() == 0) return hits;
+
+    double rows = static_cast<double>(index.size());
+    double averageLength = std::max(1.0, index.averageTermCount());
+    std::vector<const RoaringBitmap *> postings;
+    std::vector<double> weights;
+    for (const std::string &term : queryTerms(question)) {
+      const RoaringBitmap &matching = index.byTerm(term);
+      double count = static_cast<double>(matching.cardinality());
+      if (count == 0) continue;
+      postings.push_back(&matching);
+      weights.push_back(std::log(1.0 + (rows - count + 0.5) / (count + 0.5)));
+    }
+    if (postings.empty()) return hits;
+
+    std::vector<float> scores(index.size(), 0.0f);
+    std::vector<uint32_t> touched;
+    for (size_t i = 0; i < postings.size(); i++) {
+      double idf = weights[i];
+      postings[i]->forEach([&](uint32_t row) {
+        double length = index.termCountAt(row) / averageLength;
+        if (scores[row] == 0.0f) touched.push_back(row);
+        scores[row] += static_cast<float>(idf * (K1 + 1) / (1 + K1 * (1 - B + B * length)));
+      });
+    }
+
+    hits.reserve(touched.size());
+    for (uint32_t row : touched) hits.push_back({row, scores[row]});
+    auto better = [](const Hit &a, const Hit &b) {
+      return a.score != b.score ? a.score > b.score : a.row > b.row;
+    };
+    size_t keep = std::min(k, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + keep, hits.end(), better);
+    hits.resize(keep);
+    return hits;
+  }
+
+  // Folded question words worth looking up
+  static std::vector<std::string> queryTerms(const std::string &question) {
+    static const char *months[] = {"january", "february", "march",     "april",
+                                   "may",     "june",     "july",      "august",
+                                   "september", "october", "november", "december"};
+    std::string folded = question;
+    for (char &c : folded) c = TextSearch::foldCase(c);
+
+    std::vector<std::string> terms;
+    LedgerIndex::forEachWord(folded, [&](std::string_view word) {
+      if (isStopWord(word)) return;
+      std::string term(word);
+      for (int m = 0; m < 12; m++) {
+        if (term == months[m]) term = LedgerIndex::monthTerm(m + 1);
+      }
+      if (std::find(terms.begin(), terms.end(), term) == terms.end()) terms.push_back(term);
+    });
+    return terms;
+  }
+
+  // Prompt block listing the best rows for a question ("" if none match)
+  static std::string describe(const std::vector<Transaction> &ledger, const LedgerIndex &index,
+                              const std::string &question, size_t k = DEFAULT_TOP_K) {
+    std::vector<Hit> hits = search(index, question, k);
+    if (hits.empty()) return "";
+
+    std::string block = "Transactions matching the question (best match first):";
+    for (const Hit &hit : hits) {
+      const Transaction &t = ledger[hit.row];
+      char amount[32];
+      std::snprintf(amount, sizeof(amount), "%s%.2f", t.getType() == "income" ? "+" : "-",
+                    t.getAmount());
+      block += "\n#" + std::to_string(t.getId()) + " " + t.getDate() + " " + amount + " " +
+               t.getDescription() + " (" + Categorizer::categorize(t.getDescription()) + ")";
+    }
+    return block;
+  }
+
+private:
+  static bool isStopWord(std::string_view word) {
+    static const char *words[] = {"a",    "an",   "and",  "are",   "at",    "did",  "do",
+                                  "for",  "from", "how",  "i",     "in",    "is",   "it",
+                                  "me",   "much", "my",   "of",    "on",    "that", "the",
+                                  "this", "to",   "was",  "were",  "what",  "when", "where",
+                                  "which", "who", "why",  "with",  "spend", "spent"};
+    for (const char *stop : words) {
+      if (word == stop) return true;
+    }
+    return false;
+  }
+};
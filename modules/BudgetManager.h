@@ -1,10 +1,12 @@
 #pragma once
 
 #include "../include/nlohmann/json.hpp"
+#include "Categorizer.h"
 #include "FileHandler.h"
 #include "Transaction.h"
 #include "TransactionManager.h"
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <iomanip>
 #include <map>
@@ -40,7 +42,7 @@ struct Budget {
 class BudgetManager {
 private:
   static std::string getBudgetFilePath() {
-    return "data/budgets.json";
+    return FileHandler::getDataDirectory() + "/budgets.json";
   }
 
 public:
@@ -106,106 +108,22 @@ public:
 
   // Categorize transaction
   static std::string categorize(const std::string& description) {
-    std::string desc = description;
-    std::transform(desc.begin(), desc.end(), desc.begin(), ::tolower);
-
-    if (desc.find("food") != std::string::npos ||
-        desc.find("restaurant") != std::string::npos ||
-        desc.find("grocery") != std::string::npos ||
-        desc.find("cafe") != std::string::npos ||
-        desc.find("dining") != std::string::npos ||
-        desc.find("meal") != std::string::npos ||
-        desc.find("lunch") != std::string::npos ||
-        desc.find("dinner") != std::string::npos ||
-        desc.find("breakfast") != std::string::npos ||
-        desc.find("coffee") != std::string::npos ||
-        desc.find("pizza") != std::string::npos ||
-        desc.find("donut") != std::string::npos) {
-      return "Food";
-    }
-    
-    if (desc.find("transport") != std::string::npos ||
-        desc.find("uber") != std::string::npos ||
-        desc.find("lyft") != std::string::npos ||
-        desc.find("taxi") != std::string::npos ||
-        desc.find("gas") != std::string::npos ||
-        desc.find("fuel") != std::string::npos ||
-        desc.find("bus") != std::string::npos ||
-        desc.find("train") != std::string::npos ||
-        desc.find("metro") != std::string::npos ||
-        desc.find("car") != std::string::npos) {
-      return "Transport";
-    }
-    
-    if (desc.find("rent") != std::string::npos ||
-        desc.find("housing") != std::string::npos ||
-        desc.find("mortgage") != std::string::npos ||
-        desc.find("apartment") != std::string::npos) {
-      return "Housing";
-    }
-    
-    if (desc.find("utility") != std::string::npos ||
-        desc.find("electric") != std::string::npos ||
-        desc.find("water") != std::string::npos ||
-        desc.find("internet") != std::string::npos ||
-        desc.find("phone") != std::string::npos ||
-        desc.find("power") != std::string::npos ||
-        desc.find("bill") != std::string::npos) {
-      return "Utilities";
-    }
-    
-    if (desc.find("shop") != std::string::npos ||
-        desc.find("amazon") != std::string::npos ||
-        desc.find("store") != std::string::npos ||
-        desc.find("mall") != std::string::npos ||
-        desc.find("clothes") != std::string::npos ||
-        desc.find("buy") != std::string::npos) {
-      return "Shopping";
-    }
-    
-    if (desc.find("entertainment") != std::string::npos ||
-        desc.find("movie") != std::string::npos ||
-        desc.find("game") != std::string::npos ||
-        desc.find("netflix") != std::string::npos ||
-        desc.find("spotify") != std::string::npos ||
-        desc.find("subscription") != std::string::npos ||
-        desc.find("concert") != std::string::npos) {
-      return "Entertainment";
-    }
-    
-    if (desc.find("health") != std::string::npos ||
-        desc.find("doctor") != std::string::npos ||
-        desc.find("medicine") != std::string::npos ||
-        desc.find("pharmacy") != std::string::npos ||
-        desc.find("hospital") != std::string::npos ||
-        desc.find("gym") != std::string::npos) {
-      return "Health";
-    }
-
-    return "Other";
+    return Categorizer::categorize(description);
   }
 
   // Get all budgets with current spending
   static std::vector<Budget> getAllBudgets() {
     auto budgetLimits = loadBudgets();
-    auto transactions = TransactionManager::getAllTransactions();
+    const LedgerIndex& index = TransactionManager::getIndex();
+    const RoaringBitmap& expenses = index.byType("expense");
 
-    // Calculate spending per category
-    std::map<std::string, double> categorySpent;
-    for (const auto& t : transactions) {
-      if (t.getType() == "expense") {
-        std::string category = categorize(t.getDescription());
-        categorySpent[category] += t.getAmount();
-      }
-    }
-
-    // Build budget list
+    // Build budget list, summing expense rows of each category
     std::vector<Budget> result;
     for (const auto& [category, limit] : budgetLimits) {
       Budget b;
       b.category = category;
       b.limit = limit;
-      b.spent = categorySpent[category];
+      b.spent = index.sum(expenses & index.byCategory(category));
       result.push_back(b);
     }
 
@@ -253,6 +171,21 @@ public:
     // This is a placeholder - in a real app you might want to reset a month marker
   }
 
+  // Changes whenever a budget is set, changed or deleted (FNV-1a over
+  // the categories and limits; spending is part of the ledger's version)
+  static uint64_t getVersion() {
+    uint64_t version = 14695981039346656037ull;
+    auto fold = [&version](const void* data, size_t size) {
+      const unsigned char* bytes = static_cast<const unsigned char*>(data);
+      for (size_t i = 0; i < size; i++) version = (version ^ bytes[i]) * 1099511628211ull;
+    };
+    for (const auto& [category, limit] : loadBudgets()) {
+      fold(category.c_str(), category.size() + 1);
+      fold(&limit, sizeof(limit));
+    }
+    return version;
+  }
+
   // Get total budget limit
   static double getTotalBudget() {
     double total = 0;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "TextSearch.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// A spending category and the description keywords that map to it
+struct CategoryRule {
+  std::string name;
+  std::vector<std::string> keywords;
+};
+
+class Categorizer {
+public:
+  // Rules are checked in order; the first keyword hit wins
+  static const std::vector<CategoryRule> &getRules() {
+    static const std::vector<CategoryRule> rules = {
+        {"Food",
+         {"food", "restaurant", "grocery", "cafe", "dining", "meal", "lunch",
+          "dinner", "breakfast", "coffee", "pizza", "donut"}},
+        {"Transport",
+         {"transport", "uber", "lyft", "taxi", "gas", "fuel", "bus", "train",
+          "metro", "car"}},
+        {"Housing", {"rent", "housing", "mortgage", "apartment"}},
+        {"Utilities",
+         {"utility", "electric", "water", "internet", "phone", "power",
+          "bill"}},
+        {"Shopping",
+         {"shop", "amazon", "store", "mall", "clothes", "buy", "purchase"}},
+        {"Entertainment",
+         {"entertainment", "movie", "game", "netflix", "spotify",
+          "subscription", "concert"}},
+        {"Health",
+         {"health", "doctor", "medicine", "pharmacy", "hospital", "gym"}},
+        {"Salary", {"salary", "job", "income", "paycheck", "wage"}}};
+    return rules;
+  }
+
+  // All category names, "Other" last. Position is the category id.
+  static const std::vector<std::string> &getCategoryNames() {
+    static const std::vector<std::string> names = [] {
+      std::vector<std::string> list;
+      for (const auto &rule : getRules()) list.push_back(rule.name);
+      list.push_back("Other");
+      return list;
+    }();
+    return names;
+  }
+
+  static int getOtherId() {
+    return static_cast<int>(getCategoryNames().size()) - 1;
+  }
+
+  // Category id for a name, or -1 if unknown
+  static int getCategoryId(const std::string &name) {
+    const auto &names = getCategoryNames();
+    auto it = std::find(names.begin(), names.end(), name);
+    return it == names.end() ? -1 : static_cast<int>(it - names.begin());
+  }
+
+  // Categorize a description to a category id (no lower-cased copy)
+  static int categorizeId(const std::string &description) {
+    const auto &rules = getRules();
+    for (size_t i = 0; i < rules.size(); i++) {
+      for (const auto &keyword : rules[i].keywords) {
+        if (TextSearch::containsIgnoreCase(description, keyword)) {
+          return static_cast<int>(i);
+        }
+      }
+    }
+    return getOtherId();
+  }
+
+  // Categorize a description to a category name
+  static const std::string &categorize(const std::string &description) {
+    return getCategoryNames()[categorizeId(description)];
+  }
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "../include/nlohmann/json.hpp"
+#include "TokenEstimator.h"
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <string>
+
+using json = nlohmann::json;
+
+/**
+ * ConversationManager - chat history with a token cap
+ *
+ * HOW IT WORKS:
+ * =============
+ * The history sent with each turn is laid out as:
+ *
+ *   [system prompts...] [summary of older turns] [recent turns verbatim]
+ *
+ * System prompts are pinned. Before each turn compact() checks the
+ * estimated size; while it is over the cap, the oldest question/answer
+ * pair is taken out and folded into the summary as one short line (the
+ * question and the first sentence of the answer). The summary has its own
+ * budget (at most a quarter of the cap): past it, its oldest lines give
+ * way to a count of omitted turns. The summary is built locally, so
+ * compacting costs no request, and the size of every request stays flat
+ * however long the chat runs.
+ */
+class ConversationManager {
+public:
+  static constexpr size_t DEFAULT_TOKEN_CAP = 2500;
+  static constexpr size_t SUMMARY_TOKEN_CAP = 400;
+  static constexpr size_t KEEP_RECENT_MESSAGES = 4; // last two turns always verbatim
+
+  explicit ConversationManager(size_t tokenCap = DEFAULT_TOKEN_CAP) : tokenCap(tokenCap) {}
+
+  // Pinned system message (add these before the first turn)
+  void addSystem(const std::string &content) {
+    messages.insert(messages.begin() + pinnedCount,
+                    json{{"role", "system"}, {"content", content}});
+    pinnedCount++;
+  }
+
+  // Messages to send; chat turns append to it
+  json &history() { return messages; }
+
+  // Fold the oldest turns into the summary until the history fits the cap
+  void compact() {
+    while (estimateTokens(messages) > tokenCap && turnCount() > KEEP_RECENT_MESSAGES) {
+      size_t first = firstTurn();
+      std::string line = "- Asked: " + clip(firstLine(contentOf(messages[first])), 100);
+      size_t taken = 1;
+      if (first + 1 < messages.size() && messages[first + 1].value("role", "") == "assistant") {
+        line += " / Answered: " + clip(firstSentence(contentOf(messages[first + 1])), 140);
+        taken = 2;
+      }
+      messages.erase(messages.begin() + first, messages.begin() + first + taken);
+      foldIntoSummary(line);
+    }
+  }
+
+  // Turns folded into the summary so far
+  size_t getSummarizedTurns() const { return summarizedTurns; }
+
+  // Estimated tokens of the messages as they would be sent
+  static size_t estimateTokens(const json &conversation) {
+    size_t tokens = 0;
+    for (const auto &message : conversation) {
+      tokens += TokenEstimator::MESSAGE_OVERHEAD + TokenEstimator::estimate(contentOf(message));
+    }
+    return tokens;
+  }
+
+private:
+  static std::string contentOf(const json &message) {
+    auto it = message.find("content");
+    return it != message.end() && it->is_string() ? it->get<std::string>() : std::string();
+  }
+
+  // The question itself, without context attached below it
+  static std::string firstLine(const std::string &text) {
+    return text.substr(0, text.find('\n'));
+  }
+
+  static std::string firstSentence(const std::string &text) {
+    size_t end = text.find_first_of(".!?\n");
+    return end == std::string::npos ? text : text.substr(0, end + (text[end] == '\n' ? 0 : 1));
+  }
+
+  // At most maxLength bytes on one line, cut at a UTF-8 character boundary
+  static std::string clip(std::string text, size_t maxLength) {
+    for (char &c : text) {
+      if (c == '\n' || c == '\r') c = ' ';
+    }
+    if (text.size() <= maxLength) return text;
+    size_t cut = maxLength;
+    while (cut > 0 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80) cut--;
+    return text.substr(0, cut) + "...";
+  }
+
+  size_t firstTurn() const { return pinnedCount + (summaryLines.empty() ? 0 : 1); }
+  size_t turnCount() const { return messages.size() - firstTurn(); }
+
+  void foldIntoSummary(const std::string &line) {
+    bool hadSummary = !summaryLines.empty();
+    summaryLines.push_back(line);
+    summarizedTurns++;
+    while (summaryLines.size() > 1 &&
+           TokenEstimator::estimate(summaryText()) > std::min(SUMMARY_TOKEN_CAP, tokenCap / 4)) {
+      summaryLines.pop_front();
+      omittedTurns++;
+    }
+
+    json summary = {{"role", "system"}, {"content", summaryText()}};
+    if (hadSummary) {
+      messages[pinnedCount] = summary;
+    } else {
+      messages.insert(messages.begin() + pinnedCount, summary);
+    }
+  }
+
+  std::string summaryText() const {
+    std::string text = "Summary of the earlier conversation:";
+    if (omittedTurns > 0) {
+      text += "\n- (" + std::to_string(omittedTurns) + " earlier turns omitted)";
+    }
+    for (const auto &line : summaryLines) text += "\n" + line;
+    return text;
+  }
+
+  size_t tokenCap;
+  json messages = json::array();
+  size_t pinnedCount = 0;               // system prompts at the front
+  std::deque<std::string> summaryLines; // one per folded turn, oldest first
+  size_t summarizedTurns = 0;
+  size_t omittedTurns = 0;              // folded turns dropped from the summary
+};
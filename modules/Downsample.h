@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// One point of a series
+struct SeriesPoint
+{
+  double x;
+  double y;
+};
+
+// Lowest and highest value of one envelope bucket
+struct EnvelopeBucket
+{
+  double x; // bucket centre
+  double low;
+  double high;
+};
+
+/**
+ * Downsample - reduce a series to about one point per chart pixel column
+ *
+ * HOW IT WORKS:
+ * =============
+ * - lttb(): Largest-Triangle-Three-Buckets. The first and last points are
+ *   kept; the rest are split into (threshold - 2) equal buckets. From each
+ *   bucket the point forming the largest triangle with the previously kept
+ *   point and the average of the next bucket is kept, which preserves peaks
+ *   and the overall shape. One pass, O(n).
+ * - minMaxEnvelope(): splits the x range into equal buckets and keeps the
+ *   lowest and highest value of each, so no spike is ever dropped. O(n).
+ *
+ * Both expect points sorted by x. Series that already fit are returned as is.
+ */
+class Downsample
+{
+public:
+  static vector<SeriesPoint> lttb(const vector<SeriesPoint> &data, size_t threshold)
+  {
+    const size_t n = data.size();
+    if (threshold >= n || threshold < 3)
+      return data;
+
+    vector<SeriesPoint> sampled;
+    sampled.reserve(threshold);
+    sampled.push_back(data[0]);
+
+    const double bucketSize = static_cast<double>(n - 2) / (threshold - 2);
+    size_t a = 0; // index of the last kept point
+
+    for (size_t i = 0; i < threshold - 2; i++)
+    {
+      // Current bucket [start, end)
+      size_t start = static_cast<size_t>(floor(i * bucketSize)) + 1;
+      size_t end = static_cast<size_t>(floor((i + 1) * bucketSize)) + 1;
+      end = min(end, n - 1);
+
+      // Average of the next bucket (the last point for the final bucket)
+      size_t nextStart = end;
+      size_t nextEnd = min(static_cast<size_t>(floor((i + 2) * bucketSize)) + 1, n);
+      double avgX = 0.0, avgY = 0.0;
+      for (size_t j = nextStart; j < nextEnd; j++)
+      {
+        avgX += data[j].x;
+        avgY += data[j].y;
+      }
+      size_t count = nextEnd - nextStart;
+      if (count > 0)
+      {
+        avgX /= count;
+        avgY /= count;
+      }
+      else
+      {
+        avgX = data[n - 1].x;
+        avgY = data[n - 1].y;
+      }
+
+      // Point of the current bucket with the largest triangle area
+      double maxArea = -1.0;
+      size_t chosen = start;
+      for (size_t j = start; j < end; j++)
+      {
+        double area = fabs((data[a].x - avgX) * (data[j].y - data[a].y) -
+                           (data[a].x - data[j].x) * (avgY - data[a].y));
+        if (area > maxArea)
+        {
+          maxArea = area;
+          chosen = j;
+        }
+      }
+
+      sampled.push_back(data[chosen]);
+      a = chosen;
+    }
+
+    sampled.push_back(data[n - 1]);
+    return sampled;
+  }
+
+  static vector<EnvelopeBucket> minMaxEnvelope(const vector<SeriesPoint> &data, size_t buckets)
+  {
+    vector<EnvelopeBucket> envelope;
+    if (data.empty() || buckets == 0)
+      return envelope;
+
+    if (data.size() <= buckets)
+    {
+      envelope.reserve(data.size());
+      for (const auto &p : data)
+        envelope.push_back({p.x, p.y, p.y});
+      return envelope;
+    }
+
+    const double minX = data.front().x;
+    const double span = max(data.back().x - minX, 1e-9);
+    const double width = span / buckets;
+
+    envelope.reserve(buckets);
+    size_t current = buckets; // no bucket open yet
+    for (const auto &p : data)
+    {
+      size_t b = min(static_cast<size_t>((p.x - minX) / width), buckets - 1);
+      if (b != current)
+      {
+        envelope.push_back({minX + (b + 0.5) * width, p.y, p.y});
+        current = b;
+      }
+      else
+      {
+        EnvelopeBucket &e = envelope.back();
+        e.low = min(e.low, p.y);
+        e.high = max(e.high, p.y);
+      }
+    }
+    return envelope;
+  }
+};
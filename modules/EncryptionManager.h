@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include "SessionKey.h"
 
 using namespace std;
 
@@ -51,6 +52,13 @@ using namespace std;
  * 3. If key is shorter than data, cycle through key (key[i % key.length()])
  * 4. Store encrypted bytes (may contain non-printable characters)
  * 5. To decrypt, XOR encrypted data with same key again
+ *
+ * SESSION KEYS:
+ * -------------
+ * The password overloads are kept for data written before session keys.
+ * Current data is encrypted with a SessionKey: its keystream is derived
+ * from the password once at login and cycled the same way, so each call
+ * is just the XOR pass - no key setup, no password copies.
  */
 class EncryptionManager
 {
@@ -101,6 +109,40 @@ public:
     return encrypt(encrypted, password);
   }
 
+  /**
+   * Encrypt plaintext using XOR with a session key's keystream
+   * @param plaintext The data to encrypt
+   * @param key The key derived at login
+   * @return Encrypted data as string (may contain binary characters)
+   */
+  static string encrypt(const string &plaintext, const SessionKey &key)
+  {
+    if (!key.isValid())
+    {
+      return plaintext; // No encryption without a key
+    }
+
+    const string &keystream = key.getKeystream();
+    string encrypted = plaintext;
+    for (size_t i = 0; i < encrypted.length(); i++)
+    {
+      encrypted[i] ^= keystream[i & (SessionKey::KEYSTREAM_BYTES - 1)];
+    }
+
+    return encrypted;
+  }
+
+  /**
+   * Decrypt encrypted data using XOR with a session key's keystream
+   * @param encrypted The encrypted data
+   * @param key The key derived at login
+   * @return Decrypted plaintext
+   */
+  static string decrypt(const string &encrypted, const SessionKey &key)
+  {
+    return encrypt(encrypted, key);
+  }
+
   /**
    * Convert encrypted binary data to base64-like hex string for safe storage
    * This is optional - we can store binary directly, but hex is more readable
@@ -3,6 +3,7 @@
 #include "Transaction.h"
 #include "User.h"
 #include "EncryptionManager.h"
+#include "LedgerHeader.h"
 #include <direct.h> // _mkdir
 #include <fstream>
 #include <io.h> // _access
@@ -17,32 +18,73 @@ using namespace std;
 class FileHandler
 {
 public:
-  // Folder + file paths
+  // Root data folder; each profile's files live in a folder under it
+  // (see ProfileStore), the first profile's in the root itself
   static inline const string DATA_DIR = "data";
-  static inline const string USER_FILE = "data/user.json";
-  static inline const string TRANSACTIONS_FILE = "data/transactions.json";
 
-  // Create /data directory if missing
+  // Folder + file paths of the active profile
+  static const string &getDataDirectory() { return dataDir; }
+  static void setDataDirectory(const string &dir) { dataDir = dir; }
+  static string userFile() { return dataDir + "/user.json"; }
+  static string transactionsFile() { return dataDir + "/transactions.json"; }
+  static string aiCacheFile() { return dataDir + "/ai_cache.json"; }
+  static string keyFile() { return dataDir + "/key.json"; }
+
+  // Create the data directory (and its parents) if missing
   static void ensureDataDirectory()
   {
-    if (_access(DATA_DIR.c_str(), 0) != 0)
+    ensureDirectory(dataDir);
+  }
+
+  static void ensureDirectory(const string &dir)
+  {
+    for (size_t end = dir.find('/'); ; end = dir.find('/', end + 1))
     {
-      _mkdir(DATA_DIR.c_str());
+      string part = dir.substr(0, end);
+      if (_access(part.c_str(), 0) != 0)
+      {
+        _mkdir(part.c_str());
+      }
+      if (end == string::npos)
+      {
+        break;
+      }
     }
   }
 
   // Check if user.json exists
   static bool userFileExists()
   {
-    ifstream file(USER_FILE);
+    ifstream file(userFile());
     return file.good();
   }
 
   // Read user from JSON file (with decryption)
+  // @param key The session key the file is encrypted with
+  static User readUserFromFile(const SessionKey &key)
+  {
+    string jsonContent;
+    if (!readSealedFile(userFile(), key, jsonContent))
+    {
+      return User(); // Missing, or not encrypted with this key
+    }
+
+    try
+    {
+      return User::fromJson(jsonContent);
+    }
+    catch (const exception &e)
+    {
+      cerr << "Error: Failed to decrypt user file. Wrong password?\n";
+      return User();
+    }
+  }
+
+  // Read a user file from before session keys (encrypted with the password itself)
   // @param password The password to decrypt the encrypted file
   static User readUserFromFile(const string &password)
   {
-    ifstream file(USER_FILE); // input from "data/user.json"
+    ifstream file(userFile()); // input from "data/user.json"
     if (!file.is_open())
     {
       cout << "check file open, if no return user obj";
@@ -72,58 +114,74 @@ public:
 
   // Write user to file (with encryption)
   // @param user The user object to save
-  // @param password The password to encrypt the file with
-  static void writeUserToFile(const User &user, const string &password)
+  // @param key The session key to encrypt the file with
+  static void writeUserToFile(const User &user, const SessionKey &key)
   {
-    ofstream file(USER_FILE);
-    if (!file.is_open())
+    if (!writeSealedFile(userFile(), user.toJson(), key))
     {
       cerr << "Error: Could not write to user file.\n";
-      return;
     }
-
-    // Get JSON string, encrypt it, then convert to hex for safe storage
-    string jsonContent = user.toJson();
-    string encrypted = EncryptionManager::encrypt(jsonContent, password);
-    string encryptedHex = EncryptionManager::toHex(encrypted);
-
-    // Write encrypted hex string to file
-    file << encryptedHex;
-    file.close();
   }
 
   // -------- Transaction File Operations --------
 
   // Read all transactions from file (with decryption)
-  // @param password The password to decrypt the encrypted file
-  static vector<Transaction> readTransactionsFromFile(const string &password)
+  // @param key The session key the file is encrypted with
+  static vector<Transaction> readTransactionsFromFile(const SessionKey &key)
   {
-    vector<Transaction> transactions;
-    ifstream file(TRANSACTIONS_FILE);
+    string headerLine;
+    string ciphertext;
+    if (!readTransactionCiphertext(headerLine, ciphertext))
+    {
+      return vector<Transaction>(); // Return empty vector if file doesn't exist
+    }
+    return decryptTransactions(ciphertext, key);
+  }
 
-    if (!file.is_open())
+  // Read the transaction file without decrypting it: its header line ("" if
+  // it has none) and its body decoded from hex. This is the disk-bound half
+  // of reading the ledger, which needs no key (see LedgerPrefetch.h).
+  // @return false if the file is missing or not encrypted with a session key
+  static bool readTransactionCiphertext(string &headerLine, string &ciphertext)
+  {
+    string stored;
+    if (!readFile(transactionsFile(), stored))
     {
-      return transactions; // Return empty vector if file doesn't exist
+      return false;
     }
 
-    stringstream buffer;
-    buffer << file.rdbuf();
-    string encryptedHex = buffer.str();
-    file.close();
+    headerLine.clear();
+    if (hasLedgerHeader(stored))
+    {
+      headerLine = stored.substr(0, stored.find('\n'));
+      stripLedgerHeader(stored);
+    }
+    if (!stored.empty() && !isSealed(stored))
+    {
+      cerr << "Error: " << transactionsFile() << " is not encrypted with the session key.\n";
+      return false;
+    }
+
+    stored.erase(0, SEALED_PREFIX.length());
+    ciphertext = EncryptionManager::fromHex(stored);
+    return true;
+  }
 
-    if (encryptedHex.empty())
+  // Decrypt and parse the body read by readTransactionCiphertext()
+  // @param ciphertext The encrypted body
+  // @param key The session key the file is encrypted with
+  static vector<Transaction> decryptTransactions(const string &ciphertext, const SessionKey &key)
+  {
+    vector<Transaction> transactions;
+    if (ciphertext.empty())
     {
       return transactions;
     }
 
     try
     {
-      // Decrypt the hex-encoded encrypted data
-      string encryptedBinary = EncryptionManager::fromHex(encryptedHex);
-      string jsonContent = EncryptionManager::decrypt(encryptedBinary, password);
-
       // Parse the decrypted JSON
-      json j = json::parse(jsonContent);
+      json j = json::parse(EncryptionManager::decrypt(ciphertext, key));
       if (j.contains("transactions") && j["transactions"].is_array())
       {
         for (const auto &item : j["transactions"])
@@ -142,18 +200,62 @@ public:
     return transactions;
   }
 
-  // Write all transactions to file (with encryption)
-  // @param transactions The transactions to save
-  // @param password The password to encrypt the file with
-  static void writeTransactionsToFile(const vector<Transaction> &transactions, const string &password)
+  // The first line of the transaction file if it is a header, otherwise ""
+  static string readLedgerHeaderLine()
   {
-    ofstream file(TRANSACTIONS_FILE);
-    if (!file.is_open())
+    ifstream file(transactionsFile(), ios::binary);
+    string line;
+    if (!file.is_open() || !getline(file, line) || !hasLedgerHeader(line))
     {
-      cerr << "Error: Could not write to transactions file.\n";
-      return;
+      return "";
+    }
+    return line;
+  }
+
+  // Read just the header line of the transaction file (see LedgerHeader.h)
+  // @param key The session key the file is encrypted with
+  // @param header Filled in; keyCheck is set even when it isn't this key's
+  // @return true if there is a header and it was written with this key
+  static bool readLedgerHeader(const SessionKey &key, LedgerHeader &header)
+  {
+    istringstream fields(readLedgerHeaderLine());
+    string magic;
+    string summary;
+    fields >> magic >> header.formatVersion >> header.keyCheck >> summary;
+    if (magic != LEDGER_MAGIC || !fields)
+    {
+      header.keyCheck.clear(); // No header (written before there was one)
+      return false;
+    }
+    if (header.formatVersion > LedgerHeader::FORMAT_VERSION || !key.matches(header.keyCheck))
+    {
+      return false;
     }
 
+    string summaryJson;
+    try
+    {
+      if (!unseal(transactionsFile(), summary, key, summaryJson))
+      {
+        return false;
+      }
+      header.summaryFromJson(json::parse(summaryJson));
+      return true;
+    }
+    catch (const exception &e)
+    {
+      cerr << "Error reading transactions file header: " << e.what() << "\n";
+      return false;
+    }
+  }
+
+  // Write all transactions to file (with encryption), after their header
+  // @param transactions The transactions to save
+  // @param header Their summary (keyCheck is filled in from the key)
+  // @param key The session key to encrypt the file with
+  static void writeTransactionsToFile(const vector<Transaction> &transactions,
+                                      const LedgerHeader &header, const SessionKey &key)
+  {
     // Build JSON structure
     // input : transactions<vector>
     // {"transactions" = []}
@@ -165,13 +267,201 @@ public:
       j["transactions"].push_back(transaction.toJson());
     }
 
-    // Encrypt the JSON string, then convert to hex for safe storage
-    string jsonContent = j.dump(4); // Pretty-printed JSON
-    string encrypted = EncryptionManager::encrypt(jsonContent, password);
-    string encryptedHex = EncryptionManager::toHex(encrypted);
+    string headerLine = LEDGER_MAGIC + " " + to_string(LedgerHeader::FORMAT_VERSION) + " " +
+                        key.getCheckValue() + " " + seal(header.summaryToJson().dump(), key) +
+                        "\n";
+    if (!writeSealedFile(transactionsFile(), j.dump(4), key, headerLine)) // Pretty-printed JSON
+    {
+      cerr << "Error: Could not write to transactions file.\n";
+    }
+  }
+
+  // -------- AI Response Cache File Operations --------
 
-    // Write encrypted hex string to file
-    file << encryptedHex;
-    file.close();
+  // Read the saved AI reply cache entries (with decryption)
+  // @param key The session key the file is encrypted with
+  // @return The entries, or an empty array if there are none or they don't decrypt
+  static json readAiCacheFromFile(const SessionKey &key)
+  {
+    string jsonContent;
+    if (!readSealedFile(aiCacheFile(), key, jsonContent))
+    {
+      return json::array();
+    }
+
+    try
+    {
+      json entries = json::parse(jsonContent);
+      return entries.is_array() ? entries : json::array();
+    }
+    catch (const exception &)
+    {
+      // Unreadable cache: start over with an empty one
+      return json::array();
+    }
+  }
+
+  // Write the AI reply cache entries to file (with encryption)
+  // @param entries The cache entries to save
+  // @param key The session key to encrypt the file with
+  // @param path The cache file it was read from (profiles may switch meanwhile)
+  static void writeAiCacheToFile(const json &entries, const SessionKey &key, const string &path)
+  {
+    // The cache is optional: if it can't be written it stays in memory only
+    writeSealedFile(path, entries.dump(), key);
+  }
+
+  // -------- Session Key File Operations --------
+
+  // Read the stored key derivation parameters
+  // @return false if there are none (first run, or data from before session keys)
+  static bool readKeyParams(SessionKey::Params &params)
+  {
+    ifstream file(keyFile());
+    if (!file.is_open())
+    {
+      return false;
+    }
+
+    try
+    {
+      json j = json::parse(file);
+      params.salt = j.at("salt").get<string>();
+      params.iterations = j.at("iterations").get<int>();
+      params.check = j.at("check").get<string>();
+      return params.iterations > 0;
+    }
+    catch (const exception &e)
+    {
+      cerr << "Error reading key file: " << e.what() << "\n";
+      return false;
+    }
+  }
+
+  // Write the key derivation parameters (not secret, stored as plain JSON)
+  static void writeKeyParams(const SessionKey::Params &params)
+  {
+    ofstream file(keyFile());
+    if (!file.is_open())
+    {
+      cerr << "Error: Could not write to key file.\n";
+      return;
+    }
+
+    json j;
+    j["kdf"] = "pbkdf2-hmac-sha256";
+    j["salt"] = params.salt;
+    j["iterations"] = params.iterations;
+    j["check"] = params.check;
+    file << j.dump(4);
+  }
+
+  // Re-encrypt a file still encrypted with the password itself under the
+  // session key. Files already under a session key are left alone.
+  // @param path The file to migrate
+  // @param password The password the file was encrypted with
+  // @param key The session key to encrypt it with now
+  static void migrateToSessionKey(const string &path, const string &password, const SessionKey &key)
+  {
+    string stored;
+    if (!readFile(path, stored) || stored.empty() || isSealed(stored) || hasLedgerHeader(stored))
+    {
+      return;
+    }
+
+    string plaintext = EncryptionManager::decrypt(EncryptionManager::fromHex(stored), password);
+    writeSealedFile(path, plaintext, key);
+  }
+
+private:
+  // Marks files encrypted with a session key ('K' is not a hex digit, so
+  // files from before session keys never start with it)
+  static inline const string SEALED_PREFIX = "K1:";
+
+  static inline string dataDir = DATA_DIR;
+
+  // Starts the header line of the transaction file
+  static inline const string LEDGER_MAGIC = "LEDGER";
+
+  static bool isSealed(const string &stored)
+  {
+    return stored.compare(0, SEALED_PREFIX.length(), SEALED_PREFIX) == 0;
+  }
+
+  static bool hasLedgerHeader(const string &stored)
+  {
+    return stored.compare(0, LEDGER_MAGIC.length() + 1, LEDGER_MAGIC + " ") == 0;
+  }
+
+  // Drop the header line, leaving the body
+  static void stripLedgerHeader(string &stored)
+  {
+    if (hasLedgerHeader(stored))
+    {
+      size_t end = stored.find('\n');
+      stored.erase(0, end == string::npos ? stored.length() : end + 1);
+    }
+  }
+
+  static bool readFile(const string &path, string &contents)
+  {
+    ifstream file(path, ios::binary);
+    if (!file.is_open())
+    {
+      return false;
+    }
+
+    stringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+  }
+
+  // Encrypt with the session key, then convert to hex for safe storage
+  static string seal(const string &plaintext, const SessionKey &key)
+  {
+    return SEALED_PREFIX + EncryptionManager::toHex(EncryptionManager::encrypt(plaintext, key));
+  }
+
+  // Decrypt what seal() produced
+  // @return false if it was not encrypted with a session key
+  static bool unseal(const string &path, const string &stored, const SessionKey &key, string &plaintext)
+  {
+    if (stored.empty())
+    {
+      plaintext.clear();
+      return true;
+    }
+    if (!isSealed(stored))
+    {
+      cerr << "Error: " << path << " is not encrypted with the session key.\n";
+      return false;
+    }
+
+    plaintext = EncryptionManager::decrypt(
+        EncryptionManager::fromHex(stored.substr(SEALED_PREFIX.length())), key);
+    return true;
+  }
+
+  // Decrypt a file written by writeSealedFile()
+  // @return false if it is missing or not encrypted with a session key
+  static bool readSealedFile(const string &path, const SessionKey &key, string &plaintext)
+  {
+    string stored;
+    return readFile(path, stored) && unseal(path, stored, key, plaintext);
+  }
+
+  // Write plaintext sealed with the session key, after an optional header
+  static bool writeSealedFile(const string &path, const string &plaintext, const SessionKey &key,
+                              const string &header = "")
+  {
+    ofstream file(path, ios::binary);
+    if (!file.is_open())
+    {
+      return false;
+    }
+
+    file << header << seal(plaintext, key);
+    return file.good();
   }
 };
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Categorizer.h"
+#include "LedgerIndex.h"
+#include "TokenEstimator.h"
+#include "Transaction.h"
+
+/**
+ * FinancialContextBuilder - compact ledger summary for the AI prompt
+ *
+ * HOW IT WORKS:
+ * =============
+ * Instead of serializing every transaction, one pass over the index
+ * columns (amount, type, date key, folded description, category bitmaps)
+ * collects per-month totals with a category split, category totals, the
+ * merchants with the most spend and per-category mean / deviation. A
+ * second pass over the expenses flags the ones far above their category's
+ * typical amount. The newest rows are listed as is.
+ *
+ * Sections are emitted in priority order (overview, categories, months,
+ * recent rows, merchants, anomalies), line by line, until the token
+ * budget runs out, so the prompt size depends on the budget and not on
+ * the ledger size. Tokens are estimated locally with TokenEstimator.
+ */
+class FinancialContextBuilder {
+public:
+  static constexpr size_t DEFAULT_TOKEN_BUDGET = 1200;
+  static constexpr size_t MAX_MONTHS = 12;
+  static constexpr size_t MAX_MERCHANTS = 8;
+  static constexpr size_t MAX_ANOMALIES = 5;
+  static constexpr size_t MAX_RECENT = 15;
+
+  // Summary of the ledger in at most about tokenBudget tokens
+  static std::string build(const std::vector<Transaction> &ledger, const LedgerIndex &index,
+                           size_t tokenBudget = DEFAULT_TOKEN_BUDGET) {
+    Stats stats = collect(index);
+    Writer out(tokenBudget);
+
+    // Overview
+    out.section("Ledger summary (amounts in $)");
+    std::string overview = std::to_string(index.size()) + " transactions";
+    if (stats.firstDate != 0) {
+      overview += ", " + formatDate(stats.firstDate) + " to " + formatDate(stats.lastDate);
+    }
+    out.line(overview);
+    out.line("Income " + money(index.getTotalIncome()) + ", expenses " +
+             money(index.getTotalExpenses()) + ", net " +
+             money(index.getTotalIncome() - index.getTotalExpenses()));
+
+    // Expenses by category, largest first
+    std::vector<size_t> order = largestFirst(stats.categoryTotals);
+    out.section("Expenses by category");
+    for (size_t category : order) {
+      double total = stats.categoryTotals[category];
+      if (total <= 0) break;
+      int percent = static_cast<int>(std::lround(100.0 * total / index.getTotalExpenses()));
+      out.line(categoryName(category) + " " + money(total) + " (" + std::to_string(percent) +
+               "%, " + std::to_string(stats.categoryCounts[category]) + " rows)");
+    }
+
+    // Months, newest first, with their three largest categories
+    out.section("Monthly income / expenses (newest first)");
+    size_t months = 0;
+    for (auto it = stats.months.rbegin(); it != stats.months.rend() && months < MAX_MONTHS;
+         ++it, months++) {
+      const MonthStats &month = it->second;
+      std::string text = formatMonth(it->first) + ": +" + money(month.income) + " -" +
+                         money(month.expenses);
+      std::vector<size_t> top = largestFirst(month.byCategory);
+      for (size_t i = 0; i < top.size() && i < 3 && month.byCategory[top[i]] > 0; i++) {
+        text += (i == 0 ? " | " : ", ") + categoryName(top[i]) + " " + money(month.byCategory[top[i]]);
+      }
+      if (!out.line(text)) break;
+    }
+
+    // Newest rows
+    out.section("Recent transactions (newest first)");
+    for (size_t i = 0; i < MAX_RECENT && i < ledger.size(); i++) {
+      const Transaction &t = ledger[ledger.size() - 1 - i];
+      if (!out.line(t.getDate() + " " + (t.getType() == "income" ? "+" : "-") +
+                    money(t.getAmount()) + " " + t.getDescription())) {
+        break;
+      }
+    }
+
+    // Merchants by spend
+    out.section("Top merchants by spend");
+    for (const auto &merchant : topMerchants(stats)) {
+      if (!out.line(std::string(merchant.first) + " " + money(merchant.second.total) + " (" +
+                    std::to_string(merchant.second.count) + "x)")) {
+        break;
+      }
+    }
+
+    // Unusually large expenses
+    std::vector<Anomaly> anomalies = findAnomalies(index, stats);
+    out.section("Unusually large expenses");
+    for (const Anomaly &anomaly : anomalies) {
+      const Transaction &t = ledger[anomaly.row];
+      if (!out.line(t.getDate() + " " + money(t.getAmount()) + " " + t.getDescription() + " (" +
+                    categoryName(stats.categoryOf[anomaly.row]) + ", typical " +
+                    money(stats.categoryMeans[stats.categoryOf[anomaly.row]]) + ")")) {
+        break;
+      }
+    }
+
+    return out.take();
+  }
+
+private:
+  struct MonthStats {
+    double income = 0.0;
+    double expenses = 0.0;
+    std::vector<double> byCategory;
+  };
+
+  struct MerchantStats {
+    double total = 0.0;
+    size_t count = 0;
+  };
+
+  struct Anomaly {
+    uint32_t row;
+    double score; // standard deviations above the category mean
+  };
+
+  struct Stats {
+    std::vector<uint8_t> categoryOf; // category id by row
+    std::vector<double> categoryTotals;
+    std::vector<size_t> categoryCounts;
+    std::vector<double> categoryMeans;
+    std::vector<double> categorySquares; // sum of squared deviations (Welford)
+    std::map<int, MonthStats> months;    // by yyyymm
+    std::unordered_map<std::string_view, MerchantStats> merchants; // by folded description
+    int firstDate = 0;
+    int lastDate = 0;
+  };
+
+  // Appends lines while they fit the budget; a section title is only
+  // written together with its first line
+  class Writer {
+  public:
+    explicit Writer(size_t budget) : budget(budget) {}
+
+    void section(const std::string &title) { pendingTitle = title + ":"; }
+
+    bool line(const std::string &text) {
+      size_t cost = TokenEstimator::estimate(text) + 1;
+      if (!pendingTitle.empty()) cost += TokenEstimator::estimate(pendingTitle) + 1;
+      if (used + cost > budget) return false;
+      if (!pendingTitle.empty()) {
+        if (!result.empty()) result += '\n'; // blank line between sections
+        result += pendingTitle + '\n';
+        pendingTitle.clear();
+      }
+      result += text + '\n';
+      used += cost;
+      return true;
+    }
+
+    std::string take() { return std::move(result); }
+
+  private:
+    size_t budget;
+    size_t used = 0;
+    std::string pendingTitle;
+    std::string result;
+  };
+
+  static Stats collect(const LedgerIndex &index) {
+    const auto &names = Categorizer::getCategoryNames();
+    size_t categories = names.size();
+    Stats stats;
+    stats.categoryOf.assign(index.size(), static_cast<uint8_t>(Categorizer::getOtherId()));
+    for (size_t category = 0; category < categories; category++) {
+      index.byCategory(names[category]).forEach(
+          [&](uint32_t row) { stats.categoryOf[row] = static_cast<uint8_t>(category); });
+    }
+    stats.categoryTotals.assign(categories, 0.0);
+    stats.categoryCounts.assign(categories, 0);
+    stats.categoryMeans.assign(categories, 0.0);
+    stats.categorySquares.assign(categories, 0.0);
+
+    for (uint32_t row = 0; row < index.size(); row++) {
+      LedgerIndex::TypeCode type = index.typeAt(row);
+      if (type == LedgerIndex::TYPE_OTHER) continue;
+      double amount = index.amountAt(row);
+      int dateKey = index.dateKeyAt(row);
+
+      if (dateKey != 0) {
+        if (stats.firstDate == 0 || dateKey < stats.firstDate) stats.firstDate = dateKey;
+        if (dateKey > stats.lastDate) stats.lastDate = dateKey;
+        MonthStats &month = stats.months[dateKey / 100];
+        if (month.byCategory.empty()) month.byCategory.assign(categories, 0.0);
+        if (type == LedgerIndex::TYPE_INCOME) {
+          month.income += amount;
+        } else {
+          month.expenses += amount;
+          month.byCategory[stats.categoryOf[row]] += amount;
+        }
+      }
+      if (type != LedgerIndex::TYPE_EXPENSE) continue;
+
+      size_t category = stats.categoryOf[row];
+      size_t count = ++stats.categoryCounts[category];
+      double delta = amount - stats.categoryMeans[category];
+      stats.categoryMeans[category] += delta / count;
+      stats.categorySquares[category] += delta * (amount - stats.categoryMeans[category]);
+      stats.categoryTotals[category] += amount;
+
+      MerchantStats &merchant = stats.merchants[trim(index.foldedDescription(row))];
+      merchant.total += amount;
+      merchant.count++;
+    }
+    return stats;
+  }
+
+  // Expenses at least 3 standard deviations above their category mean,
+  // most unusual first (categories with too few rows are skipped)
+  static std::vector<Anomaly> findAnomalies(const LedgerIndex &index, const Stats &stats) {
+    std::vector<double> deviations(stats.categoryCounts.size(), 0.0);
+    for (size_t category = 0; category < deviations.size(); category++) {
+      if (stats.categoryCounts[category] >= 8) {
+        deviations[category] =
+            std::sqrt(stats.categorySquares[category] / (stats.categoryCounts[category] - 1));
+      }
+    }
+
+    std::vector<Anomaly> anomalies;
+    index.byType("expense").forEach([&](uint32_t row) {
+      double deviation = deviations[stats.categoryOf[row]];
+      if (deviation <= 0) return;
+      double score = (index.amountAt(row) - stats.categoryMeans[stats.categoryOf[row]]) / deviation;
+      if (score >= 3.0) anomalies.push_back({row, score});
+    });
+
+    size_t keep = std::min(anomalies.size(), MAX_ANOMALIES);
+    std::partial_sort(anomalies.begin(), anomalies.begin() + keep, anomalies.end(),
+                      [](const Anomaly &a, const Anomaly &b) { return a.score > b.score; });
+    anomalies.resize(keep);
+    return anomalies;
+  }
+
+  static std::vector<std::pair<std::string_view, MerchantStats>> topMerchants(const Stats &stats) {
+    std::vector<std::pair<std::string_view, MerchantStats>> merchants(stats.merchants.begin(),
+                                                                      stats.merchants.end());
+    size_t keep = std::min(merchants.size(), MAX_MERCHANTS);
+    std::partial_sort(merchants.begin(), merchants.begin() + keep, merchants.end(),
+                      [](const auto &a, const auto &b) { return a.second.total > b.second.total; });
+    merchants.resize(keep);
+    return merchants;
+  }
+
+  // Indexes of values, largest value first
+  static std::vector<size_t> largestFirst(const std::vector<double> &values) {
+    std::vector<size_t> order(values.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return values[a] > values[b]; });
+    return order;
+  }
+
+  static std::string_view trim(std::string_view text) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+    return text;
+  }
+
+  static const std::string &categoryName(size_t category) {
+    return Categorizer::getCategoryNames()[category];
+  }
+
+  static std::string money(double amount) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.2f", amount);
+    return text;
+  }
+
+  static std::string formatDate(int dateKey) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%04d-%02d-%02d", dateKey / 10000, (dateKey / 100) % 100,
+                  dateKey % 100);
+    return text;
+  }
+
+  static std::string formatMonth(int monthKey) {
+    char text[16];
+    std::snprintf(text, sizeof(text), "%04d-%02d", monthKey / 100, monthKey % 100);
+    return text;
+  }
+};
@@ -0,0 +1,183 @@
+#pragma once
+#include "LedgerIndex.h"
+#include "Transaction.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// One fuzzy hit: ledger row and its edit distance to the query
+struct FuzzyMatch
+{
+  uint32_t row;
+  int distance;
+};
+
+/**
+ * FuzzySearch - typo-tolerant description search
+ *
+ * HOW IT WORKS:
+ * =============
+ * 1. Q-gram filter: a text that matches the query with at most k edits
+ *    still shares at least (distinct query bigrams - 2k) bigrams with it,
+ *    because one edit can destroy at most 2 bigrams. Counting shared bigrams
+ *    through the LedgerIndex bigram bitmaps discards most rows cheaply.
+ * 2. Myers' bit-parallel algorithm: for the surviving rows, the best edit
+ *    distance between the query and any substring of the case-folded
+ *    description is computed with one 64-bit word per text character,
+ *    instead of a full m x n dynamic programming table.
+ * 3. Hits within the distance limit are ranked by distance, newest first.
+ */
+class FuzzySearch
+{
+public:
+  static constexpr size_t MAX_PATTERN = 64; // one machine word
+
+  // Precomputed match masks for a query, matched against folded text
+  struct Pattern
+  {
+    uint64_t peq[256] = {};
+    int length = 0;
+  };
+
+  static Pattern compile(const string &query)
+  {
+    Pattern p;
+    p.length = static_cast<int>(min(query.size(), MAX_PATTERN));
+    for (int i = 0; i < p.length; i++)
+    {
+      p.peq[LedgerIndex::foldCase(query[i])] |= 1ULL << i;
+    }
+    return p;
+  }
+
+  // Smallest edit distance between the pattern and any substring of text.
+  // Scanning stops early once no later position can beat min(best, cutoff).
+  static int bestDistance(const Pattern &p, string_view text,
+                          int cutoff = MAX_PATTERN)
+  {
+    if (p.length == 0)
+      return 0;
+
+    uint64_t pv = ~0ULL;
+    uint64_t mv = 0;
+    uint64_t last = 1ULL << (p.length - 1);
+    int score = p.length;
+    int best = score;
+    int remaining = static_cast<int>(text.size());
+
+    for (unsigned char c : text)
+    {
+      // The score drops by at most one per character
+      if (best == 0 || score - remaining > min(best, cutoff))
+        break;
+      remaining--;
+
+      uint64_t eq = p.peq[c];
+      uint64_t xv = eq | mv;
+      uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+      uint64_t ph = mv | ~(xh | pv);
+      uint64_t mh = pv & xh;
+
+      if (ph & last)
+        score++;
+      else if (mh & last)
+        score--;
+
+      // Row 0 is all zeros when searching, so nothing is shifted in
+      ph <<= 1;
+      mh <<= 1;
+      pv = mh | ~(xv | ph);
+      mv = ph & xv;
+
+      if (score < best)
+        best = score;
+    }
+    return best;
+  }
+
+  // Default typo allowance for a query length
+  static int defaultMaxDistance(size_t queryLength)
+  {
+    if (queryLength <= 6)
+      return 1;
+    if (queryLength <= 10)
+      return 2;
+    return 3;
+  }
+
+  // Rows whose description is within maxDistance edits of the query,
+  // closest first (ties: most recent first), at most limit hits
+  static vector<FuzzyMatch> search(const vector<Transaction> &ledger,
+                                   const LedgerIndex &index,
+                                   const string &query, int maxDistance,
+                                   size_t limit = 200)
+  {
+    vector<FuzzyMatch> matches;
+    if (query.empty() || ledger.empty())
+      return matches;
+
+    string pattern = query.substr(0, MAX_PATTERN);
+    Pattern compiled = compile(pattern);
+
+    // Distinct query bigrams
+    vector<pair<char, char>> bigrams;
+    for (size_t i = 0; i + 1 < pattern.size(); i++)
+    {
+      pair<char, char> g(static_cast<char>(LedgerIndex::foldCase(pattern[i])),
+                         static_cast<char>(LedgerIndex::foldCase(pattern[i + 1])));
+      if (find(bigrams.begin(), bigrams.end(), g) == bigrams.end())
+        bigrams.push_back(g);
+    }
+
+    int threshold = static_cast<int>(bigrams.size()) - 2 * maxDistance;
+
+    auto consider = [&](uint32_t row) {
+      int distance = bestDistance(compiled, index.foldedDescription(row), maxDistance);
+      if (distance <= maxDistance)
+        matches.push_back({row, distance});
+    };
+
+    if (threshold <= 0)
+    {
+      // Query too short for the filter to prune anything
+      for (size_t row = 0; row < ledger.size(); row++)
+        consider(static_cast<uint32_t>(row));
+    }
+    else
+    {
+      vector<uint8_t> shared(ledger.size(), 0);
+      for (const auto &g : bigrams)
+      {
+        index.byBigram(g.first, g.second).forEach([&](uint32_t row) {
+          if (row < shared.size())
+            shared[row]++;
+        });
+      }
+      for (size_t row = 0; row < shared.size(); row++)
+      {
+        if (shared[row] >= threshold)
+          consider(static_cast<uint32_t>(row));
+      }
+    }
+
+    auto closer = [](const FuzzyMatch &a, const FuzzyMatch &b) {
+      if (a.distance != b.distance)
+        return a.distance < b.distance;
+      return a.row > b.row;
+    };
+    if (matches.size() > limit)
+    {
+      partial_sort(matches.begin(), matches.begin() + limit, matches.end(), closer);
+      matches.resize(limit);
+    }
+    else
+    {
+      sort(matches.begin(), matches.end(), closer);
+    }
+    return matches;
+  }
+};
@@ -0,0 +1,881 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <winhttp.h>
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+using HttpHeaders = std::vector<std::pair<std::string, std::string>>;
+
+// Receives body bytes as they arrive; returning false stops the transfer
+using HttpBodyCallback = std::function<bool(const char *data, size_t size)>;
+
+// Parts of an http:// or https:// URL
+struct HttpUrl {
+  bool secure = false;
+  std::string host;
+  int port = 80;
+  std::string path = "/";
+
+  static bool parse(const std::string &url, HttpUrl &out) {
+    size_t hostStart = 0;
+    if (url.compare(0, 7, "http://") == 0) {
+      out.secure = false;
+      out.port = 80;
+      hostStart = 7;
+    } else if (url.compare(0, 8, "https://") == 0) {
+      out.secure = true;
+      out.port = 443;
+      hostStart = 8;
+    } else {
+      return false;
+    }
+
+    size_t pathStart = url.find('/', hostStart);
+    std::string authority = url.substr(
+        hostStart, pathStart == std::string::npos ? std::string::npos : pathStart - hostStart);
+    out.path = pathStart == std::string::npos ? "/" : url.substr(pathStart);
+
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+      out.port = std::atoi(authority.c_str() + colon + 1);
+      authority.erase(colon);
+    }
+    out.host = authority;
+    return !out.host.empty() && out.port > 0 && out.port < 65536;
+  }
+};
+
+struct HttpResponse {
+  int status = 0;
+  std::string body;
+  std::string error;             // transport failure; empty when a response arrived
+  bool transient = false;        // the failure may pass (connect, reset, stall), not a setup error
+  bool reusedConnection = false; // sent over a kept-alive connection
+  bool cancelled = false;        // stopped by the body callback or a cancel token
+  bool timedOut = false;         // the request's time limit ran out
+  int attempts = 1;              // requests sent for this call (retries and hedges too)
+};
+
+/**
+ * HttpCancelToken - lets another thread abandon a request in flight
+ *
+ * While a request runs, the transport registers how to break its blocking
+ * call (shut the socket down, close the WinHTTP handle). cancel() sets the
+ * flag and runs that action, so even a read waiting on a silent server
+ * returns at once.
+ */
+class HttpCancelToken {
+public:
+  void cancel() {
+    std::lock_guard<std::mutex> lock(mutex);
+    cancelled = true;
+    if (abortAction) abortAction();
+  }
+
+  bool isCancelled() const { return cancelled; }
+
+  // Registered for the duration of a blocking call (null to clear);
+  // runs at once if the token was already cancelled
+  void setAbortAction(std::function<void()> action) {
+    std::lock_guard<std::mutex> lock(mutex);
+    abortAction = std::move(action);
+    if (cancelled && abortAction) abortAction();
+  }
+
+private:
+  std::mutex mutex; // guards abortAction
+  std::atomic<bool> cancelled{false};
+  std::function<void()> abortAction;
+};
+
+struct HttpRequestOptions {
+  HttpBodyCallback onBody;           // stream the body here instead of HttpResponse::body
+  HttpCancelToken *cancel = nullptr; // lets another thread abandon the request
+  int timeoutMs = 0;                 // limit for the whole request; 0 = transport default
+  int connectTimeoutMs = 0;          // limit for connecting; 0 = timeoutMs
+  int readTimeoutMs = 0;             // longest silence from the server; 0 = timeoutMs
+
+  // Called with the status code before any of the body arrives. Returning
+  // false reads the body into HttpResponse::body instead of onBody.
+  std::function<bool(int status)> onStatus;
+};
+
+// Case-insensitive header lookup ("" when missing)
+inline std::string findHeader(const HttpHeaders &headers, const std::string &name) {
+  for (const auto &header : headers) {
+    if (header.first.size() == name.size() &&
+        std::equal(name.begin(), name.end(), header.first.begin(),
+                   [](char a, char b) { return std::tolower(a) == std::tolower(b); })) {
+      return header.second;
+    }
+  }
+  return "";
+}
+
+/**
+ * TcpConnection - owned, blocking TCP socket (Winsock or BSD sockets)
+ */
+class TcpConnection {
+public:
+#ifdef _WIN32
+  using Handle = SOCKET;
+  static constexpr Handle INVALID = INVALID_SOCKET;
+#else
+  using Handle = int;
+  static constexpr Handle INVALID = -1;
+#endif
+
+  TcpConnection() = default;
+  explicit TcpConnection(Handle handle) : handle(handle) {}
+  ~TcpConnection() { close(); }
+
+  TcpConnection(const TcpConnection &) = delete;
+  TcpConnection &operator=(const TcpConnection &) = delete;
+  TcpConnection(TcpConnection &&other) noexcept : handle(other.handle) { other.handle = INVALID; }
+  TcpConnection &operator=(TcpConnection &&other) noexcept {
+    if (this != &other) {
+      close();
+      handle = other.handle;
+      other.handle = INVALID;
+    }
+    return *this;
+  }
+
+  bool isOpen() const { return handle != INVALID; }
+  Handle getHandle() const { return handle; }
+
+  // Connect within timeoutMs, which then becomes the send and receive timeout
+  bool connect(const std::string &host, int port, int timeoutMs) {
+    close();
+    startup();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+      return false;
+    }
+    for (addrinfo *a = addresses; a && !isOpen(); a = a->ai_next) {
+      Handle h = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+      if (h == INVALID) continue;
+      if (connectWithin(h, a->ai_addr, static_cast<int>(a->ai_addrlen), timeoutMs)) {
+        handle = h;
+      } else {
+        closeHandle(h);
+      }
+    }
+    freeaddrinfo(addresses);
+    if (!isOpen()) return false;
+
+    // Requests are written in one piece: don't wait for more to coalesce
+    int noDelay = 1;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&noDelay),
+               sizeof(noDelay));
+    setTimeout(timeoutMs);
+    return true;
+  }
+
+  // Send and receive timeout; a timed-out call fails like a dropped connection
+  void setTimeout(int timeoutMs) {
+#ifdef _WIN32
+    DWORD value = static_cast<DWORD>(timeoutMs);
+#else
+    timeval value{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+#endif
+    setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>(&value),
+               sizeof(value));
+    setsockopt(handle, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char *>(&value),
+               sizeof(value));
+  }
+
+  bool sendAll(const std::string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+      int chunk = static_cast<int>(std::min<size_t>(data.size() - sent, 1 << 20));
+      int n = ::send(handle, data.data() + sent, chunk, SEND_FLAGS);
+      if (n <= 0) return false;
+      sent += static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+  // Bytes read; 0 once the peer closed, negative on error or timeout
+  int receive(char *buffer, int size) { return ::recv(handle, buffer, size, 0); }
+
+  // Wake up a thread blocked on this socket
+  void shutdownBoth() {
+#ifdef _WIN32
+    if (isOpen()) ::shutdown(handle, SD_BOTH);
+#else
+    if (isOpen()) ::shutdown(handle, SHUT_RDWR);
+#endif
+  }
+
+  void close() {
+    if (isOpen()) closeHandle(handle);
+    handle = INVALID;
+  }
+
+  // Winsock needs one WSAStartup per process
+  static void startup() {
+#ifdef _WIN32
+    static const bool started = [] {
+      WSADATA data;
+      return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    (void)started;
+#endif
+  }
+
+  static void closeHandle(Handle h) {
+#ifdef _WIN32
+    closesocket(h);
+#else
+    ::close(h);
+#endif
+  }
+
+private:
+  // Non-blocking connect, waiting at most timeoutMs for it to complete
+  static bool connectWithin(Handle h, const sockaddr *address, int length, int timeoutMs) {
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(h, FIONBIO, &nonBlocking);
+    bool connected = ::connect(h, address, length) == 0;
+    bool pending = !connected && WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    int flags = fcntl(h, F_GETFL, 0);
+    fcntl(h, F_SETFL, flags | O_NONBLOCK);
+    bool connected = ::connect(h, address, static_cast<socklen_t>(length)) == 0;
+    bool pending = !connected && errno == EINPROGRESS;
+#endif
+    if (pending) {
+      fd_set writable, failed;
+      FD_ZERO(&writable);
+      FD_ZERO(&failed);
+      FD_SET(h, &writable);
+      FD_SET(h, &failed);
+      timeval wait{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+      if (select(static_cast<int>(h + 1), nullptr, &writable, &failed, &wait) > 0 &&
+          FD_ISSET(h, &writable)) {
+        int error = 0;
+        socklen_t size = sizeof(error);
+        getsockopt(h, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&error), &size);
+        connected = error == 0;
+      }
+    }
+#ifdef _WIN32
+    u_long blocking = 0;
+    ioctlsocket(h, FIONBIO, &blocking);
+#else
+    fcntl(h, F_SETFL, flags);
+#endif
+    return connected;
+  }
+
+#ifdef MSG_NOSIGNAL
+  static constexpr int SEND_FLAGS = MSG_NOSIGNAL; // a closed peer is an error, not SIGPIPE
+#else
+  static constexpr int SEND_FLAGS = 0;
+#endif
+
+  Handle handle = INVALID;
+};
+
+/**
+ * HttpReader - buffered reader for HTTP/1.1 messages on a TcpConnection
+ *
+ * Reads the start line and headers, then the body framed by
+ * Content-Length, chunked transfer encoding, or the end of the stream.
+ */
+class HttpReader {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit HttpReader(TcpConnection &connection) : connection(connection) {}
+
+  // Fail reads once this time has passed (each wait is cut to what's left)
+  void setDeadline(Clock::time_point time) {
+    deadline = time;
+    hasDeadline = true;
+  }
+
+  // Fail a read once the server has sent nothing for this long (0: no limit)
+  void setIdleTimeout(int timeoutMs) { idleTimeoutMs = timeoutMs; }
+
+  // A read failed because the deadline passed
+  bool hasExpired() const { return expired; }
+
+  // A read failed because the server went quiet for the idle timeout
+  bool hasStalled() const { return stalled; }
+
+  // Bytes received so far (0 means the peer never answered)
+  size_t getBytesReceived() const { return received; }
+
+  bool readLine(std::string &line) {
+    while (true) {
+      size_t end = buffer.find("\r\n", pos);
+      if (end != std::string::npos) {
+        line.assign(buffer, pos, end - pos);
+        pos = end + 2;
+        return true;
+      }
+      if (!fill()) return false;
+    }
+  }
+
+  // Start line plus headers, up to the blank line
+  bool readHead(std::string &startLine, HttpHeaders &headers) {
+    headers.clear();
+    if (!readLine(startLine)) return false;
+    std::string line;
+    while (readLine(line)) {
+      if (line.empty()) return true;
+      size_t colon = line.find(':');
+      if (colon == std::string::npos) continue;
+      size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+      headers.push_back({line.substr(0, colon),
+                         valueStart == std::string::npos ? "" : line.substr(valueStart)});
+    }
+    return false;
+  }
+
+  // Body of a message with these headers, handed to the sink as it
+  // arrives. Without a length or chunking the body runs to the end of the
+  // stream, which only responses may do. False if the stream broke or the
+  // sink stopped it.
+  bool readBody(const HttpHeaders &headers, const HttpBodyCallback &sink, bool isResponse) {
+    std::string encoding = findHeader(headers, "Transfer-Encoding");
+    std::transform(encoding.begin(), encoding.end(), encoding.begin(), ::tolower);
+    if (encoding.find("chunked") != std::string::npos) {
+      std::string line;
+      while (readLine(line)) {
+        size_t size = std::strtoul(line.c_str(), nullptr, 16);
+        if (size == 0) {
+          // Skip trailers
+          while (readLine(line) && !line.empty()) {
+          }
+          return true;
+        }
+        if (!forward(size, sink) || !readLine(line)) return false;
+      }
+      return false;
+    }
+
+    std::string length = findHeader(headers, "Content-Length");
+    if (!length.empty()) return forward(std::strtoul(length.c_str(), nullptr, 10), sink);
+    if (!isResponse) return true;
+
+    while (true) {
+      if (pos < buffer.size()) {
+        size_t available = buffer.size() - pos;
+        pos = buffer.size();
+        if (!sink(buffer.data() + pos - available, available)) return stop();
+      }
+      if (!fill()) return true;
+    }
+  }
+
+  bool readBody(const HttpHeaders &headers, std::string &body, bool isResponse) {
+    return readBody(
+        headers,
+        [&body](const char *data, size_t size) {
+          body.append(data, size);
+          return true;
+        },
+        isResponse);
+  }
+
+  // The sink asked to stop before the body ended
+  bool wasStopped() const { return stopped; }
+
+private:
+  // Pass the next count bytes to the sink as they arrive
+  bool forward(size_t count, const HttpBodyCallback &sink) {
+    while (count > 0) {
+      if (pos == buffer.size() && !fill()) return false;
+      size_t n = std::min(count, buffer.size() - pos);
+      pos += n;
+      count -= n;
+      if (!sink(buffer.data() + pos - n, n)) return stop();
+    }
+    return true;
+  }
+
+  bool stop() {
+    stopped = true;
+    return false;
+  }
+
+  bool fill() {
+    if (pos > 0 && pos == buffer.size()) {
+      buffer.clear();
+      pos = 0;
+    }
+    long long waitMs = idleTimeoutMs;
+    if (hasDeadline) {
+      auto remaining =
+          std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+      if (remaining <= 0) {
+        expired = true;
+        return false;
+      }
+      if (waitMs <= 0 || remaining < waitMs) waitMs = remaining;
+    }
+    if (waitMs > 0) connection.setTimeout(static_cast<int>(waitMs));
+    auto waitStart = Clock::now();
+    char chunk[16384];
+    int n = connection.receive(chunk, sizeof(chunk));
+    if (n < 0 && hasDeadline && Clock::now() >= deadline) {
+      expired = true;
+    } else if (n < 0 && idleTimeoutMs > 0 &&
+               Clock::now() - waitStart >= std::chrono::milliseconds(idleTimeoutMs)) {
+      stalled = true;
+    }
+    if (n <= 0) return false;
+    buffer.append(chunk, static_cast<size_t>(n));
+    received += static_cast<size_t>(n);
+    return true;
+  }
+
+  TcpConnection &connection;
+  std::string buffer;
+  size_t pos = 0;
+  size_t received = 0;
+  bool stopped = false;
+  Clock::time_point deadline;
+  bool hasDeadline = false;
+  bool expired = false;
+  int idleTimeoutMs = 0;
+  bool stalled = false;
+};
+
+/**
+ * HttpTransport - how AIModule sends a request
+ *
+ * HOW IT WORKS:
+ * =============
+ * Implementations keep their connections open between calls, so a chat
+ * turn costs one request/response on a warm connection instead of a
+ * process spawn, a TCP connect and a TLS handshake. post() never throws:
+ * failures come back in HttpResponse::error. Calls may come from more
+ * than one thread.
+ *
+ * With a body callback the response is streamed: bytes go to the
+ * callback as they are read instead of into HttpResponse::body. A cancel
+ * token and a time limit bound how long a caller can be kept waiting.
+ */
+class HttpTransport {
+public:
+  virtual ~HttpTransport() = default;
+
+  virtual HttpResponse post(const std::string &url, const HttpHeaders &headers,
+                            const std::string &body, const HttpRequestOptions &options) = 0;
+
+  HttpResponse post(const std::string &url, const HttpHeaders &headers,
+                    const std::string &body) {
+    return post(url, headers, body, HttpRequestOptions());
+  }
+
+  virtual const char *name() const = 0;
+};
+
+/**
+ * SocketHttpTransport - HTTP/1.1 over plain TCP with keep-alive
+ *
+ * Finished connections go back to a small idle pool and are reused for
+ * the next request to the same host, so concurrent requests each get
+ * their own connection and sequential ones share a warm one. If a reused
+ * connection turns out to have been closed by the server (nothing came
+ * back), the request is sent once more on a fresh connection. No TLS:
+ * meant for local endpoints and mock servers.
+ */
+class SocketHttpTransport : public HttpTransport {
+public:
+  explicit SocketHttpTransport(int timeoutMs = 60000) : timeoutMs(timeoutMs) {}
+
+  const char *name() const override { return "HTTP/1.1 keep-alive"; }
+
+  using HttpTransport::post;
+  HttpResponse post(const std::string &url, const HttpHeaders &headers,
+                    const std::string &body, const HttpRequestOptions &options) override {
+    HttpResponse response;
+    HttpUrl target;
+    if (!HttpUrl::parse(url, target)) {
+      response.error = "Invalid URL: " + url;
+      return response;
+    }
+    if (target.secure) {
+      response.error = "HTTPS is not supported by the socket transport";
+      return response;
+    }
+
+    int limitMs = options.timeoutMs > 0 ? options.timeoutMs : timeoutMs;
+    auto deadline = HttpReader::Clock::now() + std::chrono::milliseconds(limitMs);
+    std::string key = target.host + ":" + std::to_string(target.port);
+    for (int attempt = 0; attempt < 2; attempt++) {
+      TcpConnection connection = takeIdle(key);
+      bool reused = connection.isOpen();
+      int connectMs = options.connectTimeoutMs > 0 ? std::min(options.connectTimeoutMs, limitMs)
+                                                   : limitMs;
+      if (!reused && !connection.connect(target.host, target.port, connectMs)) {
+        response.error = "Could not connect to " + key;
+        response.transient = true;
+        return response;
+      }
+
+      response = HttpResponse();
+      response.reusedConnection = reused;
+      if (options.cancel) {
+        options.cancel->setAbortAction([&connection] { connection.shutdownBoth(); });
+      }
+      bool reusable = true;
+      bool answered =
+          exchange(connection, target, headers, body, options, deadline, response, reusable);
+      if (options.cancel) options.cancel->setAbortAction(nullptr);
+
+      if (options.cancel && options.cancel->isCancelled()) {
+        response.cancelled = true;
+        response.timedOut = false;
+        response.error = "Request cancelled";
+        return response;
+      }
+      if (answered) {
+        if (reusable) putIdle(key, std::move(connection));
+        return response;
+      }
+      // Nothing came back: the server dropped the idle connection
+      if (!reused) break;
+    }
+    response.error = "Connection to " + key + " closed without a response";
+    response.transient = true;
+    return response;
+  }
+
+private:
+  static constexpr size_t MAX_IDLE = 4;
+
+  // Send the request and read the response. False only if the server
+  // answered nothing at all, so the request is safe to resend. Clears
+  // reusable when the connection can't carry another request.
+  bool exchange(TcpConnection &connection, const HttpUrl &target, const HttpHeaders &headers,
+                const std::string &body, const HttpRequestOptions &options,
+                HttpReader::Clock::time_point deadline, HttpResponse &response,
+                bool &reusable) {
+    std::string request = "POST " + target.path + " HTTP/1.1\r\nHost: " + target.host;
+    if (target.port != 80) request += ":" + std::to_string(target.port);
+    request += "\r\nConnection: keep-alive\r\nContent-Length: " + std::to_string(body.size()) +
+               "\r\n";
+    for (const auto &header : headers) {
+      request += header.first + ": " + header.second + "\r\n";
+    }
+    request += "\r\n";
+    request += body;
+
+    if (!connection.sendAll(request)) return false;
+
+    HttpReader reader(connection);
+    reader.setDeadline(deadline);
+    reader.setIdleTimeout(options.readTimeoutMs);
+    std::string statusLine;
+    HttpHeaders responseHeaders;
+    if (!reader.readHead(statusLine, responseHeaders)) {
+      reusable = false;
+      if (reader.hasExpired()) return fail(response, "Timed out waiting for a response", true, true);
+      if (reader.hasStalled()) return fail(response, stalledError(options), true, true);
+      if (reader.getBytesReceived() == 0) return false;
+      return fail(response, "Malformed HTTP response", false, false);
+    }
+
+    // "HTTP/1.1 200 OK"
+    size_t space = statusLine.find(' ');
+    response.status = space == std::string::npos ? 0 : std::atoi(statusLine.c_str() + space + 1);
+
+    bool stream = options.onStatus ? options.onStatus(response.status) : true;
+    bool complete = stream && options.onBody
+                        ? reader.readBody(responseHeaders, options.onBody, true)
+                        : reader.readBody(responseHeaders, response.body, true);
+    if (!complete) {
+      reusable = false;
+      if (reader.wasStopped()) {
+        response.cancelled = true;
+        return fail(response, "Request cancelled", false, false);
+      }
+      if (reader.hasExpired()) {
+        return fail(response, "Timed out in the middle of the response", true, true);
+      }
+      if (reader.hasStalled()) return fail(response, stalledError(options), true, true);
+      return fail(response, "Connection closed in the middle of the response", false, true);
+    }
+
+    bool framed = !findHeader(responseHeaders, "Content-Length").empty() ||
+                  !findHeader(responseHeaders, "Transfer-Encoding").empty();
+    std::string connectionHeader = findHeader(responseHeaders, "Connection");
+    std::transform(connectionHeader.begin(), connectionHeader.end(), connectionHeader.begin(),
+                   ::tolower);
+    if (!framed || connectionHeader == "close" || statusLine.compare(0, 8, "HTTP/1.0") == 0) {
+      reusable = false;
+    } else {
+      connection.setTimeout(timeoutMs);
+    }
+    return true;
+  }
+
+  static std::string stalledError(const HttpRequestOptions &options) {
+    return "No data from the server for " + std::to_string(options.readTimeoutMs) + " ms";
+  }
+
+  static bool fail(HttpResponse &response, const std::string &error, bool timedOut,
+                   bool transient) {
+    response.error = error;
+    response.timedOut = timedOut;
+    response.transient = transient;
+    return true;
+  }
+
+  TcpConnection takeIdle(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = idle.begin(); it != idle.end(); ++it) {
+      if (it->first == key) {
+        TcpConnection connection = std::move(it->second);
+        idle.erase(it);
+        return connection;
+      }
+    }
+    return TcpConnection();
+  }
+
+  void putIdle(const std::string &key, TcpConnection connection) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idle.size() >= MAX_IDLE) idle.erase(idle.begin()); // drop the oldest
+    idle.emplace_back(key, std::move(connection));
+  }
+
+  int timeoutMs;
+  std::mutex mutex; // guards idle
+  std::vector<std::pair<std::string, TcpConnection>> idle; // "host:port", oldest first
+};
+
+#ifdef _WIN32
+/**
+ * WinHttpTransport - HTTPS through WinHTTP
+ *
+ * One WinHTTP session lives as long as the transport. WinHTTP pools
+ * connections per session, so after the first request the TCP connection
+ * and TLS session are reused instead of being set up again every turn.
+ */
+class WinHttpTransport : public HttpTransport {
+public:
+  WinHttpTransport() {
+    session = WinHttpOpen(L"AIExpense/1.0", WINHTTP_ACCESS_TYPE_DEFAULT_PROXY,
+                          WINHTTP_NO_PROXY_NAME, WINHTTP_NO_PROXY_BYPASS, 0);
+    if (session) {
+      // resolve, connect, send, receive (ms)
+      WinHttpSetTimeouts(session, 10000, 10000, 30000, 60000);
+    }
+  }
+
+  ~WinHttpTransport() override {
+    for (auto &entry : connections) WinHttpCloseHandle(entry.second);
+    if (session) WinHttpCloseHandle(session);
+  }
+
+  const char *name() const override { return "WinHTTP keep-alive"; }
+
+  using HttpTransport::post;
+  HttpResponse post(const std::string &url, const HttpHeaders &headers,
+                    const std::string &body, const HttpRequestOptions &options) override {
+    HttpResponse response;
+    HttpUrl target;
+    if (!HttpUrl::parse(url, target)) {
+      response.error = "Invalid URL: " + url;
+      return response;
+    }
+    if (!session) {
+      response.error = "WinHTTP is unavailable (error " + std::to_string(GetLastError()) + ")";
+      return response;
+    }
+
+    HINTERNET connection = connectionFor(target);
+    if (!connection) {
+      response.error = "WinHTTP connect failed (error " + std::to_string(GetLastError()) + ")";
+      return response;
+    }
+
+    HINTERNET request = WinHttpOpenRequest(connection, L"POST", widen(target.path).c_str(),
+                                           nullptr, WINHTTP_NO_REFERER,
+                                           WINHTTP_DEFAULT_ACCEPT_TYPES,
+                                           target.secure ? WINHTTP_FLAG_SECURE : 0);
+    if (!request) {
+      response.error = "WinHTTP request failed (error " + std::to_string(GetLastError()) + ")";
+      return response;
+    }
+
+    if (options.timeoutMs > 0 || options.connectTimeoutMs > 0 || options.readTimeoutMs > 0) {
+      // WinHTTP limits each step; reads past the deadline are stopped below
+      int limitMs = options.timeoutMs > 0 ? options.timeoutMs : 60000;
+      int connectMs = options.connectTimeoutMs > 0 ? options.connectTimeoutMs : limitMs;
+      int readMs = options.readTimeoutMs > 0 ? options.readTimeoutMs : limitMs;
+      WinHttpSetTimeouts(request, connectMs, connectMs, readMs, readMs);
+    }
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(options.timeoutMs > 0 ? options.timeoutMs : 60000);
+
+    // Closing the handle from another thread aborts a blocking call on it
+    std::atomic<HINTERNET> live{request};
+    auto closeRequest = [&live] {
+      if (HINTERNET handle = live.exchange(nullptr)) WinHttpCloseHandle(handle);
+    };
+    if (options.cancel) options.cancel->setAbortAction(closeRequest);
+
+    std::string headerBlock;
+    for (const auto &header : headers) {
+      headerBlock += header.first + ": " + header.second + "\r\n";
+    }
+    std::wstring wideHeaders = widen(headerBlock);
+
+    BOOL ok = WinHttpSendRequest(request,
+                                 wideHeaders.empty() ? WINHTTP_NO_ADDITIONAL_HEADERS
+                                                     : wideHeaders.c_str(),
+                                 static_cast<DWORD>(-1L), const_cast<char *>(body.data()),
+                                 static_cast<DWORD>(body.size()),
+                                 static_cast<DWORD>(body.size()), 0) &&
+              WinHttpReceiveResponse(request, nullptr);
+
+    if (ok) {
+      DWORD status = 0;
+      DWORD size = sizeof(status);
+      WinHttpQueryHeaders(request, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                          WINHTTP_HEADER_NAME_BY_INDEX, &status, &size,
+                          WINHTTP_NO_HEADER_INDEX);
+      response.status = static_cast<int>(status);
+      bool stream = options.onStatus ? options.onStatus(response.status) : true;
+
+      char buffer[16384];
+      DWORD read = 0;
+      while (true) {
+        // Checked before each read, so every chunk read is kept
+        if (std::chrono::steady_clock::now() > deadline) {
+          response.timedOut = true;
+          response.transient = true;
+          response.error = "Timed out in the middle of the response";
+          break;
+        }
+        if (!WinHttpReadData(request, buffer, sizeof(buffer), &read)) {
+          // Reset or receive timeout after the headers: the body is cut short
+          DWORD error = GetLastError();
+          response.timedOut = error == ERROR_WINHTTP_TIMEOUT;
+          response.transient = isTransientError(error);
+          response.error = response.timedOut
+                               ? "Timed out in the middle of the response"
+                               : "WinHTTP receive failed (error " + std::to_string(error) + ")";
+          break;
+        }
+        if (read == 0) break; // the whole body arrived
+        if (!stream || !options.onBody) {
+          response.body.append(buffer, read);
+        } else if (!options.onBody(buffer, read)) {
+          response.cancelled = true;
+          response.error = "Request cancelled";
+          break;
+        }
+      }
+    } else {
+      DWORD error = GetLastError();
+      response.timedOut = error == ERROR_WINHTTP_TIMEOUT;
+      response.transient = isTransientError(error);
+      response.error = response.timedOut ? "Timed out waiting for a response"
+                                         : "WinHTTP send failed (error " + std::to_string(error) + ")";
+    }
+
+    if (options.cancel) {
+      options.cancel->setAbortAction(nullptr);
+      if (options.cancel->isCancelled()) {
+        response.cancelled = true;
+        response.timedOut = false;
+        response.error = "Request cancelled";
+      }
+    }
+    closeRequest();
+    return response;
+  }
+
+private:
+  // Failures a later attempt can get past; the rest (bad certificate,
+  // unknown scheme, ...) would fail the same way again
+  static bool isTransientError(DWORD error) {
+    switch (error) {
+      case ERROR_WINHTTP_TIMEOUT:
+      case ERROR_WINHTTP_NAME_NOT_RESOLVED:
+      case ERROR_WINHTTP_CANNOT_CONNECT:
+      case ERROR_WINHTTP_CONNECTION_ERROR:
+      case ERROR_WINHTTP_RESEND_REQUEST:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Connect handle per host:port, kept for the life of the session
+  HINTERNET connectionFor(const HttpUrl &target) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string key = target.host + ":" + std::to_string(target.port);
+    auto it = connections.find(key);
+    if (it != connections.end()) return it->second;
+
+    HINTERNET connection = WinHttpConnect(session, widen(target.host).c_str(),
+                                          static_cast<INTERNET_PORT>(target.port), 0);
+    if (connection) connections[key] = connection;
+    return connection;
+  }
+
+  static std::wstring widen(const std::string &text) {
+    if (text.empty()) return std::wstring();
+    int size = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()),
+                                   nullptr, 0);
+    std::wstring wide(size, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), &wide[0], size);
+    return wide;
+  }
+
+  HINTERNET session = nullptr;
+  std::mutex mutex; // guards connections
+  std::map<std::string, HINTERNET> connections;
+};
+#endif
+
+// Transport for the platform: WinHTTP (HTTPS) on Windows, plain sockets elsewhere
+inline std::unique_ptr<HttpTransport> createDefaultTransport() {
+#ifdef _WIN32
+  return std::unique_ptr<HttpTransport>(new WinHttpTransport());
+#else
+  return std::unique_ptr<HttpTransport>(new SocketHttpTransport());
+#endif
+}
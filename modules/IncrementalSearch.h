@@ -0,0 +1,126 @@
+#pragma once
+#include "LedgerIndex.h"
+#include "TextSearch.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * IncrementalSearch - keyword search that refines as the query changes
+ *
+ * Evaluation is split into steps of a bounded number of rows so the caller
+ * can check for input between steps; setting a new query simply abandons
+ * the unfinished scan. Completed queries are kept on a stack:
+ * - if the new query contains the previous one (e.g. a typed character),
+ *   only the previous matches are rescanned, never the full ledger
+ * - if the new query matches an earlier entry (e.g. after backspace), its
+ *   results are reused instantly
+ */
+class IncrementalSearch
+{
+public:
+  explicit IncrementalSearch(const LedgerIndex &index) : index(index) {}
+
+  // Start evaluating a new query (cancels any unfinished evaluation)
+  void setQuery(const string &newQuery)
+  {
+    query = newQuery;
+    matches.clear();
+    position = 0;
+
+    // Drop completed queries that the new one does not refine
+    while (!completed.empty() &&
+           query.find(completed.back().query) == string::npos)
+    {
+      completed.pop_back();
+    }
+
+    if (!completed.empty() && completed.back().query == query)
+    {
+      finished = true;
+      return;
+    }
+
+    finished = query.empty();
+    refining = !completed.empty();
+    candidateCount = refining ? completed.back().rows.size() : index.size();
+  }
+
+  // Scan up to maxRows more candidates; returns true once results are final
+  bool step(size_t maxRows)
+  {
+    if (finished)
+      return true;
+
+    size_t end = min(candidateCount, position + maxRows);
+    for (; position < end; position++)
+    {
+      uint32_t row = refining ? completed.back().rows[position]
+                              : static_cast<uint32_t>(position);
+      if (TextSearch::findIgnoreCase(index.foldedDescription(row), query) != string::npos)
+      {
+        matches.push_back(row);
+      }
+    }
+
+    if (position >= candidateCount)
+    {
+      completed.push_back({query, std::move(matches)});
+      matches.clear();
+      finished = true;
+    }
+    return finished;
+  }
+
+  bool done() const { return finished; }
+
+  const string &getQuery() const { return query; }
+
+  // Matching rows in ledger order; every row for an empty query
+  vector<uint32_t> results() const
+  {
+    if (query.empty())
+    {
+      vector<uint32_t> all(index.size());
+      for (size_t i = 0; i < all.size(); i++)
+        all[i] = static_cast<uint32_t>(i);
+      return all;
+    }
+    return finished ? completed.back().rows : vector<uint32_t>();
+  }
+
+  // Count of results (valid once done)
+  size_t resultCount() const
+  {
+    if (query.empty())
+      return index.size();
+    return finished ? completed.back().rows.size() : 0;
+  }
+
+  // Row of the i-th newest result (valid once done)
+  uint32_t newestResult(size_t i) const
+  {
+    if (query.empty())
+      return static_cast<uint32_t>(index.size() - 1 - i);
+    const vector<uint32_t> &rows = completed.back().rows;
+    return rows[rows.size() - 1 - i];
+  }
+
+private:
+  struct CompletedQuery
+  {
+    string query;
+    vector<uint32_t> rows;
+  };
+
+  const LedgerIndex &index;
+  string query;
+  vector<CompletedQuery> completed; // each entry refines the one below
+  vector<uint32_t> matches;         // partial results of the current scan
+  size_t position = 0;
+  size_t candidateCount = 0;
+  bool refining = false;
+  bool finished = true;
+};
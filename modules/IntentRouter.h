@@ -0,0 +1,389 @@
+#pragma once
+
+#include "Categorizer.h"
+#include "LedgerIndex.h"
+#include "TextSearch.h"
+#include "Transaction.h"
+#include "TransactionManager.h"
+#include <chrono>
+#include <cstdio>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * IntentRouter - answers simple ledger questions without the model
+ *
+ * HOW IT WORKS:
+ * =============
+ * A question is split into case-folded words and matched against a small
+ * grammar. Every word has to be one of:
+ * - an intent word: balance / net worth, income / earn / make, spend /
+ *   expenses / cost, biggest / largest / most expensive, how many
+ * - a category slot: a category name ("food", "utility", "utilities")
+ * - a period slot: today, yesterday, this / last month, this / last
+ *   year, a month name with an optional year, or a year
+ * - a filler word ("what", "is", "my", "on", "so far", ...)
+ *
+ * One unknown word and the question goes to the model, so "how can I
+ * spend less on food" or "what did I spend at Uber" are never answered
+ * here. A match becomes bitmap filters on the LedgerIndex (type AND
+ * category AND the date range, which is a contiguous run of rows) and
+ * the reply is a sum, a count or the largest row over them: microseconds
+ * instead of a network round trip.
+ *
+ * Session counters (questions seen, answered locally, time taken here and
+ * by the model) give the local-answer rate and the latency saved.
+ */
+class IntentRouter {
+public:
+  enum class Intent { None, Balance, Income, Spending, Largest, Count };
+
+  struct Answer {
+    Intent intent = Intent::None;
+    std::string text; // the reply; empty when the model should answer
+    double elapsedMs = 0;
+
+    bool answered() const { return intent != Intent::None; }
+  };
+
+  struct Stats {
+    size_t questions = 0;
+    size_t answeredLocally = 0;
+    double localMs = 0; // time spent routing, all questions
+    size_t modelReplies = 0;
+    double modelMs = 0; // time the model took for the rest
+  };
+
+  // Route a chat question against the signed-in user's ledger, counting it
+  // in the session stats
+  static Answer route(const std::string &question) {
+    Answer answer = route(question, TransactionManager::getLedger(),
+                          TransactionManager::getIndex(),
+                          Transaction::parseDateKey(Transaction::generateCurrentDate()));
+    std::lock_guard<std::mutex> lock(statsMutex());
+    stats().questions++;
+    stats().localMs += answer.elapsedMs;
+    if (answer.answered()) stats().answeredLocally++;
+    return answer;
+  }
+
+  // Route against any ledger, with "today" as a yyyymmdd key
+  static Answer route(const std::string &question, const std::vector<Transaction> &ledger,
+                      const LedgerIndex &index, int todayKey) {
+    auto started = std::chrono::steady_clock::now();
+    Answer answer;
+    Query query;
+    if (parse(question, todayKey, query)) {
+      answer.intent = query.intent;
+      answer.text = respond(query, ledger, index);
+    }
+    answer.elapsedMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started)
+            .count();
+    return answer;
+  }
+
+  // Time the model took on a question the router passed on
+  static void recordModelReply(double ms) {
+    std::lock_guard<std::mutex> lock(statsMutex());
+    stats().modelReplies++;
+    stats().modelMs += ms;
+  }
+
+  static Stats getStats() {
+    std::lock_guard<std::mutex> lock(statsMutex());
+    return stats();
+  }
+
+  // Share of questions answered here (0 before the first question)
+  static double getLocalAnswerRate(const Stats &s) {
+    return s.questions == 0 ? 0.0 : static_cast<double>(s.answeredLocally) / s.questions;
+  }
+
+  // Model time the local answers would have cost, at this session's
+  // average model reply time, less the time spent routing
+  static double getLatencySavedMs(const Stats &s) {
+    if (s.modelReplies == 0) return 0.0;
+    double saved = s.answeredLocally * (s.modelMs / s.modelReplies) - s.localMs;
+    return saved > 0 ? saved : 0.0;
+  }
+
+private:
+  // A matched question: what to compute over which rows
+  struct Query {
+    Intent intent = Intent::None;
+    std::string type;  // "income", "expense" or "" (both)
+    int category = -1; // -1: any
+    int from = 0;      // yyyymmdd range, inclusive
+    int to = 99991231;
+    std::string period; // " this month", " in March 2025", ... ("" for all time)
+  };
+
+  static bool parse(const std::string &question, int todayKey, Query &query) {
+    std::string folded = question;
+    for (char &c : folded) c = TextSearch::foldCase(c);
+    std::vector<std::string> words;
+    LedgerIndex::forEachWord(folded, [&](std::string_view word) { words.emplace_back(word); });
+    if (words.empty()) return false;
+
+    bool balance = false, have = false, income = false, incomeNoun = false, spending = false;
+    bool largest = false, count = false, period = false;
+    for (size_t i = 0; i < words.size(); i++) {
+      const std::string &word = words[i];
+      const std::string next = i + 1 < words.size() ? words[i + 1] : "";
+
+      int periodWords = parsePeriod(word, next, todayKey, query);
+      if (periodWords > 0) {
+        if (period) return false; // two periods: leave it to the model
+        period = true;
+        i += periodWords - 1;
+        continue;
+      }
+      int category = categoryOf(word);
+      if (category >= 0) {
+        if (query.category >= 0 && query.category != category) return false;
+        query.category = category;
+        continue;
+      }
+
+      if (word == "balance" || word == "net" || word == "worth") {
+        balance = true;
+      } else if (word == "have") {
+        have = true;
+      } else if (word == "income" || word == "earnings") {
+        income = incomeNoun = true;
+      } else if (isOneOf(word, {"earn", "earned", "make", "made", "get", "got", "receive",
+                                "received"})) {
+        income = true;
+      } else if (isOneOf(word, {"spend", "spent", "spending", "expense", "expenses", "cost",
+                                "costs", "paid", "pay"})) {
+        spending = true;
+      } else if (isOneOf(word, {"biggest", "largest", "highest", "top", "expensive"})) {
+        largest = true;
+      } else if (word == "most" && next == "expensive") {
+        largest = true;
+        i++;
+      } else if (word == "many") {
+        count = true;
+      } else if (!isFiller(word)) {
+        return false;
+      }
+    }
+
+    if (count) {
+      // "how many transactions did I make": make is not income here
+      query.intent = Intent::Count;
+      if (balance || largest || (spending && incomeNoun)) return false;
+      query.type = spending ? "expense" : incomeNoun ? "income" : "";
+    } else if (largest) {
+      query.intent = Intent::Largest;
+      if (balance || (spending && income)) return false;
+      query.type = incomeNoun ? "income" : "expense";
+    } else if (balance || (have && !income && !spending)) {
+      query.intent = Intent::Balance;
+      if (income || spending || query.category >= 0) return false;
+    } else if (income && !spending) {
+      query.intent = Intent::Income;
+      query.type = "income";
+    } else if (spending && !income) {
+      query.intent = Intent::Spending;
+      query.type = "expense";
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  // Words taken by a period slot at words[i] (0 if none), setting the range
+  static int parsePeriod(const std::string &word, const std::string &next, int todayKey,
+                         Query &query) {
+    int year = todayKey / 10000;
+    int month = (todayKey / 100) % 100;
+    if (word == "today") {
+      setRange(query, todayKey, todayKey, " today");
+      return 1;
+    }
+    if (word == "yesterday") {
+      int day = LedgerIndex::dateKeyFromDay(LedgerIndex::dayNumber(todayKey) - 1);
+      setRange(query, day, day, " yesterday");
+      return 1;
+    }
+    if ((word == "this" || word == "last") && next == "month") {
+      if (word == "last") {
+        year -= month == 1;
+        month = month == 1 ? 12 : month - 1;
+      }
+      setMonth(query, year, month, " " + word + " month");
+      return 2;
+    }
+    if ((word == "this" || word == "last") && next == "year") {
+      if (word == "last") year--;
+      setRange(query, year * 10000 + 101, year * 10000 + 1231, " " + word + " year");
+      return 2;
+    }
+    int named = monthNumber(word);
+    if (named > 0) {
+      int namedYear = yearOf(next);
+      if (namedYear == 0) namedYear = named > month ? year - 1 : year;
+      setMonth(query, namedYear, named, " in " + monthNames()[named - 1] + " " +
+                                            std::to_string(namedYear));
+      return yearOf(next) ? 2 : 1;
+    }
+    int alone = yearOf(word);
+    if (alone > 0) {
+      setRange(query, alone * 10000 + 101, alone * 10000 + 1231, " in " + word);
+      return 1;
+    }
+    return 0;
+  }
+
+  static void setMonth(Query &query, int year, int month, const std::string &label) {
+    setRange(query, year * 10000 + month * 100 + 1, year * 10000 + month * 100 + 31, label);
+  }
+
+  static void setRange(Query &query, int from, int to, const std::string &label) {
+    query.from = from;
+    query.to = to;
+    query.period = label;
+  }
+
+  static const std::vector<std::string> &monthNames() {
+    static const std::vector<std::string> names = {
+        "January", "February", "March",     "April",   "May",      "June",
+        "July",    "August",   "September", "October", "November", "December"};
+    return names;
+  }
+
+  // 1-12 for a folded month name or its first three letters ("sept" too)
+  static int monthNumber(const std::string &word) {
+    for (int m = 1; m <= 12; m++) {
+      std::string name = monthNames()[m - 1];
+      for (char &c : name) c = TextSearch::foldCase(c);
+      if (word == name || word == LedgerIndex::monthTerm(m) || (m == 9 && word == "sept")) {
+        return m;
+      }
+    }
+    return 0;
+  }
+
+  // A four-digit year 1900-2199, or 0
+  static int yearOf(const std::string &word) {
+    if (word.size() != 4 || word.find_first_not_of("0123456789") != std::string::npos) return 0;
+    int year = std::stoi(word);
+    return year >= 1900 && year < 2200 ? year : 0;
+  }
+
+  // Category id of a folded name, singular or plural ("utility"), or -1
+  static int categoryOf(const std::string &word) {
+    const auto &names = Categorizer::getCategoryNames();
+    for (size_t id = 0; id < names.size(); id++) {
+      std::string name = names[id];
+      for (char &c : name) c = TextSearch::foldCase(c);
+      std::string singular = name.size() > 3 && name.compare(name.size() - 3, 3, "ies") == 0
+                                 ? name.substr(0, name.size() - 3) + "y"
+                                 : name;
+      if (word == name || word == singular || word == name + "s") {
+        return static_cast<int>(id);
+      }
+    }
+    return -1;
+  }
+
+  static bool isOneOf(const std::string &word, std::initializer_list<const char *> options) {
+    for (const char *option : options) {
+      if (word == option) return true;
+    }
+    return false;
+  }
+
+  static bool isFiller(const std::string &word) {
+    return isOneOf(word, {"what", "whats", "s", "is", "was", "were", "are", "am", "my", "me",
+                          "the", "a", "i", "did", "do", "does", "has", "had", "been", "how",
+                          "much", "total", "in", "on", "for", "of", "from", "so", "far",
+                          "to", "date", "current", "currently", "now", "right", "please",
+                          "tell", "show", "give", "money", "amount", "overall", "all",
+                          "time", "ever", "during", "up", "transaction", "transactions",
+                          "purchase", "purchases", "payment", "payments", "there"});
+  }
+
+  static std::string respond(const Query &query, const std::vector<Transaction> &ledger,
+                             const LedgerIndex &index) {
+    RoaringBitmap rows = query.type.empty() ? index.all() : index.byType(query.type);
+    if (query.category >= 0) rows &= index.byCategory(categoryName(query.category));
+    if (!query.period.empty()) rows &= index.byDateRange(query.from, query.to);
+    size_t count = static_cast<size_t>(rows.cardinality());
+    std::string in = query.category >= 0 ? " on " + categoryName(query.category) : "";
+
+    switch (query.intent) {
+    case Intent::Balance: {
+      double income = index.getTotalIncome();
+      double expenses = index.getTotalExpenses();
+      if (!query.period.empty()) {
+        income = index.sum(index.byType("income") & rows);
+        expenses = index.sum(index.byType("expense") & rows);
+      }
+      std::string what = query.period.empty() ? "Your balance is " : "Net" + query.period + ": ";
+      return what + money(income - expenses) + " (income " + money(income) + ", expenses " +
+             money(expenses) + ").";
+    }
+    case Intent::Income: {
+      std::string from = query.category >= 0 ? " from " + categoryName(query.category) : "";
+      return "You received " + money(index.sum(rows)) + from + query.period + " (" +
+             plural(count, "transaction") + ").";
+    }
+    case Intent::Spending:
+      return "You spent " + money(index.sum(rows)) + in + query.period + " (" +
+             plural(count, "expense") + ").";
+    case Intent::Largest: {
+      std::string what = query.type == "income" ? "income" : "expense";
+      if (count == 0) return "You have no " + what + "s" + in + query.period + ".";
+      uint32_t top = 0;
+      double amount = -1;
+      rows.forEach([&](uint32_t row) {
+        if (index.amountAt(row) > amount) {
+          amount = index.amountAt(row);
+          top = row;
+        }
+      });
+      const Transaction &t = ledger[top];
+      return "Your biggest " + what + in + query.period + " was " + money(amount) + ": " +
+             t.getDescription() + " on " + t.getDate() + " (" +
+             Categorizer::categorize(t.getDescription()) + ").";
+    }
+    case Intent::Count: {
+      std::string what = query.type.empty() ? "transaction" : query.type;
+      return "You have " + plural(count, what) + in + query.period + ".";
+    }
+    default:
+      return "";
+    }
+  }
+
+  static const std::string &categoryName(int category) {
+    return Categorizer::getCategoryNames()[category];
+  }
+
+  static std::string money(double amount) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%s$%.2f", amount < 0 ? "-" : "",
+                  amount < 0 ? -amount : amount);
+    return text;
+  }
+
+  static std::string plural(size_t count, const std::string &noun) {
+    return std::to_string(count) + " " + noun + (count == 1 ? "" : "s");
+  }
+
+  static Stats &stats() {
+    static Stats session;
+    return session;
+  }
+
+  static std::mutex &statsMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+};
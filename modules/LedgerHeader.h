@@ -0,0 +1,65 @@
+#pragma once
+#include "../include/nlohmann/json.hpp"
+#include <cstdint>
+#include <string>
+
+using json = nlohmann::json;
+using namespace std;
+
+/**
+ * LedgerHeader - what the app needs to know about the ledger without reading it
+ *
+ * HOW IT WORKS:
+ * =============
+ * The transaction file starts with one short line ahead of the encrypted
+ * body (see FileHandler::writeTransactionsToFile):
+ *
+ *   LEDGER <format version> <key check> <encrypted summary>
+ *
+ * The key check is the session key's check value, so a ledger written
+ * with another key is caught before its body is decrypted. The summary
+ * holds the row count, largest id, first and last dates, totals and the
+ * data version. It is encrypted like the body, because the totals are
+ * as private as the rows, but it is only a few hundred bytes. Row counts,
+ * totals and the next id are then known at login, and the body is read
+ * only when the rows themselves are needed.
+ */
+struct LedgerHeader
+{
+  static constexpr int FORMAT_VERSION = 1;
+
+  int formatVersion = FORMAT_VERSION;
+  string keyCheck;
+  size_t rows = 0;
+  int maxId = 0;
+  int firstDateKey = 0; // yyyymmdd, 0 = no dated rows
+  int lastDateKey = 0;
+  double totalIncome = 0.0;
+  double totalExpenses = 0.0;
+  uint64_t dataVersion = 0; // LedgerIndex::getVersion() of the rows
+
+  // The encrypted part
+  json summaryToJson() const
+  {
+    json j;
+    j["rows"] = rows;
+    j["maxId"] = maxId;
+    j["firstDate"] = firstDateKey;
+    j["lastDate"] = lastDateKey;
+    j["totalIncome"] = totalIncome;
+    j["totalExpenses"] = totalExpenses;
+    j["dataVersion"] = dataVersion;
+    return j;
+  }
+
+  void summaryFromJson(const json &j)
+  {
+    rows = j.value("rows", static_cast<size_t>(0));
+    maxId = j.value("maxId", 0);
+    firstDateKey = j.value("firstDate", 0);
+    lastDateKey = j.value("lastDate", 0);
+    totalIncome = j.value("totalIncome", 0.0);
+    totalExpenses = j.value("totalExpenses", 0.0);
+    dataVersion = j.value("dataVersion", static_cast<uint64_t>(0));
+  }
+};
@@ -0,0 +1,499 @@
+#pragma once
+#include "Categorizer.h"
+#include "RoaringBitmap.h"
+#include "TextSearch.h"
+#include "Transaction.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * LedgerIndex - in-memory filter indexes over the loaded ledger
+ *
+ * Row ids are positions in the ledger vector. One bitmap per transaction
+ * type and one per category are kept up to date as rows are added, so
+ * filters become bitmap AND / OR and counts come from bitmap cardinality.
+ * A parallel amount column keeps aggregation away from Transaction copies.
+ *
+ * Descriptions are also indexed by case-folded byte bigram (one bitmap per
+ * bigram), which lets fuzzy search discard rows by q-gram count before
+ * running an edit-distance check. A contiguous case-folded copy of every
+ * description is kept as a column so text scans walk memory linearly.
+ *
+ * Dates are parsed once into a yyyymmdd key column. The dated rows are also
+ * kept sorted by date (a row permutation beside their sorted keys), so date
+ * lookups are binary searches whatever order the rows were saved in; rows
+ * with unparsable dates are left out of it. Rows are normally appended
+ * with the current date, and while every row is dated and in order the
+ * permutation is the identity and a date range is one run of rows.
+ * Income and expenses are also pre-aggregated into one bin per day, which
+ * is what charts read instead of walking the rows.
+ *
+ * For relevance ranking every row is also indexed by term: the words of its
+ * description plus its category name, month ("mar") and year ("2025"),
+ * one bitmap of rows per term, with the number of terms per row kept as
+ * the document length BM25 normalizes by.
+ *
+ * A data version (FNV-1a hash folded over every added row) identifies the
+ * ledger contents: it is the same after a reload and changes with any
+ * added row, so results computed from the ledger can be keyed by it.
+ */
+class LedgerIndex
+{
+public:
+  // Totals of one calendar day
+  struct DayBin
+  {
+    int day;     // days since 1970-01-01
+    int dateKey; // yyyymmdd
+    double income;
+    double expenses;
+  };
+
+  enum TypeCode : uint8_t
+  {
+    TYPE_OTHER = 0,
+    TYPE_INCOME = 1,
+    TYPE_EXPENSE = 2
+  };
+
+  void clear()
+  {
+    incomeRows.clear();
+    expenseRows.clear();
+    categoryRows.assign(Categorizer::getCategoryNames().size(), RoaringBitmap());
+    bigramRows.assign(BIGRAM_COUNT, RoaringBitmap());
+    amounts.clear();
+    types.clear();
+    dateKeys.clear();
+    sortedDateKeys.clear();
+    rowsByDate.clear();
+    datesInRowOrder = true;
+    dailyBins.clear();
+    foldedText.clear();
+    foldedOffsets.assign(1, 0);
+    termIds.clear();
+    termRows.clear();
+    termCounts.clear();
+    totalTerms = 0;
+    totalIncome = 0.0;
+    totalExpenses = 0.0;
+    maxId = 0;
+    version = FNV_OFFSET;
+  }
+
+  void rebuild(const vector<Transaction> &transactions)
+  {
+    clear();
+    amounts.reserve(transactions.size());
+    types.reserve(transactions.size());
+    dateKeys.reserve(transactions.size());
+    sortedDateKeys.reserve(transactions.size());
+    rowsByDate.reserve(transactions.size());
+    foldedOffsets.reserve(transactions.size() + 1);
+    termCounts.reserve(transactions.size());
+    rebuilding = true;
+    for (size_t row = 0; row < transactions.size(); row++)
+    {
+      add(static_cast<uint32_t>(row), transactions[row]);
+    }
+    rebuilding = false;
+    if (!datesInRowOrder)
+    {
+      sortDates();
+    }
+  }
+
+  // Index one row (rows must be added in order)
+  void add(uint32_t row, const Transaction &t)
+  {
+    if (categoryRows.empty())
+    {
+      clear();
+    }
+
+    const string &type = t.getType();
+    TypeCode code = TYPE_OTHER;
+    if (type == "income")
+    {
+      incomeRows.add(row);
+      totalIncome += t.getAmount();
+      code = TYPE_INCOME;
+    }
+    else if (type == "expense")
+    {
+      expenseRows.add(row);
+      totalExpenses += t.getAmount();
+      code = TYPE_EXPENSE;
+    }
+    types.push_back(code);
+
+    int category = Categorizer::categorizeId(t.getDescription());
+    categoryRows[category].add(row);
+
+    const string &desc = t.getDescription();
+    for (size_t i = 0; i + 1 < desc.size(); i++)
+    {
+      bigramRows[bigramKey(desc[i], desc[i + 1])].add(row);
+    }
+    for (char c : desc)
+    {
+      foldedText.push_back(static_cast<char>(foldCase(c)));
+    }
+    foldedOffsets.push_back(static_cast<uint32_t>(foldedText.size()));
+
+    amounts.push_back(t.getAmount());
+    dateKeys.push_back(Transaction::parseDateKey(t.getDate()));
+    addToDateOrder(row, dateKeys.back());
+    addToDailyBin(dateKeys.back(), code, t.getAmount());
+    addTerms(row, category, dateKeys.back());
+    if (t.getId() > maxId)
+    {
+      maxId = t.getId();
+    }
+
+    double amount = t.getAmount();
+    uint64_t amountBits;
+    memcpy(&amountBits, &amount, sizeof(amountBits));
+    hashValue(static_cast<uint64_t>(t.getId()));
+    hashValue(code);
+    hashValue(amountBits);
+    hashValue(static_cast<uint64_t>(dateKeys.back()));
+    for (unsigned char c : desc)
+    {
+      version = (version ^ c) * FNV_PRIME;
+    }
+  }
+
+  size_t size() const { return amounts.size(); }
+
+  // Every indexed row
+  RoaringBitmap all() const { return RoaringBitmap::range(static_cast<uint32_t>(size())); }
+
+  // Rows of a type ("income" / "expense"); empty for anything else
+  const RoaringBitmap &byType(const string &type) const
+  {
+    if (type == "income")
+      return incomeRows;
+    if (type == "expense")
+      return expenseRows;
+    return emptyBitmap();
+  }
+
+  // Rows of a category name; empty for unknown categories
+  const RoaringBitmap &byCategory(const string &category) const
+  {
+    int id = Categorizer::getCategoryId(category);
+    if (id < 0 || id >= static_cast<int>(categoryRows.size()))
+      return emptyBitmap();
+    return categoryRows[id];
+  }
+
+  // Rows whose description contains the bigram (ASCII case-insensitive)
+  const RoaringBitmap &byBigram(char first, char second) const
+  {
+    if (bigramRows.empty())
+      return emptyBitmap();
+    return bigramRows[bigramKey(first, second)];
+  }
+
+  // Lower-cased description of a row (valid until the next add)
+  string_view foldedDescription(uint32_t row) const
+  {
+    return string_view(foldedText.data() + foldedOffsets[row],
+                       foldedOffsets[row + 1] - foldedOffsets[row]);
+  }
+
+  // Rows having a term: a lower-case description word, category name,
+  // month ("jan".."dec") or year ("2025"). Empty for unknown terms.
+  const RoaringBitmap &byTerm(const string &term) const
+  {
+    auto it = termIds.find(term);
+    if (it == termIds.end())
+      return emptyBitmap();
+    return termRows[it->second];
+  }
+
+  // Terms indexed for a row (its BM25 document length)
+  uint32_t termCountAt(uint32_t row) const { return termCounts[row]; }
+
+  double averageTermCount() const
+  {
+    return termCounts.empty() ? 0.0 : static_cast<double>(totalTerms) / termCounts.size();
+  }
+
+  // Month term of a 1-based month
+  static const char *monthTerm(int month)
+  {
+    static const char *terms[] = {"jan", "feb", "mar", "apr", "may", "jun",
+                                  "jul", "aug", "sep", "oct", "nov", "dec"};
+    return month >= 1 && month <= 12 ? terms[month - 1] : "";
+  }
+
+  // Call fn for each word of a folded text: runs of letters, digits and
+  // non-ASCII bytes
+  template <typename Fn>
+  static void forEachWord(string_view text, Fn fn)
+  {
+    size_t start = 0;
+    for (size_t i = 0; i <= text.size(); i++)
+    {
+      unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+      bool wordChar = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80;
+      if (!wordChar)
+      {
+        if (i > start)
+          fn(text.substr(start, i - start));
+        start = i + 1;
+      }
+    }
+  }
+
+  // ASCII case fold used by the bigram index
+  static unsigned char foldCase(char c)
+  {
+    return static_cast<unsigned char>(TextSearch::foldCase(c));
+  }
+
+  double amountAt(uint32_t row) const { return amounts[row]; }
+  TypeCode typeAt(uint32_t row) const { return static_cast<TypeCode>(types[row]); }
+  int dateKeyAt(uint32_t row) const { return dateKeys[row]; }
+
+  // The latest-dated row on or before a yyyymmdd key, the last added of
+  // that day (-1 if there is none)
+  int lastRowThroughDate(int key) const
+  {
+    size_t count = upper_bound(sortedDateKeys.begin(), sortedDateKeys.end(), key) -
+                   sortedDateKeys.begin();
+    return count == 0 ? -1 : static_cast<int>(rowsByDate[count - 1]);
+  }
+
+  // Rows dated from one yyyymmdd key through another (inclusive)
+  RoaringBitmap byDateRange(int fromKey, int toKey) const
+  {
+    size_t first = lower_bound(sortedDateKeys.begin(), sortedDateKeys.end(), fromKey) -
+                   sortedDateKeys.begin();
+    size_t last = upper_bound(sortedDateKeys.begin(), sortedDateKeys.end(), toKey) -
+                  sortedDateKeys.begin();
+    if (first >= last)
+      return RoaringBitmap();
+    if (datesInRowOrder)
+      return RoaringBitmap::range(static_cast<uint32_t>(first), static_cast<uint32_t>(last));
+
+    vector<uint32_t> rows(rowsByDate.begin() + first, rowsByDate.begin() + last);
+    sort(rows.begin(), rows.end());
+    RoaringBitmap result;
+    for (uint32_t row : rows)
+      result.add(row);
+    return result;
+  }
+
+  // Day bins in date order (rows with unparsable dates are left out)
+  const vector<DayBin> &getDailyBins() const { return dailyBins; }
+
+  // Days since 1970-01-01 for a yyyymmdd key (proleptic Gregorian)
+  static int dayNumber(int dateKey)
+  {
+    int y = dateKey / 10000;
+    int m = (dateKey / 100) % 100;
+    int d = dateKey % 100;
+    y -= m <= 2;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+  }
+
+  // yyyymmdd key for a day number (inverse of dayNumber)
+  static int dateKeyFromDay(int day)
+  {
+    int z = day + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    int d = doy - (153 * mp + 2) / 5 + 1;
+    int m = mp < 10 ? mp + 3 : mp - 9;
+    int y = yoe + era * 400 + (m <= 2);
+    return y * 10000 + m * 100 + d;
+  }
+
+  // Sum of amounts over a row set
+  double sum(const RoaringBitmap &rows) const
+  {
+    double total = 0.0;
+    rows.forEach([&](uint32_t row) { total += amounts[row]; });
+    return total;
+  }
+
+  double getTotalIncome() const { return totalIncome; }
+  double getTotalExpenses() const { return totalExpenses; }
+  int getMaxId() const { return maxId; }
+
+  // Identifies the indexed contents (see the class comment)
+  uint64_t getVersion() const { return version; }
+
+private:
+  RoaringBitmap incomeRows;
+  RoaringBitmap expenseRows;
+  vector<RoaringBitmap> categoryRows; // by Categorizer category id
+  vector<RoaringBitmap> bigramRows;   // by bigramKey, BIGRAM_COUNT entries
+  vector<double> amounts;             // amount column by row
+  vector<uint8_t> types;              // TypeCode column by row
+  vector<int> dateKeys;               // yyyymmdd column by row (0 = unparsed)
+  vector<int> sortedDateKeys;         // keys of the dated rows, ascending
+  vector<uint32_t> rowsByDate;        // their rows, by date then row
+  bool datesInRowOrder = true;        // rowsByDate[i] == i for every row
+  bool rebuilding = false;            // sort once at the end of rebuild()
+  vector<DayBin> dailyBins;           // ascending by day
+  string foldedText;                  // lower-cased descriptions, back to back
+  vector<uint32_t> foldedOffsets;     // row i spans [offsets[i], offsets[i+1])
+  unordered_map<string, uint32_t> termIds; // term -> position in termRows
+  vector<RoaringBitmap> termRows;          // rows by term id
+  vector<uint16_t> termCounts;             // terms indexed per row
+  uint64_t totalTerms = 0;
+  double totalIncome = 0.0;
+  double totalExpenses = 0.0;
+  int maxId = 0;
+  uint64_t version = FNV_OFFSET;
+
+  static constexpr size_t BIGRAM_COUNT = 65536;
+  static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+  static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+  // Fold the 8 bytes of a value into the version
+  void hashValue(uint64_t value)
+  {
+    for (int i = 0; i < 8; i++)
+    {
+      version = (version ^ ((value >> (i * 8)) & 0xFF)) * FNV_PRIME;
+    }
+  }
+
+  void addToDateOrder(uint32_t row, int dateKey)
+  {
+    if (dateKey == 0)
+    {
+      datesInRowOrder = false; // left out, so positions no longer match rows
+      return;
+    }
+    if (sortedDateKeys.empty() || sortedDateKeys.back() <= dateKey || rebuilding)
+    {
+      if (!sortedDateKeys.empty() && sortedDateKeys.back() > dateKey)
+        datesInRowOrder = false; // sorted at the end of rebuild()
+      sortedDateKeys.push_back(dateKey);
+      rowsByDate.push_back(row);
+      return;
+    }
+
+    // An earlier date than the last row's: insert it after its day's rows
+    datesInRowOrder = false;
+    size_t at = upper_bound(sortedDateKeys.begin(), sortedDateKeys.end(), dateKey) -
+                sortedDateKeys.begin();
+    sortedDateKeys.insert(sortedDateKeys.begin() + at, dateKey);
+    rowsByDate.insert(rowsByDate.begin() + at, row);
+  }
+
+  // Order the dated rows by date, keeping row order within a day
+  void sortDates()
+  {
+    vector<uint32_t> order(rowsByDate.size());
+    for (size_t i = 0; i < order.size(); i++)
+      order[i] = static_cast<uint32_t>(i);
+    stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+                { return sortedDateKeys[a] < sortedDateKeys[b]; });
+    vector<int> keys(order.size());
+    vector<uint32_t> rows(order.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+      keys[i] = sortedDateKeys[order[i]];
+      rows[i] = rowsByDate[order[i]];
+    }
+    sortedDateKeys.swap(keys);
+    rowsByDate.swap(rows);
+  }
+
+  void addToDailyBin(int dateKey, TypeCode code, double amount)
+  {
+    if (dateKey == 0 || code == TYPE_OTHER)
+      return;
+
+    int day = dayNumber(dateKey);
+    auto it = dailyBins.end();
+    if (dailyBins.empty() || dailyBins.back().day < day)
+    {
+      it = dailyBins.insert(dailyBins.end(), {day, dateKey, 0.0, 0.0});
+    }
+    else
+    {
+      // Out-of-order date: find or insert its bin
+      it = lower_bound(dailyBins.begin(), dailyBins.end(), day,
+                       [](const DayBin &bin, int value) { return bin.day < value; });
+      if (it == dailyBins.end() || it->day != day)
+        it = dailyBins.insert(it, {day, dateKey, 0.0, 0.0});
+    }
+
+    if (code == TYPE_INCOME)
+      it->income += amount;
+    else
+      it->expenses += amount;
+  }
+
+  void addTerm(uint32_t row, string_view term)
+  {
+    auto it = termIds.find(string(term));
+    if (it == termIds.end())
+    {
+      it = termIds.emplace(string(term), static_cast<uint32_t>(termRows.size())).first;
+      termRows.emplace_back();
+    }
+    termRows[it->second].add(row); // repeats of a word in one row count once
+  }
+
+  // Index the row's words (from the folded description just appended),
+  // category, month and year
+  void addTerms(uint32_t row, int category, int dateKey)
+  {
+    uint32_t count = 0;
+    forEachWord(foldedDescription(row), [&](string_view word)
+                {
+                  addTerm(row, word);
+                  count++;
+                });
+
+    string name = Categorizer::getCategoryNames()[category];
+    for (char &c : name)
+      c = static_cast<char>(foldCase(c));
+    addTerm(row, name);
+    count++;
+
+    if (dateKey != 0)
+    {
+      addTerm(row, monthTerm((dateKey / 100) % 100));
+      addTerm(row, to_string(dateKey / 10000));
+      count += 2;
+    }
+
+    termCounts.push_back(static_cast<uint16_t>(min<uint32_t>(count, 65535)));
+    totalTerms += count;
+  }
+
+  static size_t bigramKey(char first, char second)
+  {
+    return (static_cast<size_t>(foldCase(first)) << 8) | foldCase(second);
+  }
+
+  static const RoaringBitmap &emptyBitmap()
+  {
+    static const RoaringBitmap empty;
+    return empty;
+  }
+};
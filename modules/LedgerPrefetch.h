@@ -0,0 +1,128 @@
+#pragma once
+
+#include "FileHandler.h"
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <utility>
+
+/**
+ * LedgerPrefetch - read the ledger from disk while the password is typed
+ *
+ * HOW IT WORKS:
+ * =============
+ * The login screen calls start() as it opens. A background task reads
+ * transactions.json and decodes its hex body, the part of opening the
+ * ledger that needs no key and grows with the file. Reading it all also
+ * leaves the file in the OS page cache. When the ledger is first needed
+ * after login, TransactionManager take()s the bytes (waiting for the task
+ * if it is still running), so only decryption and parsing are left.
+ *
+ * The bytes are used once, and only if the file's header line is still
+ * what it was when they were read. Any save re-encrypts the summary in
+ * the header, so a file rewritten in between (e.g. migrated at login) is
+ * read again instead.
+ *
+ * It also times login to the first dashboard frame (the welcome pause
+ * left out), so the effect shows in diagnostics.
+ */
+class LedgerPrefetch {
+public:
+  // Start reading in the background (no-op while a read is pending)
+  static void start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending.valid()) return;
+    pending = std::async(std::launch::async, [] {
+      Prefetched read;
+      auto started = Clock::now();
+      read.ok = FileHandler::readTransactionCiphertext(read.headerLine, read.ciphertext) &&
+                !read.headerLine.empty();
+      read.readMs = msSince(started);
+      return read;
+    });
+  }
+
+  // The prefetched encrypted body, waiting for the read if need be.
+  // False if there was none or the file has changed since.
+  static bool take(std::string &ciphertext) {
+    std::future<Prefetched> read;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      read = std::move(pending);
+    }
+    if (!read.valid()) return false;
+
+    Prefetched result = read.get();
+    lastReadMs = result.readMs;
+    used = result.ok && result.headerLine == FileHandler::readLedgerHeaderLine();
+    if (used) ciphertext = std::move(result.ciphertext);
+    return used;
+  }
+
+  // Drop a pending read (the profile it was for is being closed)
+  static void discard() {
+    std::future<Prefetched> read;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      read = std::move(pending);
+    }
+    if (read.valid()) read.wait();
+  }
+
+  // Time the last prefetch spent reading and decoding; whether it was used
+  static double getReadMs() { return lastReadMs; }
+  static bool wasUsed() { return used; }
+
+  // Login to first dashboard frame: start when the password is entered,
+  // pause over the welcome message, stop at the first frame
+  static void startLoginClock() {
+    loginMs = 0;
+    loginClockRunning = true;
+    loginClockStarted = Clock::now();
+  }
+
+  static void pauseLoginClock() {
+    if (!loginClockRunning) return;
+    loginMs += msSince(loginClockStarted);
+    loginClockRunning = false;
+  }
+
+  static void resumeLoginClock() {
+    loginClockRunning = true;
+    loginClockStarted = Clock::now();
+  }
+
+  static void stopLoginClock() {
+    if (!loginClockRunning) return;
+    pauseLoginClock();
+    loginToDashboardMs = loginMs;
+  }
+
+  // -1 until a login reached the dashboard
+  static double getLoginToDashboardMs() { return loginToDashboardMs; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Prefetched {
+    bool ok = false;
+    std::string headerLine;
+    std::string ciphertext;
+    double readMs = 0;
+  };
+
+  static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  }
+
+  static inline std::mutex mutex; // guards pending
+  static inline std::future<Prefetched> pending;
+  static inline double lastReadMs = 0;
+  static inline bool used = false;
+
+  static inline bool loginClockRunning = false;
+  static inline Clock::time_point loginClockStarted;
+  static inline double loginMs = 0;
+  static inline double loginToDashboardMs = -1;
+};
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "../include/nlohmann/json.hpp"
+#include "Bm25Retriever.h"
+#include "BudgetManager.h"
+#include "Categorizer.h"
+#include "LedgerIndex.h"
+#include "ToolRegistry.h"
+#include "Transaction.h"
+#include "TransactionManager.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+/**
+ * LedgerTools - ledger queries offered to the model as tools
+ *
+ * HOW IT WORKS:
+ * =============
+ * Instead of uploading the ledger, the chat offers four small queries the
+ * model can call when a question needs numbers:
+ * - sum_transactions: total and count by category, type and date range
+ * - top_expenses: the largest expenses, optionally by category / dates
+ * - budget_status: each budget's limit, spending and percent used
+ * - search_transactions: BM25 search over descriptions, categories, dates
+ *
+ * They run against TransactionManager's in-memory LedgerIndex (bitmap
+ * AND for filters, the sorted date column for ranges) on the worker that
+ * sent the request. The ledger isn't modified while a chat turn is in
+ * flight, so no locking is needed. Dates are "YYYY-MM-DD" or "YYYY-MM"
+ * (a whole month); results are small JSON objects.
+ */
+class LedgerTools {
+public:
+  static constexpr size_t MAX_ROWS = 20;
+
+  // Version of all the data the tools read, for reply cache keys: the
+  // ledger rows, and the budget limits budget_status reports
+  static uint64_t getDataVersion() {
+    return TransactionManager::getDataVersion() ^ BudgetManager::getVersion();
+  }
+
+  static std::shared_ptr<const ToolRegistry> create() {
+    auto tools = std::make_shared<ToolRegistry>();
+    json dateRange = {
+        {"from", {{"type", "string"}, {"description", "First day, YYYY-MM-DD or YYYY-MM"}}},
+        {"to", {{"type", "string"}, {"description", "Last day, YYYY-MM-DD or YYYY-MM"}}}};
+    json category = {{"type", "string"}, {"enum", Categorizer::getCategoryNames()}};
+
+    json sumProperties = dateRange;
+    sumProperties["category"] = category;
+    sumProperties["type"] = {{"type", "string"}, {"enum", {"income", "expense"}}};
+    tools->add("sum_transactions",
+               "Total amount and count of transactions, filtered by category, type "
+               "(default expense) and date range.",
+               {{"type", "object"}, {"properties", sumProperties}}, sumTransactions);
+
+    json topProperties = dateRange;
+    topProperties["category"] = category;
+    topProperties["n"] = {{"type", "integer"}, {"description", "How many (max 20)"}};
+    tools->add("top_expenses", "The largest expenses, optionally by category and date range.",
+               {{"type", "object"}, {"properties", topProperties}}, topExpenses);
+
+    tools->add("budget_status", "Each budget category with its limit, spending and percent used.",
+               {{"type", "object"}, {"properties", json::object()}}, budgetStatus);
+
+    tools->add("search_transactions",
+               "Transactions best matching a text query (merchant, category, month, year).",
+               {{"type", "object"},
+                {"properties",
+                 {{"query", {{"type", "string"}}},
+                  {"k", {{"type", "integer"}, {"description", "How many (max 20)"}}}}},
+                {"required", {"query"}}},
+               searchTransactions);
+    return tools;
+  }
+
+private:
+  static json sumTransactions(const json &arguments) {
+    const LedgerIndex &index = TransactionManager::getIndex();
+    std::string type = arguments.value("type", "expense");
+    RoaringBitmap rows = index.byType(type) & filterRows(index, arguments);
+    return {{"type", type},
+            {"total", roundCents(index.sum(rows))},
+            {"count", rows.cardinality()}};
+  }
+
+  static json topExpenses(const json &arguments) {
+    const LedgerIndex &index = TransactionManager::getIndex();
+    size_t n = std::min<size_t>(std::max(1, arguments.value("n", 5)), MAX_ROWS);
+    std::vector<uint32_t> rows =
+        (index.byType("expense") & filterRows(index, arguments)).toVector();
+
+    auto larger = [&](uint32_t a, uint32_t b) { return index.amountAt(a) > index.amountAt(b); };
+    size_t keep = std::min(n, rows.size());
+    std::partial_sort(rows.begin(), rows.begin() + keep, rows.end(), larger);
+    rows.resize(keep);
+    return {{"expenses", describeRows(rows)}};
+  }
+
+  static json budgetStatus(const json &) {
+    json budgets = json::array();
+    for (const Budget &budget : BudgetManager::getAllBudgets()) {
+      budgets.push_back({{"category", budget.category},
+                         {"limit", roundCents(budget.limit)},
+                         {"spent", roundCents(budget.spent)},
+                         {"percent_used", std::lround(budget.getPercentUsed())},
+                         {"over_budget", budget.isOverBudget()}});
+    }
+    return {{"budgets", budgets}};
+  }
+
+  static json searchTransactions(const json &arguments) {
+    const LedgerIndex &index = TransactionManager::getIndex();
+    size_t k = std::min<size_t>(std::max(1, arguments.value("k", 8)), MAX_ROWS);
+    std::string query = arguments.at("query").get<std::string>();
+    std::vector<uint32_t> rows;
+    for (const auto &hit : Bm25Retriever::search(index, query, k)) rows.push_back(hit.row);
+    return {{"transactions", describeRows(rows)}};
+  }
+
+  // Rows passing the optional category and date range arguments
+  static RoaringBitmap filterRows(const LedgerIndex &index, const json &arguments) {
+    RoaringBitmap rows = index.all();
+    if (arguments.contains("category")) {
+      std::string name = arguments["category"].get<std::string>();
+      if (Categorizer::getCategoryId(name) < 0) {
+        throw std::invalid_argument("unknown category " + name);
+      }
+      rows &= index.byCategory(name);
+    }
+    if (arguments.contains("from") || arguments.contains("to")) {
+      int from = arguments.contains("from") ? parseDay(arguments["from"], false) : 0;
+      int to = arguments.contains("to") ? parseDay(arguments["to"], true) : 99991231;
+      rows &= index.byDateRange(from, to);
+    }
+    return rows;
+  }
+
+  // yyyymmdd key of "YYYY-MM-DD", or of the first / last day of "YYYY-MM"
+  static int parseDay(const json &value, bool endOfMonth) {
+    std::string text = value.get<std::string>();
+    int year = 0, month = 0, day = 0;
+    int fields = std::sscanf(text.c_str(), "%d-%d-%d", &year, &month, &day);
+    if (fields < 2 || month < 1 || month > 12) throw std::invalid_argument("bad date " + text);
+    if (fields == 2) day = endOfMonth ? 31 : 1;
+    return year * 10000 + month * 100 + day;
+  }
+
+  static json describeRows(const std::vector<uint32_t> &rows) {
+    const std::vector<Transaction> &ledger = TransactionManager::getLedger();
+    json list = json::array();
+    for (uint32_t row : rows) {
+      const Transaction &t = ledger[row];
+      list.push_back({{"id", t.getId()},
+                      {"date", t.getDate()},
+                      {"type", t.getType()},
+                      {"amount", roundCents(t.getAmount())},
+                      {"description", t.getDescription()},
+                      {"category", Categorizer::categorize(t.getDescription())}});
+    }
+    return list;
+  }
+
+  static double roundCents(double amount) { return std::round(amount * 100.0) / 100.0; }
+};
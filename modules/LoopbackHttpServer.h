@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/nlohmann/json.hpp"
+#include "HttpClient.h"
+
+/**
+ * LoopbackHttpServer - tiny HTTP/1.1 server on 127.0.0.1
+ *
+ * HOW IT WORKS:
+ * =============
+ * Listens on an ephemeral loopback port and answers every request with
+ * the same canned body, honouring keep-alive. Each connection is served
+ * on its own thread. Used to measure and exercise the HTTP transports
+ * without touching the network or the API.
+ *
+ * With setStream(), requests asking for "stream": true get the given
+ * events instead, as a chunked text/event-stream with a pause before
+ * each event, like a model generating tokens.
+ *
+ * With setResponder(), the server acts as a scripted chat model: each
+ * request's JSON goes to the responder, which returns the assistant
+ * message (text and/or tool_calls). It is sent as a normal completion,
+ * or for "stream": true as chunked deltas, one word or tool call per
+ * event, the way the real API streams them.
+ *
+ * With setFaults(), chosen requests misbehave like a struggling
+ * provider: an error status, a slow answer, a dropped connection, or a
+ * stream that breaks off part way.
+ */
+class LoopbackHttpServer {
+public:
+  explicit LoopbackHttpServer(std::string responseBody)
+      : responseBody(std::move(responseBody)) {}
+
+  ~LoopbackHttpServer() { stop(); }
+
+  bool start() {
+    TcpConnection::startup();
+    listener = TcpConnection(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    if (!listener.isOpen()) return false;
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0; // any free port
+    socklen_t length = sizeof(address);
+    if (bind(listener.getHandle(), reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listener.getHandle(), 16) != 0 ||
+        getsockname(listener.getHandle(), reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+      listener.close();
+      return false;
+    }
+    port = ntohs(address.sin_port);
+
+    running = true;
+    acceptThread = std::thread(&LoopbackHttpServer::acceptLoop, this);
+    return true;
+  }
+
+  void stop() {
+    if (!running.exchange(false)) return;
+
+    // Wake accept() with a throwaway connection, then unblock the readers
+    TcpConnection wake;
+    wake.connect("127.0.0.1", port, 1000);
+    acceptThread.join();
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto &connection : clients) connection->shutdownBoth();
+    }
+    for (auto &worker : workers) worker.join();
+    workers.clear();
+    clients.clear();
+    listener.close();
+  }
+
+  // Events (the data of each "data:" line) for streaming requests
+  void setStream(std::vector<std::string> events, int delayMs) {
+    streamEvents = std::move(events);
+    streamDelayMs = delayMs;
+  }
+
+  // Builds the assistant message answering a request (set before start())
+  using Responder = std::function<nlohmann::json(const nlohmann::json &request)>;
+
+  void setResponder(Responder responder, int delayMs = 0) {
+    this->responder = std::move(responder);
+    streamDelayMs = delayMs;
+  }
+
+  // What goes wrong with one request (the default: nothing)
+  struct Fault {
+    int status = 0;   // answer with this error status instead
+    int delayMs = 0;  // wait this long before answering
+    bool drop = false; // close the connection without answering
+    int cutAfter = -1; // streams: close the connection after this many events
+    bool skipDone = false; // streams: end cleanly but without the [DONE] event
+  };
+
+  // Picks the fault for each request by its number, counting from 1
+  // (set before start())
+  using FaultPlan = std::function<Fault(size_t request)>;
+
+  void setFaults(FaultPlan plan) { faults = std::move(plan); }
+
+  std::string url(const std::string &path = "/") const {
+    return "http://127.0.0.1:" + std::to_string(port) + path;
+  }
+
+  size_t getConnectionCount() const { return connectionCount; }
+  size_t getRequestCount() const { return requestCount; }
+
+private:
+  void acceptLoop() {
+    while (running) {
+      TcpConnection::Handle handle = accept(listener.getHandle(), nullptr, nullptr);
+      if (handle == TcpConnection::INVALID) break;
+      if (!running) {
+        TcpConnection::closeHandle(handle);
+        break;
+      }
+      connectionCount++;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      clients.push_back(std::make_shared<TcpConnection>(handle));
+      workers.emplace_back(&LoopbackHttpServer::serve, this, clients.back());
+    }
+  }
+
+  void serve(std::shared_ptr<TcpConnection> connection) {
+    HttpReader reader(*connection);
+    std::string requestLine;
+    HttpHeaders headers;
+    while (reader.readHead(requestLine, headers)) {
+      std::string body;
+      if (!reader.readBody(headers, body, false)) break;
+      size_t number = ++requestCount;
+
+      bool close = findHeader(headers, "Connection") == "close";
+      Fault fault = faults ? faults(number) : Fault();
+      if (fault.drop || !pause(fault.delayMs)) break;
+      if (fault.status != 0) {
+        std::string error = nlohmann::json{{"error",
+                                            {{"code", fault.status},
+                                             {"message", "Injected fault"}}}}.dump();
+        if (!connection->sendAll("HTTP/1.1 " + std::to_string(fault.status) +
+                                 " Injected Fault\r\nContent-Type: application/json\r\n"
+                                 "Content-Length: " + std::to_string(error.size()) +
+                                 "\r\n\r\n" + error)) {
+          break;
+        }
+        continue;
+      }
+
+      bool stream = body.find("\"stream\":true") != std::string::npos;
+      std::string reply = responseBody;
+      if (responder) {
+        nlohmann::json message = respond(body);
+        if (stream) {
+          if (!sendStream(*connection, toEvents(message), fault) || close) break;
+          continue;
+        }
+        reply = nlohmann::json{{"choices", {{{"message", message}}}}}.dump();
+      } else if (stream && !streamEvents.empty()) {
+        if (!sendStream(*connection, streamEvents, fault) || close) break;
+        continue;
+      }
+
+      std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                             "Content-Length: " + std::to_string(reply.size()) +
+                             (close ? "\r\nConnection: close" : "") + "\r\n\r\n" + reply;
+      if (!connection->sendAll(response) || close) break;
+    }
+    connection->shutdownBoth();
+  }
+
+  // Sleep in short steps so stop() isn't kept waiting; false once stopping
+  bool pause(int ms) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (running && std::chrono::steady_clock::now() < until) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(std::min(ms, 10)));
+    }
+    return running;
+  }
+
+  nlohmann::json respond(const std::string &body) {
+    try {
+      return responder(nlohmann::json::parse(body));
+    } catch (const std::exception &e) {
+      return {{"role", "assistant"}, {"content", std::string("Mock model error: ") + e.what()}};
+    }
+  }
+
+  // Stream chunks of an assistant message: its text word by word, then
+  // each tool call whole
+  static std::vector<std::string> toEvents(const nlohmann::json &message) {
+    std::vector<std::string> events;
+    auto chunk = [](nlohmann::json delta) {
+      return nlohmann::json{{"choices", {{{"delta", std::move(delta)}}}}}.dump();
+    };
+    if (message.contains("content") && message["content"].is_string()) {
+      std::string text = message["content"].get<std::string>();
+      size_t start = 0;
+      while (start < text.size()) {
+        size_t end = text.find(' ', start + 1);
+        if (end == std::string::npos) end = text.size();
+        events.push_back(chunk({{"content", text.substr(start, end - start)}}));
+        start = end;
+      }
+    }
+    if (message.contains("tool_calls")) {
+      size_t index = 0;
+      for (nlohmann::json call : message["tool_calls"]) {
+        call["index"] = index++;
+        events.push_back(chunk({{"tool_calls", {call}}}));
+      }
+    }
+    return events;
+  }
+
+  // False when the connection is to be closed (an error, or cut short)
+  bool sendStream(TcpConnection &connection, const std::vector<std::string> &events,
+                  const Fault &fault) {
+    if (!connection.sendAll("HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                            "Transfer-Encoding: chunked\r\n\r\n")) {
+      return false;
+    }
+    for (size_t i = 0; i < events.size(); i++) {
+      if (fault.cutAfter >= 0 && i == static_cast<size_t>(fault.cutAfter)) return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(streamDelayMs));
+      if (!running || !sendChunk(connection, "data: " + events[i] + "\n\n")) return false;
+    }
+    if (!fault.skipDone && !sendChunk(connection, "data: [DONE]\n\n")) return false;
+    return connection.sendAll("0\r\n\r\n");
+  }
+
+  static bool sendChunk(TcpConnection &connection, const std::string &data) {
+    char size[16];
+    std::snprintf(size, sizeof(size), "%zx\r\n", data.size());
+    return connection.sendAll(size + data + "\r\n");
+  }
+
+  std::string responseBody;
+  std::vector<std::string> streamEvents;
+  Responder responder;
+  FaultPlan faults;
+  int streamDelayMs = 0;
+  TcpConnection listener;
+  int port = 0;
+  std::atomic<bool> running{false};
+  std::atomic<size_t> connectionCount{0};
+  std::atomic<size_t> requestCount{0};
+  std::thread acceptThread;
+  std::mutex mutex; // guards clients and workers
+  std::vector<std::shared_ptr<TcpConnection>> clients;
+  std::vector<std::thread> workers;
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "../include/nlohmann/json.hpp"
+#include "AI.h"
+#include "AuthManager.h"
+#include "FileHandler.h"
+#include "LedgerPrefetch.h"
+#include "TransactionManager.h"
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// One ledger with its own user, password and files
+struct Profile {
+  std::string id;   // folder-safe, unique
+  std::string name; // as shown
+  std::string dir;  // where its files live
+};
+
+/**
+ * ProfileStore - several ledgers side by side, one open at a time
+ *
+ * HOW IT WORKS:
+ * =============
+ * data/profiles.json lists the profiles and which one is active. Each
+ * profile has its own folder, data/profiles/<id>, with its own user,
+ * key, ledger, reply cache and budgets. A data folder from before
+ * profiles has no registry; it becomes the "Default" profile in place,
+ * with data/ as its folder, so nothing is moved.
+ *
+ * FileHandler reads and writes in the active profile's folder, and
+ * everything is loaded lazily from there: the ledger and its indexes on
+ * first use, the reply cache when the AI screen first opens. activate()
+ * logs out and drops all of that (the ledger, indexes, reply cache, a
+ * pending prefetch, the session key) before pointing FileHandler at the
+ * next profile. Only one profile's data is in memory at a time, and
+ * switching needs no restart.
+ */
+class ProfileStore {
+public:
+  static inline const std::string REGISTRY_FILE = FileHandler::DATA_DIR + "/profiles.json";
+  static inline const std::string PROFILES_DIR = FileHandler::DATA_DIR + "/profiles";
+  static inline const std::string DEFAULT_ID = "default";
+
+  // Read the registry and open the active profile's folder (at startup)
+  static void load() {
+    profiles.clear();
+    activeId = DEFAULT_ID;
+    std::ifstream file(REGISTRY_FILE);
+    if (file.is_open()) {
+      try {
+        nlohmann::json j = nlohmann::json::parse(file);
+        for (const auto &entry : j.at("profiles")) {
+          profiles.push_back({entry.at("id").get<std::string>(), entry.at("name").get<std::string>(),
+                              entry.at("dir").get<std::string>()});
+        }
+        activeId = j.value("active", DEFAULT_ID);
+      } catch (const std::exception &e) {
+        std::cerr << "Error reading profile registry: " << e.what() << "\n";
+        profiles.clear();
+      }
+    }
+    if (profiles.empty()) profiles.push_back({DEFAULT_ID, "Default", FileHandler::DATA_DIR});
+    if (!find(activeId)) activeId = profiles.front().id;
+
+    FileHandler::setDataDirectory(find(activeId)->dir);
+    FileHandler::ensureDataDirectory();
+  }
+
+  static const std::vector<Profile> &list() { return profiles; }
+
+  static const Profile &active() {
+    if (profiles.empty()) load();
+    return *find(activeId);
+  }
+
+  // Register a new, empty profile (it is set up when first opened)
+  static bool create(const std::string &name, Profile &created, std::string &error) {
+    if (profiles.empty()) load();
+    std::string trimmed = name;
+    trimmed.erase(0, trimmed.find_first_not_of(' '));
+    trimmed.erase(trimmed.find_last_not_of(' ') + 1);
+    if (trimmed.empty()) {
+      error = "The profile needs a name.";
+      return false;
+    }
+    for (const auto &profile : profiles) {
+      if (lowerCase(profile.name) == lowerCase(trimmed)) {
+        error = "There is already a profile called " + profile.name + ".";
+        return false;
+      }
+    }
+
+    std::string base = slug(trimmed);
+    std::string id = base;
+    for (int n = 2; find(id); n++) id = base + "-" + std::to_string(n);
+    created = {id, trimmed, PROFILES_DIR + "/" + id};
+    FileHandler::ensureDirectory(created.dir);
+    profiles.push_back(created);
+    save();
+    return true;
+  }
+
+  // Close the active profile, dropping its data from memory, and make
+  // another one active. Log in (or set up) afterwards.
+  static bool activate(const std::string &id) {
+    const Profile *next = find(id);
+    if (!next) return false;
+
+    auto started = std::chrono::steady_clock::now();
+    LedgerPrefetch::discard();
+    AIModule::setResponseCache(nullptr);
+    TransactionManager::unload();
+    AuthManager::logout();
+
+    activeId = next->id;
+    FileHandler::setDataDirectory(next->dir);
+    FileHandler::ensureDataDirectory();
+    save();
+    lastSwitchMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                             started)
+                       .count();
+    return true;
+  }
+
+  // How long the last activate() took (-1: no switch this session)
+  static double getLastSwitchMs() { return lastSwitchMs; }
+
+private:
+  static const Profile *find(const std::string &id) {
+    for (const auto &profile : profiles) {
+      if (profile.id == id) return &profile;
+    }
+    return nullptr;
+  }
+
+  static void save() {
+    nlohmann::json j;
+    j["active"] = activeId;
+    j["profiles"] = nlohmann::json::array();
+    for (const auto &profile : profiles) {
+      j["profiles"].push_back({{"id", profile.id}, {"name", profile.name}, {"dir", profile.dir}});
+    }
+    FileHandler::ensureDirectory(FileHandler::DATA_DIR);
+    std::ofstream file(REGISTRY_FILE);
+    if (!file.is_open()) {
+      std::cerr << "Error: Could not write the profile registry.\n";
+      return;
+    }
+    file << j.dump(4);
+  }
+
+  static std::string lowerCase(const std::string &text) {
+    std::string lower = text;
+    for (char &c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return lower;
+  }
+
+  // Folder name for a profile name: letters and digits, dashes between words
+  static std::string slug(const std::string &name) {
+    std::string id;
+    for (unsigned char c : name) {
+      if (std::isalnum(c)) {
+        id += static_cast<char>(std::tolower(c));
+      } else if (!id.empty() && id.back() != '-') {
+        id += '-';
+      }
+    }
+    while (!id.empty() && id.back() == '-') id.pop_back();
+    return id.empty() || id == DEFAULT_ID ? "profile" : id;
+  }
+
+  static inline std::vector<Profile> profiles;
+  static inline std::string activeId = DEFAULT_ID;
+  static inline double lastSwitchMs = -1;
+};
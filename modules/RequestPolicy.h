@@ -0,0 +1,307 @@
+#pragma once
+
+#include "HttpClient.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// How PolicyHttpTransport sends each request
+struct RequestPolicy {
+  int connectTimeoutMs = 10000;
+  int readTimeoutMs = 30000; // longest silence from the server before giving up on it
+  int maxAttempts = 3;       // the first try included
+  int backoffBaseMs = 250;   // wait before the first retry, doubled for each next one
+  int backoffMaxMs = 4000;
+  bool hedge = false;    // send a duplicate when the first is slow
+  int hedgeDelayMs = 0;  // when to send it; 0 = the p95 time to a response
+};
+
+/**
+ * PolicyHttpTransport - retries, deadlines and hedging around a transport
+ *
+ * HOW IT WORKS:
+ * =============
+ * Wraps another HttpTransport and sends each request under a
+ * RequestPolicy:
+ *
+ * - Deadlines: the connect and read timeouts go to the inner transport
+ *   (a server that goes quiet for readTimeoutMs fails the attempt) and
+ *   every attempt gets what is left of the caller's overall time limit.
+ *
+ * - Retries: transient failures (no connection, a reset, a stall) and
+ *   408 / 429 / 5xx responses are tried again, up to maxAttempts, after an exponential backoff with
+ *   jitter (a random wait between half and all of base * 2^retry, capped),
+ *   so many clients don't retry in lockstep. The body of an error that
+ *   will be retried is held back; once any of a reply has reached the
+ *   caller it is never retried (tokens can't be taken back). Setup
+ *   errors, such as a malformed URL or an unsupported scheme, fail at once.
+ *
+ * - Hedging (optional): if no response head has arrived after the hedge
+ *   delay, a duplicate request is sent on a second connection. Whichever
+ *   answers first is streamed to the caller and the other is cancelled.
+ *   The delay defaults to the p95 of recent response times, so only the
+ *   slowest ~5% of requests cost a second one. Duplicates are billed by
+ *   paid APIs, which is why hedging is off by default.
+ */
+class PolicyHttpTransport : public HttpTransport {
+public:
+  static constexpr int DEFAULT_TIMEOUT_MS = 60000;
+  static constexpr size_t LATENCY_SAMPLES = 64;
+  static constexpr size_t MIN_HEDGE_SAMPLES = 10; // no p95 hedging before this many
+
+  explicit PolicyHttpTransport(std::shared_ptr<HttpTransport> inner,
+                               RequestPolicy policy = RequestPolicy())
+      : inner(std::move(inner)), policy(policy) {}
+
+  const char *name() const override { return inner->name(); }
+
+  void setPolicy(const RequestPolicy &replacement) {
+    std::lock_guard<std::mutex> lock(mutex);
+    policy = replacement;
+  }
+
+  RequestPolicy getPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return policy;
+  }
+
+  // Delay before a hedge is sent (-1: hedging off or too few samples yet)
+  double getHedgeDelayMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hedgeDelayLocked();
+  }
+
+  size_t getRetries() const { return retries; }
+  size_t getHedgesSent() const { return hedgesSent; }
+  size_t getHedgesWon() const { return hedgesWon; }
+
+  using HttpTransport::post;
+  HttpResponse post(const std::string &url, const HttpHeaders &headers,
+                    const std::string &body, const HttpRequestOptions &options) override {
+    RequestPolicy current = getPolicy();
+    int limitMs = options.timeoutMs > 0 ? options.timeoutMs : DEFAULT_TIMEOUT_MS;
+    auto started = Clock::now();
+    auto remainingMs = [&] {
+      return limitMs - static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                            Clock::now() - started)
+                                            .count());
+    };
+
+    HttpResponse response;
+    int sent = 0;
+    bool held = false; // the last attempt's body is in response.body
+    for (int attempt = 1;; attempt++) {
+      bool lastAttempt = attempt >= current.maxAttempts;
+      bool delivered = false; // body bytes reached the caller
+      held = false;
+
+      HttpRequestOptions attemptOptions = options;
+      attemptOptions.timeoutMs = std::max(1, remainingMs());
+      if (attemptOptions.connectTimeoutMs <= 0) {
+        attemptOptions.connectTimeoutMs = current.connectTimeoutMs;
+      }
+      if (attemptOptions.readTimeoutMs <= 0) attemptOptions.readTimeoutMs = current.readTimeoutMs;
+      attemptOptions.onStatus = [&](int status) {
+        bool stream = lastAttempt || !isRetryableStatus(status); // hold back what we retry
+        if (options.onStatus) stream = options.onStatus(status) && stream;
+        held = !stream;
+        return stream;
+      };
+      if (options.onBody) {
+        attemptOptions.onBody = [&](const char *data, size_t size) {
+          delivered = true;
+          return options.onBody(data, size);
+        };
+      }
+
+      response = current.hedge ? sendHedged(url, headers, body, attemptOptions, sent)
+                               : sendTimed(url, headers, body, attemptOptions, sent);
+
+      if (response.cancelled || (options.cancel && options.cancel->isCancelled())) break;
+      if (delivered || lastAttempt) break;
+      bool retryable = response.error.empty() ? isRetryableStatus(response.status)
+                                              : response.transient;
+      if (!retryable) break;
+
+      int waitMs = backoffMs(current, attempt);
+      if (remainingMs() <= waitMs) break; // no time left for another try
+      if (!sleepUnlessCancelled(waitMs, options.cancel)) {
+        response.cancelled = true;
+        response.error = "Request cancelled";
+        break;
+      }
+      retries++;
+    }
+
+    // The final answer was an error held back for a retry: hand it over
+    if (held && options.onBody && !response.body.empty()) {
+      options.onBody(response.body.data(), response.body.size());
+      response.body.clear();
+    }
+    response.attempts = sent;
+    return response;
+  }
+
+  static bool isRetryableStatus(int status) {
+    return status == 408 || status == 429 || status >= 500;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  // Two copies of one request racing for the first response head
+  struct Race {
+    std::mutex mutex;
+    std::condition_variable changed;
+    int winner = -1;
+    bool done[2] = {false, false};
+    HttpResponse responses[2];
+    HttpCancelToken cancels[2];
+  };
+
+  // One request, its time to a response head recorded for the p95
+  HttpResponse sendTimed(const std::string &url, const HttpHeaders &headers,
+                         const std::string &body, const HttpRequestOptions &options, int &sent) {
+    HttpRequestOptions timed = options;
+    auto started = Clock::now();
+    timed.onStatus = [&](int status) {
+      recordLatency(msSince(started));
+      return options.onStatus ? options.onStatus(status) : true;
+    };
+    sent++;
+    return inner->post(url, headers, body, timed);
+  }
+
+  HttpResponse sendHedged(const std::string &url, const HttpHeaders &headers,
+                          const std::string &body, const HttpRequestOptions &options,
+                          int &sent) {
+    double delayMs = getHedgeDelayMs();
+    if (delayMs < 0) return sendTimed(url, headers, body, options, sent);
+
+    auto race = std::make_shared<Race>();
+    auto runLeg = [&, race](int leg) {
+      HttpRequestOptions legOptions = options;
+      legOptions.cancel = &race->cancels[leg];
+      auto started = Clock::now();
+      // Only the winner's status and body reach the caller's callbacks
+      legOptions.onStatus = [&, race, leg, started](int status) {
+        bool won;
+        {
+          std::lock_guard<std::mutex> lock(race->mutex);
+          if (race->winner < 0) race->winner = leg;
+          won = race->winner == leg;
+        }
+        race->changed.notify_all();
+        if (!won) return false;
+        race->cancels[1 - leg].cancel(); // the other copy lost
+        recordLatency(msSince(started));
+        return options.onStatus ? options.onStatus(status) : true;
+      };
+      HttpResponse response = inner->post(url, headers, body, legOptions);
+      {
+        std::lock_guard<std::mutex> lock(race->mutex);
+        race->responses[leg] = std::move(response);
+        race->done[leg] = true;
+      }
+      race->changed.notify_all();
+    };
+
+    if (options.cancel) {
+      options.cancel->setAbortAction([race] {
+        race->cancels[0].cancel();
+        race->cancels[1].cancel();
+      });
+    }
+    sent++;
+    std::thread first(runLeg, 0);
+    std::thread second;
+    {
+      std::unique_lock<std::mutex> lock(race->mutex);
+      race->changed.wait_for(lock, std::chrono::duration<double, std::milli>(delayMs),
+                             [&] { return race->winner >= 0 || race->done[0]; });
+      bool cancelled = options.cancel && options.cancel->isCancelled();
+      if (race->winner < 0 && !race->done[0] && !cancelled) {
+        sent++;
+        hedgesSent++;
+        second = std::thread(runLeg, 1);
+      }
+      bool hedged = second.joinable();
+      race->changed.wait(lock, [&] {
+        if (race->winner >= 0) return race->done[race->winner];
+        return race->done[0] && (!hedged || race->done[1]);
+      });
+    }
+    if (options.cancel) options.cancel->setAbortAction(nullptr);
+    race->cancels[0].cancel(); // stop the loser if it is still going
+    race->cancels[1].cancel();
+    first.join();
+    if (second.joinable()) second.join();
+
+    if (race->winner == 1) hedgesWon++;
+    HttpResponse result = race->responses[race->winner == 1 ? 1 : 0];
+    if (race->winner < 0 && race->done[1] && race->responses[0].cancelled) {
+      result = race->responses[1];
+    }
+    return result;
+  }
+
+  // Equal jitter: a random wait between half and all of the capped backoff
+  static int backoffMs(const RequestPolicy &current, int attempt) {
+    long long full = static_cast<long long>(current.backoffBaseMs) << std::min(attempt - 1, 20);
+    int capped = static_cast<int>(std::min<long long>(full, current.backoffMaxMs));
+    thread_local std::mt19937 random{std::random_device{}()};
+    return std::uniform_int_distribution<int>(capped / 2, std::max(capped / 2, capped))(random);
+  }
+
+  // False if the cancel token fired while waiting
+  static bool sleepUnlessCancelled(int ms, HttpCancelToken *cancel) {
+    auto until = Clock::now() + std::chrono::milliseconds(ms);
+    while (Clock::now() < until) {
+      if (cancel && cancel->isCancelled()) return false;
+      std::this_thread::sleep_for(std::min<Clock::duration>(std::chrono::milliseconds(10),
+                                                            until - Clock::now()));
+    }
+    return !(cancel && cancel->isCancelled());
+  }
+
+  static double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  }
+
+  void recordLatency(double ms) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (latencies.size() < LATENCY_SAMPLES) {
+      latencies.push_back(ms);
+    } else {
+      latencies[nextSample] = ms;
+    }
+    nextSample = (nextSample + 1) % LATENCY_SAMPLES;
+  }
+
+  double hedgeDelayLocked() const {
+    if (!policy.hedge) return -1;
+    if (policy.hedgeDelayMs > 0) return policy.hedgeDelayMs;
+    if (latencies.size() < MIN_HEDGE_SAMPLES) return -1;
+    std::vector<double> sorted = latencies;
+    size_t p95 = (sorted.size() * 95 + 99) / 100 - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + p95, sorted.end());
+    return sorted[p95];
+  }
+
+  std::shared_ptr<HttpTransport> inner;
+  mutable std::mutex mutex; // guards policy and latencies
+  RequestPolicy policy;
+  std::vector<double> latencies; // ms to a response head, the last LATENCY_SAMPLES
+  size_t nextSample = 0;
+  std::atomic<size_t> retries{0};
+  std::atomic<size_t> hedgesSent{0};
+  std::atomic<size_t> hedgesWon{0};
+};
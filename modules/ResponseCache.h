@@ -0,0 +1,206 @@
+#pragma once
+
+#include "../include/nlohmann/json.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * ResponseCache - least-recently-used cache of AI replies
+ *
+ * HOW IT WORKS:
+ * =============
+ * The key is a 64-bit FNV-1a hash of the model and the normalized
+ * conversation (case, spacing and trailing punctuation don't matter)
+ * followed by the ledger's data version, so a repeated question is only
+ * answered from the cache while the data it was asked about is unchanged.
+ *
+ * Entries live in a list ordered from most to least recently used, with a
+ * hash map from key to list position: lookups, inserts and moving a hit to
+ * the front are O(1). Once the entry count or the total reply size passes
+ * its cap, entries are evicted from the back.
+ *
+ * The cache is thread safe (background requests store replies into it).
+ * After every change the whole cache is handed to the save callback as
+ * JSON, which is how it reaches the encrypted file on disk.
+ */
+class ResponseCache {
+public:
+  using SaveCallback = std::function<void(const nlohmann::json &entries)>;
+
+  static constexpr size_t DEFAULT_MAX_ENTRIES = 200;
+  static constexpr size_t DEFAULT_MAX_BYTES = 256 * 1024;
+
+  explicit ResponseCache(size_t maxEntries = DEFAULT_MAX_ENTRIES,
+                         size_t maxBytes = DEFAULT_MAX_BYTES, SaveCallback save = nullptr)
+      : maxEntries(maxEntries), maxBytes(maxBytes), save(std::move(save)) {}
+
+  // Cache key of a conversation (the messages about to be sent)
+  static std::string makeKey(const std::string &model, const nlohmann::json &messages,
+                             uint64_t dataVersion) {
+    uint64_t hash = FNV_OFFSET;
+    hashText(hash, model);
+    for (const auto &message : messages) {
+      hashText(hash, message.value("role", ""));
+      std::string content =
+          message.contains("content") && message["content"].is_string()
+              ? message["content"].get<std::string>()
+              : std::string();
+      hashText(hash, normalize(content));
+    }
+    return toHex(hash) + "-" + toHex(dataVersion);
+  }
+
+  // Lower-cased, whitespace collapsed, trailing "?!." dropped
+  static std::string normalize(const std::string &text) {
+    std::string result;
+    result.reserve(text.size());
+    bool space = false;
+    for (unsigned char c : text) {
+      if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        space = !result.empty();
+        continue;
+      }
+      if (space) result += ' ';
+      space = false;
+      result += static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+    }
+    while (!result.empty() &&
+           (result.back() == '?' || result.back() == '!' || result.back() == '.' ||
+            result.back() == ' ')) {
+      result.pop_back();
+    }
+    return result;
+  }
+
+  // Counts a hit or a miss; a hit becomes the most recently used entry
+  bool get(const std::string &key, std::string &reply) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+      misses++;
+      return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    reply = it->second->second;
+    hits++;
+    return true;
+  }
+
+  void put(const std::string &key, const std::string &reply) {
+    std::lock_guard<std::mutex> saving(saveMutex); // snapshots reach disk in order
+    nlohmann::json snapshot;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (reply.size() > maxBytes) return;
+      auto it = index.find(key);
+      if (it != index.end()) {
+        bytes -= it->second->second.size();
+        entries.erase(it->second);
+      }
+      entries.emplace_front(key, reply);
+      index[key] = entries.begin();
+      bytes += reply.size();
+      evict();
+      if (save) snapshot = toJsonLocked();
+    }
+    if (save) save(snapshot);
+  }
+
+  // Replace the contents with saved entries (most recently used first)
+  void load(const nlohmann::json &saved) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    index.clear();
+    bytes = 0;
+    if (!saved.is_array()) return;
+    for (const auto &entry : saved) {
+      if (!entry.is_array() || entry.size() != 2 || !entry[0].is_string() ||
+          !entry[1].is_string()) {
+        continue;
+      }
+      std::string key = entry[0].get<std::string>();
+      if (index.count(key)) continue;
+      entries.emplace_back(key, entry[1].get<std::string>());
+      index[key] = std::prev(entries.end());
+      bytes += entries.back().second.size();
+    }
+    evict();
+  }
+
+  nlohmann::json toJson() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return toJsonLocked();
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+
+  size_t getBytes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+  }
+
+  size_t getHits() const { return hits; }
+  size_t getMisses() const { return misses; }
+
+  // Share of lookups answered from the cache (0 before the first lookup)
+  double getHitRate() const {
+    size_t lookups = hits + misses;
+    return lookups == 0 ? 0.0 : static_cast<double>(hits) / lookups;
+  }
+
+private:
+  using Entry = std::pair<std::string, std::string>; // key, reply
+
+  static constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+  static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+  // Text plus a terminator, so "ab"+"c" and "a"+"bc" hash differently
+  static void hashText(uint64_t &hash, const std::string &text) {
+    for (unsigned char c : text) {
+      hash = (hash ^ c) * FNV_PRIME;
+    }
+    hash = (hash ^ 0xFF) * FNV_PRIME;
+  }
+
+  static std::string toHex(uint64_t value) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+    return text;
+  }
+
+  void evict() {
+    while (!entries.empty() && (entries.size() > maxEntries || bytes > maxBytes)) {
+      bytes -= entries.back().second.size();
+      index.erase(entries.back().first);
+      entries.pop_back();
+    }
+  }
+
+  nlohmann::json toJsonLocked() const {
+    nlohmann::json saved = nlohmann::json::array();
+    for (const auto &entry : entries) saved.push_back({entry.first, entry.second});
+    return saved;
+  }
+
+  size_t maxEntries;
+  size_t maxBytes;
+  SaveCallback save;
+  std::mutex saveMutex;
+  std::mutex mutex; // guards entries, index and bytes
+  std::list<Entry> entries; // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+  size_t bytes = 0; // reply text held
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include "LedgerIndex.h"
+#include "RoaringBitmap.h"
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Income / expense totals of a result set
+struct ResultTotals
+{
+  double income = 0.0;
+  double expenses = 0.0;
+
+  double net() const { return income - expenses; }
+};
+
+/**
+ * ResultCursor - lightweight handle on a filtered result set
+ *
+ * Holds ledger row ids only, never Transaction copies. "All rows" results
+ * are kept as a lazy range, so even an unfiltered 1M-row result costs
+ * nothing to create. Screens pull one page of rows at a time.
+ */
+class ResultCursor
+{
+public:
+  // Every ledger row in [0, count)
+  static ResultCursor allRows(uint32_t count)
+  {
+    ResultCursor cursor;
+    cursor.isRange = true;
+    cursor.rangeSize = count;
+    return cursor;
+  }
+
+  static ResultCursor fromBitmap(const RoaringBitmap &rows)
+  {
+    return fromRows(rows.toVector());
+  }
+
+  // Rows in display order (e.g. ranked hits)
+  static ResultCursor fromRows(vector<uint32_t> rows)
+  {
+    ResultCursor cursor;
+    cursor.rows = std::move(rows);
+    return cursor;
+  }
+
+  size_t size() const { return isRange ? rangeSize : rows.size(); }
+  bool empty() const { return size() == 0; }
+
+  // Ledger row of the i-th result
+  uint32_t rowAt(size_t i) const
+  {
+    return isRange ? static_cast<uint32_t>(i) : rows[i];
+  }
+
+  size_t pageCount(size_t pageSize) const
+  {
+    return (size() + pageSize - 1) / pageSize;
+  }
+
+  // Totals in one tight pass over the index columns
+  ResultTotals computeTotals(const LedgerIndex &index) const
+  {
+    ResultTotals totals;
+    if (isRange && rangeSize == index.size())
+    {
+      totals.income = index.getTotalIncome();
+      totals.expenses = index.getTotalExpenses();
+      return totals;
+    }
+
+    for (size_t i = 0; i < size(); i++)
+    {
+      uint32_t row = rowAt(i);
+      LedgerIndex::TypeCode type = index.typeAt(row);
+      if (type == LedgerIndex::TYPE_INCOME)
+        totals.income += index.amountAt(row);
+      else if (type == LedgerIndex::TYPE_EXPENSE)
+        totals.expenses += index.amountAt(row);
+    }
+    return totals;
+  }
+
+private:
+  bool isRange = false;
+  uint32_t rangeSize = 0;
+  vector<uint32_t> rows;
+};
@@ -0,0 +1,285 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/**
+ * RoaringBitmap - compressed set of 32-bit row ids
+ *
+ * Row ids are split into a 16-bit high key and a 16-bit low value. Each high
+ * key owns one container holding the low values of that 65536-row chunk:
+ * - sparse chunks (<= 4096 values) use a sorted array of uint16_t
+ * - dense chunks use a 65536-bit bitset (1024 x uint64_t)
+ *
+ * This keeps sparse sets small and makes AND / OR on dense sets a word-wise
+ * operation. Cardinality is tracked per container, so counting is O(chunks).
+ */
+class RoaringBitmap {
+public:
+  // Add a row id (appending in increasing order is the fast path)
+  void add(uint32_t value) {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+
+    Container *c = nullptr;
+    if (!containers.empty() && containers.back().key == key) {
+      c = &containers.back();
+    } else {
+      auto it = lowerBound(key);
+      if (it == containers.end() || it->key != key) {
+        Container fresh;
+        fresh.key = key;
+        it = containers.insert(it, fresh);
+      }
+      c = &*it;
+    }
+    c->add(low);
+  }
+
+  bool contains(uint32_t value) const {
+    uint16_t key = static_cast<uint16_t>(value >> 16);
+    auto it = std::lower_bound(
+        containers.begin(), containers.end(), key,
+        [](const Container &c, uint16_t k) { return c.key < k; });
+    if (it == containers.end() || it->key != key) return false;
+    return it->contains(static_cast<uint16_t>(value & 0xFFFF));
+  }
+
+  uint64_t cardinality() const {
+    uint64_t total = 0;
+    for (const auto &c : containers) total += c.card;
+    return total;
+  }
+
+  bool empty() const { return containers.empty(); }
+
+  void clear() { containers.clear(); }
+
+  // Bitmap holding every row id in [0, count)
+  static RoaringBitmap range(uint32_t count) { return range(0, count); }
+
+  // Bitmap holding every row id in [first, last)
+  static RoaringBitmap range(uint32_t first, uint32_t last) {
+    RoaringBitmap result;
+    for (uint64_t start = first; start < last; start = (start | 0xFFFF) + 1) {
+      uint32_t low = static_cast<uint32_t>(start & 0xFFFF);
+      uint32_t n = static_cast<uint32_t>(std::min<uint64_t>(last - start, 65536 - low));
+      Container c;
+      c.key = static_cast<uint16_t>(start >> 16);
+      if (n <= ARRAY_LIMIT) {
+        c.array.resize(n);
+        for (uint32_t i = 0; i < n; i++) c.array[i] = static_cast<uint16_t>(low + i);
+      } else {
+        c.isBitset = true;
+        c.bits.assign(BITSET_WORDS, 0);
+        for (uint32_t i = low; i < low + n; i++) c.bits[i / 64] |= 1ULL << (i % 64);
+      }
+      c.card = n;
+      result.containers.push_back(std::move(c));
+    }
+    return result;
+  }
+
+  // Intersection
+  RoaringBitmap operator&(const RoaringBitmap &other) const {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < containers.size() && j < other.containers.size()) {
+      const Container &a = containers[i];
+      const Container &b = other.containers[j];
+      if (a.key < b.key) {
+        i++;
+      } else if (b.key < a.key) {
+        j++;
+      } else {
+        Container c = Container::intersect(a, b);
+        if (c.card > 0) result.containers.push_back(std::move(c));
+        i++;
+        j++;
+      }
+    }
+    return result;
+  }
+
+  // Union
+  RoaringBitmap operator|(const RoaringBitmap &other) const {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < containers.size() || j < other.containers.size()) {
+      if (j >= other.containers.size() ||
+          (i < containers.size() && containers[i].key < other.containers[j].key)) {
+        result.containers.push_back(containers[i++]);
+      } else if (i >= containers.size() ||
+                 other.containers[j].key < containers[i].key) {
+        result.containers.push_back(other.containers[j++]);
+      } else {
+        result.containers.push_back(
+            Container::unite(containers[i], other.containers[j]));
+        i++;
+        j++;
+      }
+    }
+    return result;
+  }
+
+  RoaringBitmap &operator&=(const RoaringBitmap &other) {
+    *this = *this & other;
+    return *this;
+  }
+
+  RoaringBitmap &operator|=(const RoaringBitmap &other) {
+    *this = *this | other;
+    return *this;
+  }
+
+  // Visit row ids in increasing order
+  template <typename Fn> void forEach(Fn fn) const {
+    for (const auto &c : containers) {
+      uint32_t high = static_cast<uint32_t>(c.key) << 16;
+      if (c.isBitset) {
+        for (size_t w = 0; w < BITSET_WORDS; w++) {
+          uint64_t word = c.bits[w];
+          while (word) {
+            int bit = __builtin_ctzll(word);
+            fn(high | static_cast<uint32_t>(w * 64 + bit));
+            word &= word - 1;
+          }
+        }
+      } else {
+        for (uint16_t low : c.array) fn(high | low);
+      }
+    }
+  }
+
+  std::vector<uint32_t> toVector() const {
+    std::vector<uint32_t> rows;
+    rows.reserve(static_cast<size_t>(cardinality()));
+    forEach([&rows](uint32_t row) { rows.push_back(row); });
+    return rows;
+  }
+
+private:
+  static constexpr uint32_t ARRAY_LIMIT = 4096;
+  static constexpr size_t BITSET_WORDS = 1024;
+
+  struct Container {
+    uint16_t key = 0;
+    bool isBitset = false;
+    uint32_t card = 0;
+    std::vector<uint16_t> array; // sorted, used while !isBitset
+    std::vector<uint64_t> bits;  // 1024 words, used while isBitset
+
+    bool contains(uint16_t low) const {
+      if (isBitset) return (bits[low >> 6] >> (low & 63)) & 1ULL;
+      return std::binary_search(array.begin(), array.end(), low);
+    }
+
+    void add(uint16_t low) {
+      if (isBitset) {
+        uint64_t mask = 1ULL << (low & 63);
+        if (!(bits[low >> 6] & mask)) {
+          bits[low >> 6] |= mask;
+          card++;
+        }
+        return;
+      }
+      if (array.empty() || array.back() < low) {
+        array.push_back(low);
+      } else {
+        auto it = std::lower_bound(array.begin(), array.end(), low);
+        if (it != array.end() && *it == low) return;
+        array.insert(it, low);
+      }
+      card++;
+      if (card > ARRAY_LIMIT) toBitset();
+    }
+
+    void toBitset() {
+      bits.assign(BITSET_WORDS, 0);
+      for (uint16_t low : array) bits[low >> 6] |= 1ULL << (low & 63);
+      array.clear();
+      array.shrink_to_fit();
+      isBitset = true;
+    }
+
+    void toArray() {
+      array.clear();
+      array.reserve(card);
+      for (size_t w = 0; w < BITSET_WORDS; w++) {
+        uint64_t word = bits[w];
+        while (word) {
+          array.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+          word &= word - 1;
+        }
+      }
+      bits.clear();
+      bits.shrink_to_fit();
+      isBitset = false;
+    }
+
+    static Container intersect(const Container &a, const Container &b) {
+      Container out;
+      out.key = a.key;
+      if (a.isBitset && b.isBitset) {
+        out.isBitset = true;
+        out.bits.resize(BITSET_WORDS);
+        uint32_t card = 0;
+        for (size_t w = 0; w < BITSET_WORDS; w++) {
+          out.bits[w] = a.bits[w] & b.bits[w];
+          card += static_cast<uint32_t>(__builtin_popcountll(out.bits[w]));
+        }
+        out.card = card;
+        if (card <= ARRAY_LIMIT) out.toArray();
+      } else if (a.isBitset || b.isBitset) {
+        const Container &arr = a.isBitset ? b : a;
+        const Container &set = a.isBitset ? a : b;
+        for (uint16_t low : arr.array) {
+          if ((set.bits[low >> 6] >> (low & 63)) & 1ULL) out.array.push_back(low);
+        }
+        out.card = static_cast<uint32_t>(out.array.size());
+      } else {
+        out.array.reserve(std::min(a.array.size(), b.array.size()));
+        std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(),
+                              b.array.end(), std::back_inserter(out.array));
+        out.card = static_cast<uint32_t>(out.array.size());
+      }
+      return out;
+    }
+
+    static Container unite(const Container &a, const Container &b) {
+      Container out;
+      out.key = a.key;
+      if (!a.isBitset && !b.isBitset) {
+        out.array.reserve(a.array.size() + b.array.size());
+        std::set_union(a.array.begin(), a.array.end(), b.array.begin(),
+                       b.array.end(), std::back_inserter(out.array));
+        out.card = static_cast<uint32_t>(out.array.size());
+        if (out.card > ARRAY_LIMIT) out.toBitset();
+        return out;
+      }
+      out.isBitset = true;
+      out.bits.assign(BITSET_WORDS, 0);
+      for (const Container *c : {&a, &b}) {
+        if (c->isBitset) {
+          for (size_t w = 0; w < BITSET_WORDS; w++) out.bits[w] |= c->bits[w];
+        } else {
+          for (uint16_t low : c->array) out.bits[low >> 6] |= 1ULL << (low & 63);
+        }
+      }
+      uint32_t card = 0;
+      for (uint64_t word : out.bits)
+        card += static_cast<uint32_t>(__builtin_popcountll(word));
+      out.card = card;
+      return out;
+    }
+  };
+
+  std::vector<Container> containers; // sorted by key
+
+  std::vector<Container>::iterator lowerBound(uint16_t key) {
+    return std::lower_bound(
+        containers.begin(), containers.end(), key,
+        [](const Container &c, uint16_t k) { return c.key < k; });
+  }
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Sha256.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+/**
+ * SessionKey - the data key, derived from the password once per login
+ *
+ * HOW IT WORKS:
+ * =============
+ * The password is stretched with PBKDF2-HMAC-SHA256 (RFC 8018): a random
+ * salt and an iteration count make every guess at the password cost as
+ * much as a login does. The count is picked when the key is first made,
+ * by timing a short probe run, so derivation takes about
+ * TARGET_DERIVE_MS on this machine. The salt, the count and a check value
+ * (a MAC that only the right key produces) are stored next to the data;
+ * none of them reveals the key.
+ *
+ * From the derived key, KEYSTREAM_BYTES of keystream are expanded once
+ * (HMAC of a block counter) and kept for the session. Encrypting and
+ * decrypting then borrow the key by reference: no password copies and
+ * no per-operation key setup. The key material is wiped when the last
+ * reference goes.
+ */
+class SessionKey {
+public:
+  static constexpr size_t KEY_BYTES = Sha256::DIGEST_BYTES;
+  static constexpr size_t SALT_BYTES = 16;
+  static constexpr size_t KEYSTREAM_BYTES = 4096; // a power of two: offsets wrap with a mask
+  static constexpr double TARGET_DERIVE_MS = 250;
+  static constexpr int MIN_ITERATIONS = 10000;
+  static constexpr int MAX_ITERATIONS = 10000000;
+
+  // What it takes to derive the key again (stored in the clear)
+  struct Params {
+    std::string salt;  // hex
+    int iterations = 0;
+    std::string check; // hex MAC showing a password derives the right key
+  };
+
+  SessionKey() = default; // no key: encryption passes data through
+  SessionKey(const SessionKey &) = delete;
+  SessionKey &operator=(const SessionKey &) = delete;
+
+  ~SessionKey() {
+    wipe(key);
+    wipe(keystream);
+  }
+
+  // The key for a password and stored parameters
+  static std::shared_ptr<const SessionKey> derive(const std::string &password,
+                                                  const std::string &salt, int iterations) {
+    auto started = std::chrono::steady_clock::now();
+    std::shared_ptr<SessionKey> derived(new SessionKey());
+    derived->salt = salt;
+    derived->iterations = iterations;
+    derived->key = pbkdf2(password, salt, iterations, KEY_BYTES);
+    derived->expand();
+    derived->deriveMs = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - started)
+                            .count();
+    return derived;
+  }
+
+  // A new key for a password: fresh salt, iterations calibrated to this machine
+  static std::shared_ptr<const SessionKey> create(const std::string &password) {
+    return derive(password, randomSalt(), calibrateIterations(TARGET_DERIVE_MS));
+  }
+
+  bool isValid() const { return !keystream.empty(); }
+
+  // Constant-time comparison with a stored check value
+  bool matches(const std::string &check) const {
+    std::string mine = getCheckValue();
+    if (check.size() != mine.size()) return false;
+    unsigned char difference = 0;
+    for (size_t i = 0; i < mine.size(); i++) difference |= mine[i] ^ check[i];
+    return difference == 0;
+  }
+
+  std::string getCheckValue() const {
+    Sha256::Digest check = Hmac(key).mac(std::string("key check"));
+    return Sha256::toHex(check.data(), check.size());
+  }
+
+  Params getParams() const { return {salt, iterations, getCheckValue()}; }
+
+  const std::string &getKeystream() const { return keystream; }
+  int getIterations() const { return iterations; }
+  double getDeriveMs() const { return deriveMs; }
+
+  // PBKDF2-HMAC-SHA256: length bytes stretched from password and salt
+  static std::string pbkdf2(const std::string &password, const std::string &salt,
+                            int iterations, size_t length) {
+    Hmac prf(password);
+    std::string derived;
+    for (uint32_t block = 1; derived.size() < length; block++) {
+      std::string first = salt;
+      for (int shift = 24; shift >= 0; shift -= 8) first += static_cast<char>(block >> shift);
+      Sha256::Digest u = prf.mac(first);
+      Sha256::Digest t = u;
+      for (int i = 1; i < iterations; i++) {
+        u = prf.mac(u.data(), u.size());
+        for (size_t b = 0; b < t.size(); b++) t[b] ^= u[b];
+      }
+      derived.append(reinterpret_cast<const char *>(t.data()),
+                     std::min(t.size(), length - derived.size()));
+    }
+    return derived;
+  }
+
+  // Iterations that take about targetMs here, from a timed probe run
+  static int calibrateIterations(double targetMs) {
+    const int probe = 5000;
+    auto started = std::chrono::steady_clock::now();
+    pbkdf2("calibration", "calibration", probe, KEY_BYTES);
+    double probeMs = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - started)
+                         .count();
+    double iterations = probe * targetMs / std::max(probeMs, 0.001);
+    return static_cast<int>(
+        std::clamp(iterations, static_cast<double>(MIN_ITERATIONS),
+                   static_cast<double>(MAX_ITERATIONS)));
+  }
+
+private:
+  static std::string randomSalt() {
+    std::random_device random;
+    uint8_t bytes[SALT_BYTES];
+    for (auto &byte : bytes) byte = static_cast<uint8_t>(random());
+    return Sha256::toHex(bytes, sizeof(bytes));
+  }
+
+  // Keystream block n = HMAC(key, "keystream" || n)
+  void expand() {
+    Hmac prf(key);
+    keystream.reserve(KEYSTREAM_BYTES);
+    for (uint32_t block = 0; keystream.size() < KEYSTREAM_BYTES; block++) {
+      std::string input = "keystream";
+      for (int shift = 24; shift >= 0; shift -= 8) input += static_cast<char>(block >> shift);
+      Sha256::Digest bytes = prf.mac(input);
+      keystream.append(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+    }
+  }
+
+  static void wipe(std::string &secret) {
+    volatile char *bytes = &secret[0];
+    for (size_t i = 0; i < secret.size(); i++) bytes[i] = 0;
+  }
+
+  std::string key;
+  std::string keystream;
+  std::string salt;
+  int iterations = 0;
+  double deriveMs = 0;
+};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * Sha256 - SHA-256 and HMAC-SHA256 (FIPS 180-4, RFC 2104)
+ *
+ * HOW IT WORKS:
+ * =============
+ * Input is buffered into 64-byte blocks; each block runs the 64-round
+ * compression function on the eight-word state. finish() appends the
+ * padding (0x80, zeros, the bit length) and returns the 32-byte digest.
+ *
+ * Hmac keeps the hash states after the key's inner and outer pads have
+ * been absorbed. Every MAC then starts from copies of those states, so a
+ * MAC of a short message costs two compressions instead of four - the
+ * saving PBKDF2 relies on, as it computes thousands of MACs with one key.
+ */
+class Sha256 {
+public:
+  static constexpr size_t DIGEST_BYTES = 32;
+  static constexpr size_t BLOCK_BYTES = 64;
+  using Digest = std::array<uint8_t, DIGEST_BYTES>;
+
+  Sha256() { reset(); }
+
+  void reset() {
+    static const uint32_t initial[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    std::memcpy(state, initial, sizeof(state));
+    length = 0;
+    buffered = 0;
+  }
+
+  void update(const void *data, size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    length += size;
+    if (buffered > 0) {
+      size_t take = std::min(size, BLOCK_BYTES - buffered);
+      std::memcpy(buffer + buffered, bytes, take);
+      buffered += take;
+      bytes += take;
+      size -= take;
+      if (buffered < BLOCK_BYTES) return;
+      compress(buffer);
+      buffered = 0;
+    }
+    for (; size >= BLOCK_BYTES; bytes += BLOCK_BYTES, size -= BLOCK_BYTES) compress(bytes);
+    std::memcpy(buffer, bytes, size);
+    buffered = size;
+  }
+
+  void update(const std::string &text) { update(text.data(), text.size()); }
+
+  Digest finish() {
+    uint64_t bits = length * 8;
+    uint8_t pad = 0x80;
+    update(&pad, 1);
+    uint8_t zero = 0;
+    while (buffered != BLOCK_BYTES - 8) update(&zero, 1);
+    uint8_t size[8];
+    for (int i = 0; i < 8; i++) size[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+    update(size, 8);
+
+    Digest digest;
+    for (int i = 0; i < 8; i++) {
+      for (int b = 0; b < 4; b++) digest[i * 4 + b] = static_cast<uint8_t>(state[i] >> (24 - 8 * b));
+    }
+    return digest;
+  }
+
+  static Digest hash(const std::string &text) {
+    Sha256 sha;
+    sha.update(text);
+    return sha.finish();
+  }
+
+  static std::string toHex(const uint8_t *bytes, size_t size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(size * 2);
+    for (size_t i = 0; i < size; i++) {
+      hex += digits[bytes[i] >> 4];
+      hex += digits[bytes[i] & 0xF];
+    }
+    return hex;
+  }
+
+private:
+  static uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+  void compress(const uint8_t *block) {
+    static const uint32_t k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+        0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+        0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+        0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+        0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+        0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+        0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+        0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+        0xc67178f2};
+
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+      w[i] = static_cast<uint32_t>(block[i * 4]) << 24 | static_cast<uint32_t>(block[i * 4 + 1]) << 16 |
+             static_cast<uint32_t>(block[i * 4 + 2]) << 8 | block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+      uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+      uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+      uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+
+  uint32_t state[8];
+  uint64_t length;  // bytes hashed so far
+  uint8_t buffer[BLOCK_BYTES];
+  size_t buffered;  // bytes waiting in buffer
+};
+
+// HMAC-SHA256 with the key's pads absorbed once (see Sha256)
+class Hmac {
+public:
+  explicit Hmac(const std::string &key) {
+    uint8_t block[Sha256::BLOCK_BYTES] = {0};
+    if (key.size() > Sha256::BLOCK_BYTES) {
+      Sha256::Digest hashed = Sha256::hash(key);
+      std::memcpy(block, hashed.data(), hashed.size());
+    } else {
+      std::memcpy(block, key.data(), key.size());
+    }
+
+    uint8_t pad[Sha256::BLOCK_BYTES];
+    for (size_t i = 0; i < sizeof(pad); i++) pad[i] = block[i] ^ 0x36;
+    inner.update(pad, sizeof(pad));
+    for (size_t i = 0; i < sizeof(pad); i++) pad[i] = block[i] ^ 0x5c;
+    outer.update(pad, sizeof(pad));
+    std::memset(block, 0, sizeof(block));
+  }
+
+  Sha256::Digest mac(const void *data, size_t size) const {
+    Sha256 hash = inner;
+    hash.update(data, size);
+    Sha256::Digest innerDigest = hash.finish();
+    hash = outer;
+    hash.update(innerDigest.data(), innerDigest.size());
+    return hash.finish();
+  }
+
+  Sha256::Digest mac(const std::string &text) const { return mac(text.data(), text.size()); }
+
+private:
+  Sha256 inner; // state after the key XOR ipad block
+  Sha256 outer; // state after the key XOR opad block
+};
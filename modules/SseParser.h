@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+
+/**
+ * SseParser - incremental text/event-stream decoder
+ *
+ * HOW IT WORKS:
+ * =============
+ * Bytes are fed in as they arrive, split anywhere. Complete lines are
+ * taken off the front of a buffer: "data:" lines are collected (joined
+ * with "\n") and a blank line hands the event's data to the callback.
+ * Comment lines (": keep-alive") and other fields are skipped. A partial
+ * line waits for the next feed, so a character or JSON object split
+ * across network reads is only seen once it is whole.
+ */
+class SseParser {
+public:
+  // Receives the data of one event; returning false stops parsing
+  using EventCallback = std::function<bool(const std::string &data)>;
+
+  explicit SseParser(EventCallback onEvent) : onEvent(std::move(onEvent)) {}
+
+  // False once the callback asked to stop
+  bool feed(const char *data, size_t size) {
+    buffer.append(data, size);
+    size_t start = 0;
+    size_t end;
+    while ((end = buffer.find('\n', start)) != std::string::npos) {
+      size_t length = end - start;
+      if (length > 0 && buffer[end - 1] == '\r') length--;
+      bool keepGoing = line(buffer.data() + start, length);
+      start = end + 1;
+      if (!keepGoing) {
+        buffer.erase(0, start);
+        return false;
+      }
+    }
+    buffer.erase(0, start);
+    return true;
+  }
+
+  // End of stream: dispatch an event left without its blank line
+  bool finish() {
+    if (!buffer.empty()) {
+      std::string rest;
+      rest.swap(buffer);
+      if (!line(rest.data(), rest.size())) return false;
+    }
+    return dispatch();
+  }
+
+  // Events dispatched so far
+  size_t getEventCount() const { return events; }
+
+private:
+  bool line(const char *text, size_t length) {
+    if (length == 0) return dispatch();
+    if (text[0] == ':') return true; // comment
+
+    std::string field(text, length);
+    std::string value;
+    size_t colon = field.find(':');
+    if (colon != std::string::npos) {
+      value = field.substr(colon + 1);
+      if (!value.empty() && value[0] == ' ') value.erase(0, 1);
+      field.erase(colon);
+    }
+
+    if (field == "data") {
+      if (hasData) data += '\n';
+      data += value;
+      hasData = true;
+    }
+    return true;
+  }
+
+  bool dispatch() {
+    if (!hasData) return true;
+    std::string event;
+    event.swap(data);
+    hasData = false;
+    events++;
+    return onEvent(event);
+  }
+
+  EventCallback onEvent;
+  std::string buffer; // bytes after the last complete line
+  std::string data;   // data of the event being read
+  bool hasData = false;
+  size_t events = 0;
+};
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * TextSearch - allocation-free ASCII case-insensitive substring search
+ *
+ * HOW IT WORKS:
+ * =============
+ * The haystack is never copied or lower-cased. Instead, 16 bytes (SSE2) or
+ * 32 bytes (AVX2) are loaded at a time and case-folded in registers. Two
+ * blocks are compared per step: one at the candidate start against the
+ * needle's first byte, and one at start + (needle length - 1) against its
+ * last byte. Only positions where both match are verified byte by byte,
+ * which skips almost all of the text for typical keywords.
+ *
+ * Only ASCII letters are folded; other bytes (including UTF-8) must match
+ * exactly, which is the same behaviour as the old ::tolower copies.
+ */
+class TextSearch
+{
+public:
+  static char foldCase(char c)
+  {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+  }
+
+  // Case-insensitive equality of two equal-length byte ranges
+  static bool equalsIgnoreCase(const char *a, const char *b, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      if (foldCase(a[i]) != foldCase(b[i]))
+        return false;
+    }
+    return true;
+  }
+
+  // Position of needle in haystack ignoring ASCII case, or npos
+  static size_t findIgnoreCase(std::string_view haystack, std::string_view needle)
+  {
+    const size_t n = haystack.size();
+    const size_t m = needle.size();
+    if (m == 0)
+      return 0;
+    if (m > n)
+      return std::string::npos;
+
+    const char *text = haystack.data();
+    const char first = foldCase(needle[0]);
+    const char last = foldCase(needle[m - 1]);
+    const size_t lastStart = n - m; // final candidate position
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i vFirst = _mm256_set1_epi8(first);
+    const __m256i vLast = _mm256_set1_epi8(last);
+    for (; i + 32 <= lastStart + 1; i += 32)
+    {
+      __m256i blockFirst = fold32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i)));
+      __m256i blockLast = fold32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(text + i + m - 1)));
+      uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+          _mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, vFirst),
+                           _mm256_cmpeq_epi8(blockLast, vLast))));
+      while (mask)
+      {
+        size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+        if (m <= 2 || equalsIgnoreCase(text + pos + 1, needle.data() + 1, m - 2))
+          return pos;
+        mask &= mask - 1;
+      }
+    }
+#elif defined(__SSE2__)
+    const __m128i vFirst = _mm_set1_epi8(first);
+    const __m128i vLast = _mm_set1_epi8(last);
+    for (; i + 16 <= lastStart + 1; i += 16)
+    {
+      __m128i blockFirst = fold16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i)));
+      __m128i blockLast = fold16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(text + i + m - 1)));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+          _mm_and_si128(_mm_cmpeq_epi8(blockFirst, vFirst),
+                        _mm_cmpeq_epi8(blockLast, vLast))));
+      while (mask)
+      {
+        size_t pos = i + static_cast<size_t>(__builtin_ctz(mask));
+        if (m <= 2 || equalsIgnoreCase(text + pos + 1, needle.data() + 1, m - 2))
+          return pos;
+        mask &= mask - 1;
+      }
+    }
+#endif
+
+    // Scalar tail (and the whole scan on targets without SIMD)
+    for (; i <= lastStart; i++)
+    {
+      if (foldCase(text[i]) == first && foldCase(text[i + m - 1]) == last &&
+          (m <= 2 || equalsIgnoreCase(text + i + 1, needle.data() + 1, m - 2)))
+        return i;
+    }
+    return std::string::npos;
+  }
+
+  static bool containsIgnoreCase(std::string_view haystack, std::string_view needle)
+  {
+    return findIgnoreCase(haystack, needle) != std::string::npos;
+  }
+
+private:
+#if defined(__AVX2__)
+  // Lower-case the ASCII letters of 32 bytes
+  static __m256i fold32(__m256i block)
+  {
+    __m256i isUpper = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('A' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), block));
+    return _mm256_or_si256(block, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
+  }
+#elif defined(__SSE2__)
+  // Lower-case the ASCII letters of 16 bytes (bytes >= 0x80 compare as
+  // negative and are left alone)
+  static __m128i fold16(__m128i block)
+  {
+    __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)),
+                                    _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), block));
+    return _mm_or_si128(block, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+  }
+#endif
+};
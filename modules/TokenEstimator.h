@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * TokenEstimator - local estimate of how many tokens a text costs
+ *
+ * HOW IT WORKS:
+ * =============
+ * Close enough to a BPE tokenizer for budgeting prompts without calling
+ * one: letter runs cost a token per ~4 characters, digit runs one per 3
+ * digits, every other non-space character one. Multi-byte UTF-8
+ * characters count as half a token per byte.
+ */
+class TokenEstimator {
+public:
+  // Fixed cost of a chat message besides its content (role, separators)
+  static constexpr size_t MESSAGE_OVERHEAD = 4;
+
+  static size_t estimate(std::string_view text) {
+    size_t tokens = 0;
+    size_t letters = 0;
+    size_t digits = 0;
+    auto flush = [&]() {
+      tokens += (letters + 3) / 4 + (digits + 2) / 3;
+      letters = digits = 0;
+    };
+    for (unsigned char c : text) {
+      if (c >= '0' && c <= '9') {
+        if (letters) flush();
+        digits++;
+      } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') {
+        if (digits) flush();
+        letters++;
+      } else if (c >= 0x80) {
+        if (digits) flush();
+        letters += 2; // multi-byte characters split into several tokens
+      } else {
+        flush();
+        if (c != ' ') tokens++;
+      }
+    }
+    flush();
+    return tokens;
+  }
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../include/nlohmann/json.hpp"
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
+using json = nlohmann::json;
+
+/**
+ * ToolRegistry - local functions the model may call
+ *
+ * HOW IT WORKS:
+ * =============
+ * Each tool has a name, a description and a JSON schema of its
+ * arguments; getSchema() lists them in the chat completions "tools"
+ * format. When a reply asks for a tool call, AIModule runs call() with
+ * the name and the argument JSON the model wrote, and sends the result
+ * back as a "tool" message. Bad arguments or unknown tools come back as
+ * {"error": ...} so the model can correct itself instead of the turn
+ * failing.
+ */
+class ToolRegistry {
+public:
+  using Handler = std::function<json(const json &arguments)>;
+
+  void add(const std::string &name, const std::string &description, json parameters,
+           Handler handler) {
+    schema.push_back({{"type", "function"},
+                      {"function",
+                       {{"name", name},
+                        {"description", description},
+                        {"parameters", std::move(parameters)}}}});
+    handlers[name] = std::move(handler);
+  }
+
+  bool empty() const { return handlers.empty(); }
+
+  // Tool list for the request payload
+  const json &getSchema() const { return schema; }
+
+  // Run one call; the result is the JSON text sent back to the model
+  std::string call(const std::string &name, const std::string &arguments) const {
+    auto it = handlers.find(name);
+    if (it == handlers.end()) return json{{"error", "unknown tool: " + name}}.dump();
+    try {
+      json parsed = arguments.empty() ? json::object() : json::parse(arguments);
+      if (!parsed.is_object()) return json{{"error", "arguments must be an object"}}.dump();
+      return it->second(parsed).dump();
+    } catch (const std::exception &e) {
+      return json{{"error", std::string("bad arguments: ") + e.what()}}.dump();
+    }
+  }
+
+private:
+  json schema = json::array();
+  std::map<std::string, Handler> handlers;
+};
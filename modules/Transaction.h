@@ -1,5 +1,6 @@
 #pragma once
 #include "../include/nlohmann/json.hpp"
+#include "TextSearch.h"
 #include <ctime>
 #include <string>
 
@@ -32,10 +33,10 @@ public:
 
   // Getters
   int getId() const { return id; }
-  string getType() const { return type; }
+  const string &getType() const { return type; }
   double getAmount() const { return amount; }
-  string getDescription() const { return description; }
-  string getDate() const { return date; }
+  const string &getDescription() const { return description; }
+  const string &getDate() const { return date; }
 
   // Setters
   void setId(int id) { this->id = id; }
@@ -65,6 +66,50 @@ public:
     return dateStr;
   }
 
+  // Sortable key (yyyymmdd) for a date like "15 Nov, 25", or 0 if the text
+  // doesn't parse. Two-digit years are taken as 20xx.
+  static int parseDateKey(const string &text)
+  {
+    static const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    size_t i = 0;
+    auto readNumber = [&](int &value)
+    {
+      size_t start = i;
+      value = 0;
+      while (i < text.size() && text[i] >= '0' && text[i] <= '9')
+        value = value * 10 + (text[i++] - '0');
+      return i > start;
+    };
+    auto skipSeparators = [&]()
+    {
+      while (i < text.size() && (text[i] == ' ' || text[i] == ','))
+        i++;
+    };
+
+    int day = 0, year = 0, month = -1;
+    skipSeparators();
+    if (!readNumber(day))
+      return 0;
+    skipSeparators();
+    for (int m = 0; m < 12 && i + 3 <= text.size(); m++)
+    {
+      if (TextSearch::equalsIgnoreCase(text.data() + i, months[m], 3))
+        month = m;
+    }
+    if (month < 0)
+      return 0;
+    i += 3;
+    skipSeparators();
+    if (!readNumber(year))
+      return 0;
+    if (year < 100)
+      year += 2000;
+    if (day < 1 || day > 31)
+      return 0;
+    return year * 10000 + (month + 1) * 100 + day;
+  }
+
   // JSON conversion
   json toJson() const
   {
@@ -2,6 +2,9 @@
 #include "FileHandler.h"
 #include "Transaction.h"
 #include "AuthManager.h"
+#include "LedgerHeader.h"
+#include "LedgerIndex.h"
+#include "LedgerPrefetch.h"
 #include <algorithm>
 #include <vector>
 
@@ -10,33 +13,70 @@ using namespace std;
 class TransactionManager
 {
 public:
-  // Get all transactions
-  static vector<Transaction> getAllTransactions()
+  // Loaded ledger, read and decrypted once per session
+  static const vector<Transaction> &getLedger()
   {
-    // Get password from current logged-in user
-    User currentUser = AuthManager::getCurrentUser();
-    string password = currentUser.getPassword();
-    return FileHandler::readTransactionsFromFile(password);
+    ensureLoaded();
+    return ledger;
   }
 
-  // Get next available ID
-  static int getNextId()
+  // Type / category indexes over the loaded ledger
+  static const LedgerIndex &getIndex()
   {
-    vector<Transaction> transactions = getAllTransactions();
-    if (transactions.empty())
-    {
-      return 1;
-    }
+    ensureLoaded();
+    return index;
+  }
 
-    int maxId = 0;
-    for (const auto &t : transactions)
+  // Drop the cached ledger so the next access re-reads the file
+  static void reload()
+  {
+    loaded = false;
+    headerLoaded = false;
+    header = LedgerHeader();
+    ledger.clear();
+    index.clear();
+  }
+
+  // Drop the ledger and its indexes, memory included (another profile
+  // is being opened)
+  static void unload()
+  {
+    reload();
+    vector<Transaction>().swap(ledger);
+    index = LedgerIndex();
+  }
+
+  // Row count, totals and the like, from the file header until the
+  // ledger itself is loaded (then from its index)
+  static const LedgerHeader &getHeader()
+  {
+    if (!loaded && !headerLoaded)
     {
-      if (t.getId() > maxId)
+      headerLoaded = FileHandler::readLedgerHeader(AuthManager::getSessionKey(), header);
+      if (!headerLoaded)
       {
-        maxId = t.getId();
+        ensureLoaded(); // No header yet: count from the rows
       }
     }
-    return maxId + 1;
+    return header;
+  }
+
+  // Number of transactions (without loading them)
+  static size_t getTransactionCount()
+  {
+    return getHeader().rows;
+  }
+
+  // Get all transactions
+  static vector<Transaction> getAllTransactions()
+  {
+    return getLedger();
+  }
+
+  // Get next available ID
+  static int getNextId()
+  {
+    return getHeader().maxId + 1;
   }
 
   // Add a new transaction
@@ -61,20 +101,18 @@ public:
       return false;
     }
 
-    // Get all existing transactions
-    vector<Transaction> transactions = getAllTransactions();
-
     // Create new transaction with auto-generated ID and date
     Transaction newTransaction(type, amount, description);
     newTransaction.setId(getNextId());
 
-    // Add to vector
-    transactions.push_back(newTransaction);
+    // Append to the loaded ledger and keep the indexes and header in step
+    ensureLoaded();
+    ledger.push_back(newTransaction);
+    index.add(static_cast<uint32_t>(ledger.size() - 1), newTransaction);
+    header = describe(index);
 
-    // Save to file (encrypt with current user's password)
-    User currentUser = AuthManager::getCurrentUser();
-    string password = currentUser.getPassword();
-    FileHandler::writeTransactionsToFile(transactions, password);
+    // Save to file (encrypt with the session key)
+    FileHandler::writeTransactionsToFile(ledger, header, AuthManager::getSessionKey());
 
     return true;
   }
@@ -82,33 +120,77 @@ public:
   // Get total income
   static double getTotalIncome()
   {
-    vector<Transaction> transactions = getAllTransactions();
-    double total = 0.0;
-    for (const auto &t : transactions)
-    {
-      if (t.getType() == "income")
-      {
-        total += t.getAmount();
-      }
-    }
-    return total;
+    return getHeader().totalIncome;
   }
 
   // Get total expenses
   static double getTotalExpenses()
   {
-    vector<Transaction> transactions = getAllTransactions();
-    double total = 0.0;
-    for (const auto &t : transactions)
-    {
-      if (t.getType() == "expense")
-      {
-        total += t.getAmount();
-      }
-    }
-    return total;
+    return getHeader().totalExpenses;
+  }
+
+  // Changes whenever the ledger contents change (same across reloads)
+  static uint64_t getDataVersion()
+  {
+    return getHeader().dataVersion;
   }
 
   // Get balance (income - expenses)
   static double getBalance() { return getTotalIncome() - getTotalExpenses(); }
+
+private:
+  static inline vector<Transaction> ledger;
+  static inline LedgerIndex index;
+  static inline bool loaded = false;
+  static inline LedgerHeader header;
+  static inline bool headerLoaded = false; // header read from the file
+
+  static void ensureLoaded()
+  {
+    if (loaded)
+    {
+      return;
+    }
+
+    // Decrypt with the key derived at login; the login screen has usually
+    // read the file already (see LedgerPrefetch)
+    const SessionKey &key = AuthManager::getSessionKey();
+    string ciphertext;
+    if (LedgerPrefetch::take(ciphertext))
+    {
+      ledger = FileHandler::decryptTransactions(ciphertext, key);
+    }
+    else
+    {
+      ledger = FileHandler::readTransactionsFromFile(key);
+    }
+    index.rebuild(ledger);
+    loaded = true;
+
+    // Files from before the header get one now, so later logins skip the rows
+    if (!headerLoaded && !FileHandler::readLedgerHeader(key, header) && !ledger.empty())
+    {
+      FileHandler::writeTransactionsToFile(ledger, describe(index), key);
+    }
+    header = describe(index);
+    headerLoaded = true;
+  }
+
+  // Header figures for the indexed rows
+  static LedgerHeader describe(const LedgerIndex &rows)
+  {
+    LedgerHeader summary;
+    summary.rows = rows.size();
+    summary.maxId = rows.getMaxId();
+    const vector<LedgerIndex::DayBin> &bins = rows.getDailyBins();
+    if (!bins.empty())
+    {
+      summary.firstDateKey = bins.front().dateKey;
+      summary.lastDateKey = bins.back().dateKey;
+    }
+    summary.totalIncome = rows.getTotalIncome();
+    summary.totalExpenses = rows.getTotalExpenses();
+    summary.dataVersion = rows.getVersion();
+    return summary;
+  }
 };
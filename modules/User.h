@@ -30,7 +30,10 @@ public:
   {
     json j;
     j["username"] = username;
-    j["password"] = password;
+    if (!password.empty())
+    {
+      j["password"] = password; // Only in files from before session keys
+    }
     return j.dump(4); // pretty-printed JSON
   }
 
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkerPool - a few background threads running queued jobs
+ *
+ * HOW IT WORKS:
+ * =============
+ * Jobs go into a FIFO queue guarded by a mutex; idle workers sleep on a
+ * condition variable until one arrives. Jobs run in parallel up to the
+ * number of threads and must not touch the console. The destructor lets
+ * running jobs finish, drops the ones still queued and joins the threads.
+ */
+class WorkerPool {
+public:
+  explicit WorkerPool(size_t threadCount) {
+    for (size_t i = 0; i < threadCount; i++) {
+      threads.emplace_back(&WorkerPool::run, this);
+    }
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+      jobs.clear();
+    }
+    wake.notify_all();
+    for (auto &thread : threads) thread.join();
+  }
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  void submit(std::function<void()> job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      jobs.push_back(std::move(job));
+    }
+    wake.notify_one();
+  }
+
+  // Jobs waiting for a free thread
+  size_t getQueuedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size();
+  }
+
+private:
+  void run() {
+    while (true) {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (stopping) return;
+        job = std::move(jobs.front());
+        jobs.pop_front();
+      }
+      job();
+    }
+  }
+
+  std::mutex mutex; // guards jobs and stopping
+  std::condition_variable wake;
+  std::deque<std::function<void()>> jobs;
+  bool stopping = false;
+  std::vector<std::thread> threads;
+};
@@ -1,12 +1,235 @@
 #pragma once
 
 #include "../modules/AI.h"
+#include "../modules/AuthManager.h"
+#include "../modules/ConversationManager.h"
+#include "../modules/FileHandler.h"
+#include "../modules/IntentRouter.h"
+#include "../modules/LedgerTools.h"
+#include "../modules/ResponseCache.h"
+#include "../modules/TransactionManager.h"
 #include "ScreenRoutes.h"
 #include "ScreenUtils.h"
+#include <atomic>
+#include <iomanip>
+#include <memory>
 #include <iostream>
 #include <string>
 
-inline void showAIScreen() {
+#ifdef _WIN32
+// Request that Ctrl-C cancels instead of closing the app
+inline std::atomic<AIRequest *> ctrlCRequest{nullptr};
+
+inline BOOL WINAPI cancelOnCtrlC(DWORD type) {
+  if (type != CTRL_C_EVENT && type != CTRL_BREAK_EVENT) return FALSE;
+  AIRequest *request = ctrlCRequest.load();
+  if (!request) return FALSE;
+  request->cancel();
+  return TRUE;
+}
+#endif
+
+// Load the user's encrypted reply cache from disk and hand it to the AI
+// module, keyed to the ledger's data version. Only the first call after
+// each login does so (a login to another profile brings its own cache).
+inline void ensureResponseCache() {
+  static std::weak_ptr<const SessionKey> openedFor;
+  // The cache saves from a worker thread, so it shares ownership of the key
+  std::shared_ptr<const SessionKey> key = AuthManager::shareSessionKey();
+  if (!key || openedFor.lock() == key) return;
+  openedFor = key;
+  std::string path = FileHandler::aiCacheFile();
+  auto cache = std::make_shared<ResponseCache>(
+      ResponseCache::DEFAULT_MAX_ENTRIES, ResponseCache::DEFAULT_MAX_BYTES,
+      [key, path](const json &entries) { FileHandler::writeAiCacheToFile(entries, *key, path); });
+  cache->load(FileHandler::readAiCacheFromFile(*key));
+  AIModule::setResponseCache(cache);
+  AIModule::setDataVersionSource(LedgerTools::getDataVersion);
+}
+
+// Answer a ledger lookup ("how much did I spend on food this month") from
+// the ledger itself, with no request. The turn still goes into the history
+// so later questions to the model can refer to it. Returns false if the
+// question needs the model.
+inline bool printLocalAnswer(const std::string &input, ConversationManager &conversation) {
+  IntentRouter::Answer answer = IntentRouter::route(input);
+  if (!answer.answered()) return false;
+
+  conversation.history().push_back({{"role", "user"}, {"content", input}});
+  conversation.history().push_back({{"role", "assistant"}, {"content", answer.text}});
+  setColor(10); // Green for AI
+  std::cout << "  🤖 AI: ";
+  resetColor();
+  std::cout << answer.text << std::endl;
+  std::cout << "  ";
+  setColor(COLOR_GRAY);
+  std::cout << "⏱ Answered from your ledger in " << std::fixed << std::setprecision(0)
+            << answer.elapsedMs * 1000 << " µs · no request";
+  resetColor();
+  std::cout << std::endl;
+  return true;
+}
+
+// A reply still streaming when the user stepped out of the chat, with the
+// conversation it belongs to. The dashboard shows how it is getting on and
+// the next visit to the AI screen picks it up where the printing stopped.
+struct BackgroundReply {
+  std::shared_ptr<AIRequest> request;
+  std::shared_ptr<ConversationManager> conversation;
+  std::string question;
+  std::string shown; // reply text printed before the user left
+  std::weak_ptr<const SessionKey> session;
+
+  // Still this login's (a reply for another profile is dropped)
+  bool isCurrent() const {
+    return request && !session.expired() && session.lock() == AuthManager::shareSessionKey();
+  }
+};
+
+inline BackgroundReply &backgroundReply() {
+  static BackgroundReply reply;
+  return reply;
+}
+
+// One dashboard line about a reply left running, if there is one
+inline void drawBackgroundReplyStatus() {
+  const BackgroundReply &reply = backgroundReply();
+  if (!reply.isCurrent()) return;
+  std::string question = reply.question;
+  if (question.length() > 30) question = question.substr(0, 27) + "...";
+  std::cout << "  ";
+  setColor(COLOR_GRAY);
+  if (!reply.request->isFinished()) {
+    std::cout << "🤖 Still answering \"" << question << "\"";
+  } else {
+    std::cout << "🤖 Your answer to \"" << question << "\" is ready";
+  }
+  resetColor();
+  std::cout << "  ";
+  setColor(COLOR_CYAN);
+  std::cout << "[a]";
+  resetColor();
+  std::cout << " to read it" << std::endl;
+}
+
+inline void printReplyLabel() {
+  std::cout << "  ";
+  setColor(COLOR_GRAY);
+  std::cout << "[Esc] cancel  [b] back (keeps answering)";
+  resetColor();
+  std::cout << std::endl << std::endl;
+  setColor(10); // Green for AI
+  std::cout << "  🤖 AI: ";
+  resetColor();
+}
+
+// Print a running reply as it streams in (after the shown text already on
+// screen), followed by the time to the first token and to the whole reply.
+// Keys stay live meanwhile: Esc or Ctrl-C cancels the request; b / m leave
+// it answering in the background and leave the screen (returns false).
+inline bool followReply(std::shared_ptr<AIRequest> request,
+                        std::shared_ptr<ConversationManager> conversation,
+                        const std::string &question, std::string shown) {
+  presentFrame();
+#ifdef _WIN32
+  ctrlCRequest = request.get();
+  SetConsoleCtrlHandler(cancelOnCtrlC, TRUE);
+#endif
+
+  bool leave = false;
+  while (!leave) {
+    bool finished = request->isFinished();
+    std::string text = request->takeNewText();
+    if (!text.empty()) {
+      shown += text;
+      std::cout << text;
+      presentFrame();
+    }
+    if (finished) break;
+
+    while (keyWaiting()) {
+      int key = readKey();
+      if (key == 27) {
+        request->cancel();
+      } else if (key == 'b' || key == 'B' || key == 'm' || key == 'M') {
+        leave = true;
+      }
+    }
+    if (!leave) request->waitFor(30);
+  }
+
+#ifdef _WIN32
+  SetConsoleCtrlHandler(cancelOnCtrlC, FALSE);
+  ctrlCRequest = nullptr;
+#endif
+
+  if (leave) {
+    BackgroundReply &pending = backgroundReply();
+    if (pending.request && pending.request != request) pending.request->cancel(); // one at a time
+    pending = {request, conversation, question, shown, AuthManager::shareSessionKey()};
+    return false;
+  }
+
+  request->finishTurn(conversation->history());
+  if (request->getState() == AIRequest::State::Completed && !request->isFromCache()) {
+    IntentRouter::recordModelReply(request->getElapsedMs());
+  }
+  if (shown.empty()) {
+    std::cout << request->getResult().get();
+  } else if (request->getState() == AIRequest::State::Cancelled) {
+    setColor(COLOR_GRAY);
+    std::cout << " [cancelled]";
+    resetColor();
+  }
+  std::cout << std::endl;
+
+  std::cout << "  ";
+  setColor(COLOR_GRAY);
+  std::cout << "⏱ ";
+  if (request->isFromCache()) {
+    std::cout << "From cache · ";
+  } else if (request->getFirstTokenMs() >= 0) {
+    std::cout << "First token " << std::fixed << std::setprecision(0)
+              << request->getFirstTokenMs() << " ms · ";
+  }
+  std::cout << "Reply " << std::fixed << std::setprecision(0) << request->getElapsedMs()
+            << " ms";
+  if (request->getRoundTrips() > 0) {
+    std::cout << " · " << request->getRoundTrips()
+              << (request->getRoundTrips() == 1 ? " request" : " requests");
+    if (request->getToolCalls() > 0) {
+      std::cout << " (" << request->getToolCalls()
+                << (request->getToolCalls() == 1 ? " tool call)" : " tool calls)");
+    }
+    if (request->getRetries() > 0) {
+      std::cout << " · " << request->getRetries()
+                << (request->getRetries() == 1 ? " retry" : " retries");
+    }
+    std::cout << " · " << std::setprecision(1) << request->getRequestBytes() / 1024.0
+              << " KB sent";
+  }
+  resetColor();
+  std::cout << std::endl;
+  return true;
+}
+
+// Send one chat turn on a background worker and follow its reply. Older
+// turns are folded into the summary first, so the request stays within
+// the conversation's token cap; tools, if given, are offered to the model.
+// asked is the question as the user typed it, if input adds to it.
+inline bool printStreamedReply(const std::string &input,
+                               std::shared_ptr<ConversationManager> conversation,
+                               std::shared_ptr<const ToolRegistry> tools = nullptr,
+                               const std::string &asked = "") {
+  printReplyLabel();
+  ensureResponseCache();
+  conversation->compact();
+  std::shared_ptr<AIRequest> request =
+      AIModule::chatAsync(input, conversation->history(), tools);
+  return followReply(request, conversation, asked.empty() ? input : asked, "");
+}
+
+inline Route showAIScreen() {
   clearScreen();
 
   // Beautiful header
@@ -18,26 +241,40 @@ inline void showAIScreen() {
               "   Ask me anything about budgeting, saving, or investing.");
   std::cout << std::endl;
 
-  json conversation_history = json::array();
+  // Carry on with a reply left running in the background, if any
+  BackgroundReply resumed;
+  std::swap(resumed, backgroundReply());
+  std::shared_ptr<ConversationManager> conversation;
+  if (resumed.isCurrent()) {
+    conversation = resumed.conversation;
+    setColor(11); // Cyan for user
+    std::cout << "  You: ";
+    resetColor();
+    std::cout << resumed.question << std::endl << std::endl;
+    printReplyLabel();
+    std::cout << resumed.shown;
+    if (!followReply(resumed.request, conversation, resumed.question, resumed.shown)) {
+      return Route::MainMenu;
+    }
+    std::cout << std::endl;
+  } else {
+    if (resumed.request) resumed.request->cancel();
+    conversation = std::make_shared<ConversationManager>();
 
-  // System prompt
-  conversation_history.push_back(
-      {{"role", "system"},
-       {"content", "You are a helpful financial advisor. Provide sound "
-                   "financial advice and tips. Keep responses concise but helpful."}});
+    // System prompt
+    conversation->addSystem("You are a helpful financial advisor. Provide sound "
+                            "financial advice and tips. Keep responses concise but helpful.");
+  }
 
   while (true) {
     // Draw the navigation footer each iteration
-    std::cout << "  ";
-    for (int i = 0; i < 70; i++) std::cout << "─";
-    std::cout << std::endl;
+    std::cout << "  " << glyphRun("─", 70) << std::endl;
 
     setColor(11); // Cyan for user
     std::cout << "  You: ";
     resetColor();
 
-    std::string user_input;
-    std::getline(std::cin, user_input);
+    std::string user_input = getInput();
 
     // Handle navigation
     if (user_input == "b" || user_input == "B" || user_input == "back" ||
@@ -50,23 +287,15 @@ inline void showAIScreen() {
     if (user_input == "m" || user_input == "M" || user_input == "menu") {
       break;
     }
-    if (handleNavigation(user_input)) return;
+    if (handleNavigation(user_input)) return Route::Quit;
 
     std::cout << std::endl;
-    setColor(8); // Gray for thinking
-    std::cout << "  ⏳ AI is thinking..." << std::endl;
-    resetColor();
-
-    std::string response = AIModule::chat(user_input, conversation_history);
-
-    // Clear thinking and show response
-    std::cout << std::endl;
-    setColor(10); // Green for AI
-    std::cout << "  🤖 AI: ";
-    resetColor();
-    std::cout << response << std::endl;
+    if (!printLocalAnswer(user_input, *conversation) &&
+        !printStreamedReply(user_input, conversation)) {
+      break;
+    }
     std::cout << std::endl;
   }
 
-  showMainMenu();
+  return Route::MainMenu;
 }
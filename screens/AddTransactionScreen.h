@@ -7,7 +7,7 @@
 #include "ScreenRoutes.h"
 #include "ScreenUtils.h"
 
-inline void showAddTransactionScreen() {
+inline Route showAddTransactionScreen() {
   clearScreen();
 
   // Beautiful header
@@ -29,10 +29,9 @@ inline void showAddTransactionScreen() {
 
   // Handle navigation
   if (choiceStr == "b" || choiceStr == "B" || choiceStr == "back") {
-    showMainMenu();
-    return;
+    return Route::MainMenu;
   }
-  if (handleNavigation(choiceStr)) return;
+  if (handleNavigation(choiceStr)) return Route::Quit;
 
   int choice = 0;
   try {
@@ -47,16 +46,14 @@ inline void showAddTransactionScreen() {
   } else if (choice == 2) {
     type = "income";
   } else if (choice == 3) {
-    showAIScreen();
-    return;
+    return Route::AI;
   } else {
     std::cout << std::endl;
     drawStatusMessage("Invalid choice. Please try again.", "error");
     std::cout << std::endl;
     std::cout << "  Press ENTER to retry...";
     std::cin.get();
-    showAddTransactionScreen();
-    return;
+    return Route::AddTransaction;
   }
 
   // Amount input
@@ -75,8 +72,7 @@ inline void showAddTransactionScreen() {
     std::cout << std::endl;
     std::cout << "  Press ENTER to retry...";
     std::cin.get();
-    showAddTransactionScreen();
-    return;
+    return Route::AddTransaction;
   }
 
   // Description input
@@ -88,8 +84,7 @@ inline void showAddTransactionScreen() {
     std::cout << std::endl;
     std::cout << "  Press ENTER to retry...";
     std::cin.get();
-    showAddTransactionScreen();
-    return;
+    return Route::AddTransaction;
   }
 
   // Optional note
@@ -118,6 +113,6 @@ inline void showAddTransactionScreen() {
 
   drawPrompt("Press ENTER to continue or 'b' to go back");
   std::string input = getInput();
-  if (handleNavigation(input)) return;
-  showMainMenu();
+  if (handleNavigation(input)) return Route::Quit;
+  return Route::MainMenu;
 }
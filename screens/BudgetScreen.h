@@ -2,11 +2,12 @@
 
 #include "../modules/BudgetManager.h"
 #include "../modules/TransactionManager.h"
+#include "ScreenRoutes.h"
 #include "ScreenUtils.h"
 #include <iomanip>
 #include <sstream>
 
-inline void showBudgetScreen() {
+inline Route showBudgetScreen() {
   while (true) {
     clearScreen();
     drawScreenHeader("Budget Management", true);
@@ -119,7 +120,7 @@ inline void showBudgetScreen() {
     std::string choice = getInput();
     
     if (handleNavigation(choice)) continue;
-    if (choice == "b" || choice == "B" || choice == "m" || choice == "M") return;
+    if (choice == "b" || choice == "B" || choice == "m" || choice == "M") return Route::MainMenu;
     
     if (choice == "a" || choice == "A") {
       // Add/Edit budget
@@ -158,7 +159,7 @@ inline void showBudgetScreen() {
         default:
           drawStatusMessage("Invalid choice", "error");
           std::cout << "\n  Press any key to continue...";
-          _getch();
+          waitForKey();
           continue;
       }
       
@@ -170,7 +171,7 @@ inline void showBudgetScreen() {
       if (limit <= 0) {
         drawStatusMessage("Invalid amount", "error");
         std::cout << "\n  Press any key to continue...";
-        _getch();
+        waitForKey();
         continue;
       }
       
@@ -179,7 +180,7 @@ inline void showBudgetScreen() {
       std::cout << std::endl;
       drawSuccessBox("Budget set: " + category + " = $" + std::to_string((int)limit));
       std::cout << "\n  Press any key to continue...";
-      _getch();
+      waitForKey();
       
     } else if (choice == "d" || choice == "D") {
       // Delete a budget
@@ -190,7 +191,7 @@ inline void showBudgetScreen() {
         std::cout << std::endl;
         drawStatusMessage("No budgets to delete.", "info");
         std::cout << "\n  Press any key to continue...";
-        _getch();
+        waitForKey();
         continue;
       }
       
@@ -218,7 +219,7 @@ inline void showBudgetScreen() {
         drawStatusMessage("Invalid input", "error");
       }
       std::cout << "\n  Press any key to continue...";
-      _getch();
+      waitForKey();
     }
   }
 }
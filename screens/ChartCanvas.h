@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ScreenUtils.h"
+
+/**
+ * BrailleCanvas - off-screen chart raster with 2x4 sub-pixels per cell
+ *
+ * HOW IT WORKS:
+ * =============
+ * Every terminal cell is a Unicode braille pattern (U+2800 + 8 dot bits),
+ * so a W x H cell canvas is a 2W x 4H pixel grid: 8 plot points where the
+ * old charts had one character. Series are plotted as pixels, lines
+ * (Bresenham) and filled rectangles; each cell keeps the color of the last
+ * series drawn into it. A row is emitted as whole strings with a color
+ * change only where the cell color changes, so a chart costs a handful of
+ * writes into the current frame instead of one per cell.
+ */
+class BrailleCanvas {
+public:
+  BrailleCanvas(int cols, int rows)
+      : cols(cols), rows(rows), dots(cols * rows, 0), colors(cols * rows, COLOR_WHITE) {}
+
+  int getCols() const { return cols; }
+  int getRows() const { return rows; }
+  int pixelWidth() const { return cols * 2; }
+  int pixelHeight() const { return rows * 4; }
+
+  // Set one pixel; (0, 0) is the top-left corner
+  void plot(int x, int y, int color) {
+    if (x < 0 || y < 0 || x >= pixelWidth() || y >= pixelHeight()) return;
+    int cell = (y / 4) * cols + x / 2;
+    dots[cell] |= DOT_BITS[y % 4][x % 2];
+    colors[cell] = color;
+  }
+
+  void line(int x0, int y0, int x1, int y1, int color) {
+    int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+      plot(x0, y0, color);
+      if (x0 == x1 && y0 == y1) break;
+      int e2 = 2 * err;
+      if (e2 >= dy) {
+        err += dy;
+        x0 += sx;
+      }
+      if (e2 <= dx) {
+        err += dx;
+        y0 += sy;
+      }
+    }
+  }
+
+  // Filled rectangle with inclusive corners
+  void fill(int x0, int y0, int x1, int y1, int color) {
+    for (int y = std::min(y0, y1); y <= std::max(y0, y1); y++) {
+      for (int x = std::min(x0, x1); x <= std::max(x0, x1); x++) plot(x, y, color);
+    }
+  }
+
+  // Pixel row for a value on a min..max scale (max at the top)
+  int scaleY(double value, double minVal, double maxVal) const {
+    double t = maxVal > minVal ? (value - minVal) / (maxVal - minVal) : 0.0;
+    t = std::max(0.0, std::min(1.0, t));
+    return (pixelHeight() - 1) - static_cast<int>(std::lround(t * (pixelHeight() - 1)));
+  }
+
+  // Write one cell row (empty cells as spaces)
+  void drawRow(int row) const {
+    std::string segment;
+    int segmentColor = -1;
+    for (int c = 0; c < cols; c++) {
+      int cell = row * cols + c;
+      int color = dots[cell] ? colors[cell] : COLOR_WHITE;
+      if (color != segmentColor) {
+        std::cout << segment;
+        segment.clear();
+        setColor(color);
+        segmentColor = color;
+      }
+      appendCell(segment, dots[cell]);
+    }
+    std::cout << segment;
+    resetColor();
+  }
+
+private:
+  // Braille dot bit for (row % 4, column % 2) within a cell
+  static constexpr uint8_t DOT_BITS[4][2] = {{0x01, 0x08}, {0x02, 0x10}, {0x04, 0x20}, {0x40, 0x80}};
+
+  static void appendCell(std::string &out, uint8_t bits) {
+    if (bits == 0) {
+      out += ' ';
+      return;
+    }
+    // U+2800 + bits as UTF-8
+    out += static_cast<char>(0xE2);
+    out += static_cast<char>(0xA0 | (bits >> 6));
+    out += static_cast<char>(0x80 | (bits & 0x3F));
+  }
+
+  int cols;
+  int rows;
+  std::vector<uint8_t> dots;
+  std::vector<int> colors;
+};
+
+// A named data series and its color
+struct ChartSeries {
+  std::string label;
+  std::vector<double> values;
+  int color = 0;
+  std::vector<double> xs = {};   // optional x positions (default: evenly spaced)
+  std::vector<double> lows = {}; // optional lower bounds: drawn as a low..high band
+};
+
+// Width of the y-axis label column, including the axis glyph
+const int CHART_AXIS_WIDTH = 12;
+
+inline std::string formatAxisValue(double value) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(0) << value;
+  return oss.str();
+}
+
+// Emit a rasterized chart: y-axis labels (max, middle, min), the canvas,
+// the x-axis, a caller-built x-label line and a legend
+inline void drawChartLayout(const BrailleCanvas &canvas, double minVal, double maxVal,
+                            const std::string &xLabels,
+                            const std::vector<ChartSeries> &series,
+                            std::chrono::steady_clock::time_point started) {
+  int rows = canvas.getRows();
+  for (int row = 0; row < rows; row++) {
+    if (row == 0 || row == rows / 2 || row == rows - 1) {
+      double value = row == 0 ? maxVal : row == rows - 1 ? minVal : (minVal + maxVal) / 2;
+      std::cout << "  " << std::setw(8) << std::right << formatAxisValue(value) << " ┤";
+    } else {
+      std::cout << "           │";
+    }
+    canvas.drawRow(row);
+    std::cout << std::endl;
+  }
+
+  std::cout << "           └" << glyphRun("─", canvas.getCols()) << std::endl;
+  std::cout << std::string(CHART_AXIS_WIDTH, ' ') << xLabels << std::endl;
+
+  // Legend
+  std::cout << std::endl << std::string(CHART_AXIS_WIDTH, ' ');
+  for (const auto &s : series) {
+    setColor(s.color);
+    std::cout << "⣿⣿";
+    resetColor();
+    std::cout << " " << s.label << "   ";
+  }
+  std::cout << std::endl;
+
+  double ms = std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - started).count();
+  std::cout << "  ";
+  setColor(COLOR_GRAY);
+  std::cout << "⏱ Rendered " << canvas.pixelWidth() << "x" << canvas.pixelHeight()
+            << " sub-pixels in " << std::fixed << std::setprecision(3) << ms << " ms";
+  resetColor();
+  std::cout << std::endl;
+}
+
+// Line chart: points joined by lines, placed by their x positions or
+// spread evenly over the width. Series with lows are drawn as a band.
+// xLabels are printed under the left edge, middle and right edge.
+inline void drawLineChart(const std::vector<ChartSeries> &series,
+                          const std::vector<std::string> &xLabels, int cols, int rows) {
+  auto started = std::chrono::steady_clock::now();
+
+  double minVal = 0, maxVal = 0;
+  double minX = 0, maxX = 0;
+  bool first = true, firstX = true;
+  for (const auto &s : series) {
+    for (size_t i = 0; i < s.values.size(); i++) {
+      double low = i < s.lows.size() ? s.lows[i] : s.values[i];
+      minVal = first ? low : std::min(minVal, low);
+      maxVal = first ? s.values[i] : std::max(maxVal, s.values[i]);
+      first = false;
+    }
+    for (double x : s.xs) {
+      minX = firstX ? x : std::min(minX, x);
+      maxX = firstX ? x : std::max(maxX, x);
+      firstX = false;
+    }
+  }
+  if (first) return;
+  if (maxVal == minVal) maxVal = minVal + 100; // Prevent flat line at zero
+
+  BrailleCanvas canvas(cols, rows);
+  const int lastPixel = canvas.pixelWidth() - 1;
+  for (const auto &s : series) {
+    size_t n = s.values.size();
+    bool band = s.lows.size() == n;
+    int prevX = 0, prevY = 0, prevLow = 0;
+    for (size_t i = 0; i < n; i++) {
+      int x = 0;
+      if (s.xs.size() == n && maxX > minX) {
+        x = static_cast<int>(std::lround((s.xs[i] - minX) / (maxX - minX) * lastPixel));
+      } else if (n > 1) {
+        x = static_cast<int>(i * lastPixel / (n - 1));
+      }
+      int y = canvas.scaleY(s.values[i], minVal, maxVal);
+      int low = band ? canvas.scaleY(s.lows[i], minVal, maxVal) : y;
+
+      if (band) canvas.line(x, low, x, y, s.color);
+      if (i == 0) {
+        canvas.plot(x, y, s.color);
+      } else {
+        canvas.line(prevX, prevY, x, y, s.color);
+        if (band) canvas.line(prevX, prevLow, x, low, s.color);
+      }
+      prevX = x;
+      prevY = y;
+      prevLow = low;
+    }
+  }
+
+  // First, middle and last label spread over the chart width
+  std::string labels(cols, ' ');
+  if (!xLabels.empty()) {
+    auto place = [&](const std::string &text, int at) {
+      at = std::max(0, std::min(at, cols - static_cast<int>(text.size())));
+      labels.replace(at, std::min(text.size(), labels.size() - at), text);
+    };
+    place(xLabels.front(), 0);
+    if (xLabels.size() > 2) {
+      const std::string &mid = xLabels[xLabels.size() / 2];
+      place(mid, cols / 2 - static_cast<int>(mid.size()) / 2);
+    }
+    if (xLabels.size() > 1) place(xLabels.back(), cols);
+  }
+
+  drawChartLayout(canvas, minVal, maxVal, labels, series, started);
+}
+
+// Grouped bar chart: one group per label, one bar per series, scaled from 0
+inline void drawBarChart(const std::vector<std::string> &labels,
+                         const std::vector<ChartSeries> &series, int rows) {
+  auto started = std::chrono::steady_clock::now();
+
+  const int slotCols = 7; // bars in cells 1-2 and 4-5 of each group
+  double maxVal = 0;
+  for (const auto &s : series) {
+    for (double v : s.values) maxVal = std::max(maxVal, v);
+  }
+  if (maxVal == 0) maxVal = 100; // Prevent division by zero
+
+  BrailleCanvas canvas(static_cast<int>(labels.size()) * slotCols, rows);
+  for (size_t g = 0; g < labels.size(); g++) {
+    for (size_t s = 0; s < series.size() && s < 2; s++) {
+      if (g >= series[s].values.size()) continue;
+      double v = series[s].values[g];
+      if (v <= 0) continue;
+      int x0 = static_cast<int>(g * slotCols + 1 + s * 3) * 2;
+      int top = canvas.scaleY(v, 0, maxVal);
+      canvas.fill(x0, top, x0 + 3, canvas.pixelHeight() - 1, series[s].color);
+    }
+  }
+
+  std::ostringstream xLabels;
+  for (const auto &label : labels) {
+    xLabels << " " << std::left << std::setw(slotCols - 1) << label.substr(0, slotCols - 1);
+  }
+
+  drawChartLayout(canvas, 0, maxVal, xLabels.str(), series, started);
+}
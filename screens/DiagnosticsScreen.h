@@ -0,0 +1,830 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/nlohmann/json.hpp"
+#include "../modules/AI.h"
+#include "../modules/Bm25Retriever.h"
+#include "../modules/ConversationManager.h"
+#include "../modules/FinancialContext.h"
+#include "../modules/HttpClient.h"
+#include "../modules/IntentRouter.h"
+#include "../modules/LedgerIndex.h"
+#include "../modules/LedgerPrefetch.h"
+#include "../modules/LoopbackHttpServer.h"
+#include "../modules/ProfileStore.h"
+#include "../modules/ResponseCache.h"
+#include "../modules/SessionKey.h"
+#include "../modules/TextSearch.h"
+#include "../modules/TokenEstimator.h"
+#include "../modules/Transaction.h"
+#include "../modules/TransactionManager.h"
+#include "../modules/User.h"
+#include "AIScreen.h"
+#include "ScreenRoutes.h"
+#include "ScreenUtils.h"
+
+// Throughput of the old lower-case-copy matcher vs TextSearch
+struct TextMatcherBenchmark {
+  double megabytes;
+  double copyFindMBps;
+  double textSearchMBps;
+  size_t matches; // per approach
+};
+
+inline std::string formatRate(double mbps) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(0) << mbps << " MB/s";
+  return oss.str();
+}
+
+// Scan the ledger descriptions (padded with sample rows up to ~8 MB)
+// for a few keywords with both approaches
+inline TextMatcherBenchmark runTextMatcherBenchmark() {
+  std::vector<std::string> corpus;
+  size_t bytes = 0;
+  for (const auto &t : TransactionManager::getLedger()) {
+    corpus.push_back(t.getDescription());
+    bytes += t.getDescription().size();
+  }
+
+  const char *samples[] = {"Starbucks Coffee Downtown", "AMAZON Marketplace order",
+                           "Uber ride to the airport", "Whole Foods Grocery",
+                           "Monthly rent - Apartment 4B", "Salary deposit ACME Corp"};
+  for (size_t i = 0; bytes < 8 * 1024 * 1024; i++) {
+    corpus.push_back(samples[i % 6]);
+    bytes += corpus.back().size();
+  }
+
+  const std::vector<std::string> keywords = {"grocery", "amazon", "coffee", "xyzzy"};
+  using Clock = std::chrono::steady_clock;
+  size_t hits = 0;
+
+  auto start = Clock::now();
+  for (const auto &keyword : keywords) {
+    for (const auto &text : corpus) {
+      std::string lower = text;
+      std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+      if (lower.find(keyword) != std::string::npos) hits++;
+    }
+  }
+  double copySeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  start = Clock::now();
+  for (const auto &keyword : keywords) {
+    for (const auto &text : corpus) {
+      if (TextSearch::containsIgnoreCase(text, keyword)) hits++;
+    }
+  }
+  double searchSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  double scannedMB = static_cast<double>(bytes) * keywords.size() / (1024.0 * 1024.0);
+  TextMatcherBenchmark result;
+  result.megabytes = scannedMB;
+  result.copyFindMBps = copySeconds > 0 ? scannedMB / copySeconds : 0;
+  result.textSearchMBps = searchSeconds > 0 ? scannedMB / searchSeconds : 0;
+  result.matches = hits / 2;
+  return result;
+}
+
+// Prompt size of the old full-ledger dump vs the budgeted summary, for
+// the loaded ledger and a synthetic 100k-row one
+struct ContextBenchmark {
+  size_t fullJsonBytes;   // every loaded row as JSON (old prompt)
+  size_t contextBytes;    // FinancialContextBuilder summary of the loaded ledger
+  size_t contextTokens;   // estimated
+  size_t syntheticRows;
+  size_t syntheticJsonBytes;
+  size_t syntheticContextBytes;
+  size_t syntheticContextTokens;
+  double syntheticBuildMs;
+  size_t sessionTurns;        // simulated chat length
+  size_t unboundedTurnTokens; // last request, whole history re-sent (old)
+  size_t managedTurnTokens;   // last request through a ConversationManager
+};
+
+inline ContextBenchmark runContextBenchmark() {
+  ContextBenchmark result{};
+  nlohmann::json rows = nlohmann::json::array();
+  for (const auto &t : TransactionManager::getLedger()) rows.push_back(t.toJson());
+  result.fullJsonBytes = ("Transaction History: " + rows.dump()).size();
+  std::string context = FinancialContextBuilder::build(TransactionManager::getLedger(),
+                                                       TransactionManager::getIndex());
+  result.contextBytes = context.size();
+  result.contextTokens = TokenEstimator::estimate(context);
+
+  // Three years of daily spending across the categories, with a few outliers
+  const char *descriptions[] = {"Whole Foods Grocery", "Uber ride downtown", "Monthly rent",
+                                "Electric bill", "Amazon purchase", "Netflix subscription",
+                                "Pharmacy", "Coffee shop", "Salary deposit"};
+  const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                          "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  std::vector<Transaction> ledger;
+  result.syntheticRows = 100000;
+  ledger.reserve(result.syntheticRows);
+  for (size_t i = 0; i < result.syntheticRows; i++) {
+    size_t day = i * 36 / result.syntheticRows * 30 + (i % 28);
+    std::string date = std::to_string(day % 28 + 1) + " " + months[(day / 30) % 12] + ", " +
+                       std::to_string(23 + day / 360);
+    bool income = i % 9 == 8;
+    double amount = income ? 3000.0 : 5.0 + (i * 7919 % 1000) / 10.0;
+    if (i % 9973 == 0) amount *= 40; // outlier
+    ledger.emplace_back(static_cast<int>(i + 1), income ? "income" : "expense", amount,
+                        descriptions[i % 9], date);
+  }
+  result.syntheticJsonBytes = 0;
+  for (const auto &t : ledger) result.syntheticJsonBytes += t.toJson().dump().size() + 1;
+
+  LedgerIndex index;
+  index.rebuild(ledger);
+  auto start = std::chrono::steady_clock::now();
+  std::string synthetic = FinancialContextBuilder::build(ledger, index);
+  result.syntheticBuildMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  result.syntheticContextBytes = synthetic.size();
+  result.syntheticContextTokens = TokenEstimator::estimate(synthetic);
+
+  // A long chat: the same turns with and without the token cap
+  result.sessionTurns = 60;
+  nlohmann::json unbounded = nlohmann::json::array();
+  ConversationManager managed;
+  unbounded.push_back({{"role", "system"}, {"content", synthetic}});
+  managed.addSystem(synthetic);
+  const std::string answer =
+      "You spent about $412 on food this month, which is 18% of your expenses. Groceries "
+      "make up most of it, with coffee shops a distant second. Cooking at home two more "
+      "nights a week and setting a weekly grocery limit would bring it closer to the 12% "
+      "that budgeting guides suggest for a household like yours.";
+  for (size_t turn = 0; turn < result.sessionTurns; turn++) {
+    std::string question = "Question " + std::to_string(turn + 1) +
+                           ": how can I spend less on food and still eat well?";
+    managed.compact();
+    for (nlohmann::json *history : {&unbounded, &managed.history()}) {
+      history->push_back({{"role", "user"}, {"content", question}});
+    }
+    result.unboundedTurnTokens = ConversationManager::estimateTokens(unbounded);
+    result.managedTurnTokens = ConversationManager::estimateTokens(managed.history());
+    for (nlohmann::json *history : {&unbounded, &managed.history()}) {
+      history->push_back({{"role", "assistant"}, {"content", answer}});
+    }
+  }
+  return result;
+}
+
+// BM25 retrieval over a synthetic 1M-row ledger
+struct RetrievalBenchmark {
+  size_t rows;
+  double indexMs;  // building the LedgerIndex (terms included)
+  double queryMs;  // per question
+  std::string question;
+  std::string topMatch; // best row for the question
+};
+
+inline RetrievalBenchmark runRetrievalBenchmark() {
+  const char *merchants[] = {"Whole Foods Grocery", "Uber ride downtown", "Monthly rent",
+                             "Electric bill", "Amazon Marketplace order", "Netflix subscription",
+                             "CVS Pharmacy", "Blue Bottle Coffee", "Shell gas station",
+                             "Target store", "Salary deposit"};
+  const char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                          "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+  RetrievalBenchmark result{};
+  result.rows = 1000000;
+
+  // Three years in date order; rows are generated again to print a match
+  auto makeRow = [&](size_t i) {
+    size_t day = i * 1080 / result.rows;
+    std::string date = std::to_string(day % 30 + 1) + " " + months[(day / 30) % 12] + ", " +
+                       std::to_string(23 + day / 360);
+    size_t merchant = (i * 7) % 11;
+    return Transaction(static_cast<int>(i + 1), merchant == 10 ? "income" : "expense",
+                       5.0 + (i * 7919 % 20000) / 100.0,
+                       std::string(merchants[merchant]) + " #" + std::to_string(i % 997), date);
+  };
+
+  using Clock = std::chrono::steady_clock;
+  auto start = Clock::now();
+  LedgerIndex index;
+  for (size_t i = 0; i < result.rows; i++) {
+    index.add(static_cast<uint32_t>(i), makeRow(i));
+  }
+  result.indexMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+  const std::vector<std::string> questions = {
+      "What was that Amazon charge in March?", "How much did I spend on coffee in 2024?",
+      "Show my Uber rides in December", "Pharmacy costs"};
+  std::vector<Bm25Retriever::Hit> hits;
+  start = Clock::now();
+  for (const auto &question : questions) {
+    hits = Bm25Retriever::search(index, question);
+    if (result.question.empty()) {
+      result.question = question;
+      if (!hits.empty()) {
+        Transaction t = makeRow(hits.front().row);
+        result.topMatch = t.getDescription() + ", " + t.getDate();
+      }
+    }
+  }
+  result.queryMs =
+      std::chrono::duration<double, std::milli>(Clock::now() - start).count() / questions.size();
+  return result;
+}
+
+// Typical chat questions run through the IntentRouter on the user's ledger
+struct IntentRouterBenchmark {
+  size_t questions;
+  size_t answeredLocally;
+  double localMs; // per answered question
+  std::string question;
+  std::string answer; // to the first question
+};
+
+inline IntentRouterBenchmark runIntentRouterBenchmark() {
+  const std::vector<std::string> questions = {
+      "What's my balance?",
+      "How much did I spend on food this month?",
+      "What was my biggest expense last month?",
+      "How much income did I get this year?",
+      "How many transactions do I have?",
+      "Total spent on transport in March",
+      "How can I spend less on food?",
+      "Is my rent too high for my income?",
+      "What did I spend at Uber last week?",
+      "Give me three saving tips"};
+  const int repeats = 100;
+  int today = Transaction::parseDateKey(Transaction::generateCurrentDate());
+
+  IntentRouterBenchmark result{};
+  result.questions = questions.size();
+  double answeredMs = 0;
+  for (const auto &question : questions) {
+    IntentRouter::Answer answer;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+      answer = IntentRouter::route(question, TransactionManager::getLedger(),
+                                   TransactionManager::getIndex(), today);
+    }
+    if (!answer.answered()) continue;
+    result.answeredLocally++;
+    answeredMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                            start)
+                      .count() /
+                  repeats;
+    if (result.question.empty()) {
+      result.question = question;
+      result.answer = answer.text;
+    }
+  }
+  result.localMs = result.answeredLocally == 0 ? 0 : answeredMs / result.answeredLocally;
+  return result;
+}
+
+// Key derivation cost, and per-save key setup and encryption with the
+// password (old) against the session key
+struct SessionKeyBenchmark {
+  int iterations;       // of the session key
+  double loginDeriveMs; // what this login paid to derive it
+  double per100kMs;     // PBKDF2 cost per 100k iterations here
+  size_t ledgerBytes;   // the ledger as saved
+  double passwordSetupUs; // user + password copies before each save (old)
+  double passwordEncryptMs;
+  double keyEncryptMs;
+};
+
+inline SessionKeyBenchmark runSessionKeyBenchmark() {
+  const SessionKey &key = AuthManager::getSessionKey();
+  SessionKeyBenchmark result{};
+  result.iterations = key.getIterations();
+  result.loginDeriveMs = key.getDeriveMs();
+
+  const int probe = 10000;
+  auto start = std::chrono::steady_clock::now();
+  SessionKey::pbkdf2("diagnostics", "diagnostics", probe, SessionKey::KEY_BYTES);
+  result.per100kMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                               start)
+                         .count() *
+                     100000 / probe;
+
+  json rows = json::array();
+  for (const auto &transaction : TransactionManager::getLedger()) {
+    rows.push_back(transaction.toJson());
+  }
+  std::string ledger = json{{"transactions", rows}}.dump(4);
+  result.ledgerBytes = ledger.size();
+
+  const int copies = 100000;
+  User user("diagnostics", "correct horse battery staple");
+  size_t copied = 0;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < copies; i++) {
+    User current = user;
+    std::string password = current.getPassword();
+    copied += password.size();
+  }
+  result.passwordSetupUs = std::chrono::duration<double, std::micro>(
+                               std::chrono::steady_clock::now() - start)
+                               .count() /
+                           copies;
+
+  const int saves = 20;
+  size_t encrypted = copied == 0 ? 1 : 0; // keeps the copies from being optimized out
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < saves; i++) {
+    encrypted += EncryptionManager::encrypt(ledger, user.getPassword()).size();
+  }
+  result.passwordEncryptMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+          .count() /
+      saves;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < saves; i++) encrypted += EncryptionManager::encrypt(ledger, key).size();
+  result.keyEncryptMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+          .count() /
+      saves;
+  if (encrypted == 0) result.keyEncryptMs = 0;
+  return result;
+}
+
+// What the dashboard needs, from the ledger file's header against
+// decrypting and parsing the whole file (old)
+struct LedgerHeaderBenchmark {
+  bool hasHeader;
+  size_t rows;
+  double headerMs;
+  double fullReadMs;
+};
+
+inline LedgerHeaderBenchmark runLedgerHeaderBenchmark() {
+  const SessionKey &key = AuthManager::getSessionKey();
+  LedgerHeaderBenchmark result{};
+  const int reads = 5;
+  LedgerHeader header;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < reads; i++) result.hasHeader = FileHandler::readLedgerHeader(key, header);
+  result.headerMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+          .count() /
+      reads;
+  result.rows = header.rows;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < reads; i++) result.rows = FileHandler::readTransactionsFromFile(key).size();
+  result.fullReadMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+          .count() /
+      reads;
+  return result;
+}
+
+// Opening the ledger after login: only decrypt + parse with the bytes
+// prefetched at the login screen, read + hex decode first without
+struct PrefetchBenchmark {
+  size_t fileBytes;
+  double readMs;  // the part prefetched: read + hex decode
+  double parseMs; // what is left after login: decrypt + parse
+};
+
+inline PrefetchBenchmark runPrefetchBenchmark() {
+  const SessionKey &key = AuthManager::getSessionKey();
+  PrefetchBenchmark result{};
+  const int reads = 5;
+  std::string headerLine;
+  std::string ciphertext;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < reads; i++) FileHandler::readTransactionCiphertext(headerLine, ciphertext);
+  result.readMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+          .count() /
+      reads;
+  result.fileBytes = headerLine.size() + ciphertext.size() * 2;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < reads; i++) FileHandler::decryptTransactions(ciphertext, key);
+  result.parseMs =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+          .count() /
+      reads;
+  return result;
+}
+
+inline std::string formatBytes(size_t bytes) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1);
+  if (bytes >= 1024 * 1024) {
+    oss << bytes / (1024.0 * 1024.0) << " MB";
+  } else {
+    oss << bytes / 1024.0 << " KB";
+  }
+  return oss.str();
+}
+
+// Per-turn cost of posting a chat payload to a loopback server
+// (milliseconds; negative when that path couldn't run)
+struct HttpTransportBenchmark {
+  bool serverStarted;
+  size_t payloadBytes;
+  double curlSpawnMs;       // curl.exe per turn, payload in a temp file (old path)
+  double freshConnectionMs; // new TCP connection per turn
+  double keepAliveMs;       // SocketHttpTransport on a warm connection
+  double winHttpMs;         // WinHttpTransport (Windows only)
+  size_t keepAliveTurns;
+  size_t keepAliveConnections; // accepted by the server during those turns
+  size_t streamTokens;         // streamed reply through AIModule::chatStream
+  double streamFirstTokenMs;
+  double streamReplyMs;
+  size_t concurrentRequests;   // streamed through AIModule::chatAsync at once
+  double concurrentMs;         // until all of them finished
+  double cancelMs;             // from cancel() until the request let go
+  double cacheMissMs;          // first time a question is asked
+  double cacheHitMs;           // the same question again, from a ResponseCache
+};
+
+inline std::string formatLatency(double ms) {
+  if (ms < 0) return "unavailable";
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(2) << ms << " ms / turn";
+  return oss.str();
+}
+
+// Average milliseconds per successful turn, or -1 if a turn failed
+inline double timeTurns(int turns, const std::function<bool()> &turn) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < turns; i++) {
+    if (!turn()) return -1;
+  }
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+             .count() / turns;
+}
+
+// Send a chat-sized payload (system prompt plus the ledger summary)
+// to a loopback server the old way and through the transports
+inline HttpTransportBenchmark runHttpTransportBenchmark() {
+  const std::string reply =
+      R"({"choices":[{"message":{"role":"assistant","content":"Looks good."}}]})";
+  HttpTransportBenchmark result{};
+  result.curlSpawnMs = result.freshConnectionMs = result.keepAliveMs = result.winHttpMs = -1;
+
+  LoopbackHttpServer server(reply);
+  std::vector<std::string> events;
+  for (const char *token : {"You", " spent", " $", "412", " on", " food", " this", " month", ",",
+                            " about", " 18", "%", " of", " your", " expenses", "."}) {
+    events.push_back(nlohmann::json{{"choices", {{{"delta", {{"content", token}}}}}}}.dump());
+  }
+  server.setStream(events, 20); // one token every 20 ms
+  result.serverStarted = server.start();
+  if (!result.serverStarted) return result;
+
+  nlohmann::json history = nlohmann::json::array();
+  history.push_back({{"role", "system"}, {"content", "You are a helpful financial advisor."}});
+  history.push_back({{"role", "system"},
+                     {"content", FinancialContextBuilder::build(TransactionManager::getLedger(),
+                                                                TransactionManager::getIndex())}});
+  history.push_back({{"role", "user"}, {"content", "How much did I spend on food?"}});
+  const std::string payload =
+      nlohmann::json{{"model", "openai/gpt-3.5-turbo"}, {"messages", history}}.dump();
+  result.payloadBytes = payload.size();
+
+  const std::string url = server.url("/api/v1/chat/completions");
+  const HttpHeaders headers = {{"Content-Type", "application/json"}};
+
+  // Old path: write the payload to a file and spawn curl.exe for it
+  const char *tempFile = "temp_benchmark_request.json";
+  if (FILE *file = fopen(tempFile, "w")) {
+    fputs(payload.c_str(), file);
+    fclose(file);
+    std::string command = "curl.exe -s -X POST " + url +
+                          " -H \"Content-Type: application/json\" -d @" + tempFile + " 2>nul";
+    result.curlSpawnMs = timeTurns(5, [&] {
+      FILE *pipe = _popen(command.c_str(), "r");
+      if (!pipe) return false;
+      std::string output;
+      char buffer[128];
+      while (fgets(buffer, sizeof(buffer), pipe) != nullptr) output += buffer;
+      _pclose(pipe);
+      return output == reply;
+    });
+    remove(tempFile);
+  }
+
+  result.freshConnectionMs = timeTurns(20, [&] {
+    SocketHttpTransport transport;
+    return transport.post(url, headers, payload).body == reply;
+  });
+
+  SocketHttpTransport keepAlive;
+  keepAlive.post(url, headers, payload); // open the connection
+  size_t connectionsBefore = server.getConnectionCount();
+  result.keepAliveTurns = 50;
+  result.keepAliveMs = timeTurns(static_cast<int>(result.keepAliveTurns), [&] {
+    return keepAlive.post(url, headers, payload).body == reply;
+  });
+  result.keepAliveConnections = server.getConnectionCount() - connectionsBefore;
+
+  // Streamed reply: the first token shows up long before the last
+  auto previousTransport = AIModule::setTransport(std::make_shared<SocketHttpTransport>());
+  auto previousCache = AIModule::setResponseCache(nullptr); // every turn goes to the server
+  std::string previousEndpoint = AIModule::currentEndpoint();
+  AIModule::setEndpoint(url);
+  nlohmann::json conversation = nlohmann::json::array();
+  AIModule::chatStream("How much did I spend on food?", conversation,
+                       [&](const std::string &) { result.streamTokens++; });
+  result.streamFirstTokenMs = AIModule::getLastFirstTokenMs();
+  result.streamReplyMs = AIModule::getLastResponseMs();
+
+  // Several background requests at once take about as long as one
+  result.concurrentRequests = 4;
+  std::vector<std::shared_ptr<AIRequest>> requests;
+  auto concurrentStart = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < result.concurrentRequests; i++) {
+    nlohmann::json turn = nlohmann::json::array();
+    requests.push_back(AIModule::chatAsync("How much did I spend on food?", turn));
+  }
+  for (auto &request : requests) request->waitFor(AIModule::DEFAULT_TIMEOUT_MS);
+  result.concurrentMs = std::chrono::duration<double, std::milli>(
+                            std::chrono::steady_clock::now() - concurrentStart).count();
+
+  // Cancelling a request in the middle of its reply
+  nlohmann::json cancelledTurn = nlohmann::json::array();
+  auto cancelled = AIModule::chatAsync("How much did I spend on food?", cancelledTurn);
+  while (cancelled->takeNewText().empty() && !cancelled->waitFor(5)) {
+  }
+  auto cancelStart = std::chrono::steady_clock::now();
+  cancelled->cancel();
+  cancelled->waitFor(AIModule::DEFAULT_TIMEOUT_MS);
+  result.cancelMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - cancelStart).count();
+
+  // A repeated question against a throwaway cache
+  AIModule::setResponseCache(std::make_shared<ResponseCache>());
+  for (double *ms : {&result.cacheMissMs, &result.cacheHitMs}) {
+    nlohmann::json repeated = nlohmann::json::array();
+    AIModule::chatStream("How much did I spend on food?", repeated, [](const std::string &) {});
+    *ms = AIModule::getLastResponseMs();
+  }
+
+  AIModule::setResponseCache(previousCache);
+  AIModule::setTransport(previousTransport);
+  AIModule::setEndpoint(previousEndpoint);
+
+#ifdef _WIN32
+  WinHttpTransport winHttp;
+  winHttp.post(url, headers, payload);
+  result.winHttpMs = timeTurns(50, [&] { return winHttp.post(url, headers, payload).body == reply; });
+#endif
+
+  server.stop();
+  return result;
+}
+
+inline Route showDiagnosticsScreen() {
+  clearScreen();
+
+  drawScreenHeader("AI Expense - Diagnostics", true);
+  std::cout << std::endl;
+
+  drawInfoBox("🩺 Performance diagnostics",
+              "   Benchmarks run against your loaded ledger.");
+  std::cout << std::endl;
+
+  drawInfoLine("📋", "Transactions loaded",
+               std::to_string(TransactionManager::getLedger().size()), COLOR_CYAN);
+
+  // Session key: derivation cost and per-save encryption
+  drawSectionTitle("Session key (PBKDF2-HMAC-SHA256)", "🔐");
+  std::cout << "  Running benchmark..." << std::endl;
+  presentFrame();
+  SessionKeyBenchmark keyBench = runSessionKeyBenchmark();
+
+  std::ostringstream derived;
+  derived << keyBench.iterations << " iterations in " << std::fixed << std::setprecision(0)
+          << keyBench.loginDeriveMs << " ms";
+  drawInfoLine("🔑", "Derived once at login", derived.str(), COLOR_CYAN);
+  std::ostringstream cost;
+  cost << std::fixed << std::setprecision(0) << keyBench.per100kMs
+       << " ms per 100k iterations (target " << SessionKey::TARGET_DERIVE_MS << " ms)";
+  drawInfoLine("📈", "Derivation cost", cost.str());
+  std::ostringstream setup;
+  setup << std::fixed << std::setprecision(2) << keyBench.passwordSetupUs
+        << " µs copying the password (old), now none";
+  drawInfoLine("🚀", "Key setup per save", setup.str(), COLOR_GREEN);
+  std::ostringstream save;
+  save << std::fixed << std::setprecision(2) << keyBench.keyEncryptMs << " ms vs "
+       << keyBench.passwordEncryptMs << " ms with the password (old)";
+  drawInfoLine("📦", "Encrypt " + formatBytes(keyBench.ledgerBytes) + " ledger", save.str(),
+               COLOR_GREEN);
+
+  // Ledger header: dashboard figures without reading the rows
+  std::cout << std::endl;
+  drawSectionTitle("Ledger file header", "📇");
+  LedgerHeaderBenchmark headerBench = runLedgerHeaderBenchmark();
+  if (!headerBench.hasHeader) {
+    drawStatusMessage("The transactions file has no header yet (it gets one on the next save).",
+                      "info");
+  } else {
+    std::ostringstream headerRead;
+    headerRead << std::fixed << std::setprecision(2) << headerBench.headerMs << " ms";
+    drawInfoLine("🚀", "Count, totals and next id from the header", headerRead.str(), COLOR_GREEN);
+  }
+  std::ostringstream fullRead;
+  fullRead << std::fixed << std::setprecision(2) << headerBench.fullReadMs << " ms for "
+           << headerBench.rows << " rows";
+  drawInfoLine("🐢", "Decrypt and parse the whole file (old)", fullRead.str(), COLOR_YELLOW);
+
+  // Ledger prefetch at the login screen
+  std::cout << std::endl;
+  drawSectionTitle("Ledger prefetch while the password is typed", "⏩");
+  PrefetchBenchmark prefetch = runPrefetchBenchmark();
+  std::ostringstream withPrefetch;
+  withPrefetch << std::fixed << std::setprecision(1) << prefetch.parseMs
+               << " ms (decrypt + parse)";
+  drawInfoLine("🚀", "Ledger opened after login, prefetched", withPrefetch.str(), COLOR_GREEN);
+  std::ostringstream withoutPrefetch;
+  withoutPrefetch << std::fixed << std::setprecision(1) << prefetch.readMs + prefetch.parseMs
+                  << " ms (+ reading " << formatBytes(prefetch.fileBytes) << ")";
+  drawInfoLine("🐢", "Without prefetch (old)", withoutPrefetch.str(), COLOR_YELLOW);
+  if (LedgerPrefetch::getLoginToDashboardMs() >= 0) {
+    std::ostringstream login;
+    login << std::fixed << std::setprecision(0) << LedgerPrefetch::getLoginToDashboardMs()
+          << " ms, " << (LedgerPrefetch::wasUsed() ? "prefetched" : "not prefetched")
+          << " (key derivation included)";
+    drawInfoLine("⏱", "This login to dashboard", login.str(), COLOR_CYAN);
+  }
+
+  // Profiles: only the open one is in memory
+  std::cout << std::endl;
+  drawSectionTitle("Profiles", "👥");
+  drawInfoLine("📂", "Open profile",
+               ProfileStore::active().name + " (" + std::to_string(ProfileStore::list().size()) +
+                   " on this computer, only this one loaded)",
+               COLOR_CYAN);
+  if (ProfileStore::getLastSwitchMs() >= 0) {
+    std::ostringstream switched;
+    switched << std::fixed << std::setprecision(1) << ProfileStore::getLastSwitchMs()
+             << " ms to close the previous profile and free its data";
+    drawInfoLine("🔄", "Last switch", switched.str(), COLOR_GREEN);
+  }
+
+  // Text matcher benchmark
+  std::cout << std::endl;
+  drawSectionTitle("Case-insensitive text matching", "🔤");
+  std::cout << "  Running benchmark..." << std::endl;
+  presentFrame();
+  TextMatcherBenchmark bench = runTextMatcherBenchmark();
+
+  std::ostringstream scanned;
+  scanned << std::fixed << std::setprecision(1) << bench.megabytes << " MB";
+  drawInfoLine("📦", "Text scanned per approach", scanned.str());
+  drawInfoLine("🔍", "Keyword matches", std::to_string(bench.matches));
+  drawInfoLine("🐢", "Lower-case copy + find", formatRate(bench.copyFindMBps), COLOR_YELLOW);
+  drawInfoLine("🚀", "TextSearch (SIMD)", formatRate(bench.textSearchMBps), COLOR_GREEN);
+  if (bench.copyFindMBps > 0) {
+    std::ostringstream speedup;
+    speedup << std::fixed << std::setprecision(1)
+            << bench.textSearchMBps / bench.copyFindMBps << "x";
+    drawInfoLine("📈", "Speedup", speedup.str(), COLOR_CYAN);
+  }
+
+  // AI prompt context benchmark
+  std::cout << std::endl;
+  drawSectionTitle("AI prompt context (token budget)", "🧾");
+  std::cout << "  Running benchmark..." << std::endl;
+  presentFrame();
+  ContextBenchmark context = runContextBenchmark();
+
+  drawInfoLine("🐢", "Full ledger as JSON (old)", formatBytes(context.fullJsonBytes), COLOR_YELLOW);
+  drawInfoLine("🚀", "Budgeted summary",
+               formatBytes(context.contextBytes) + ", ~" +
+                   std::to_string(context.contextTokens) + " tokens",
+               COLOR_GREEN);
+  std::ostringstream synthetic;
+  synthetic << formatBytes(context.syntheticContextBytes) << " vs "
+            << formatBytes(context.syntheticJsonBytes) << " in " << std::fixed
+            << std::setprecision(0) << context.syntheticBuildMs << " ms";
+  drawInfoLine("📦", std::to_string(context.syntheticRows / 1000) + "k-row ledger", synthetic.str(),
+               COLOR_CYAN);
+  std::ostringstream session;
+  session << "~" << context.managedTurnTokens << " tokens vs ~" << context.unboundedTurnTokens
+          << " re-sending every turn";
+  drawInfoLine("🧠", "Request at turn " + std::to_string(context.sessionTurns), session.str(),
+               COLOR_GREEN);
+
+  // Retrieval benchmark
+  std::cout << std::endl;
+  drawSectionTitle("Transaction retrieval for AI questions (BM25)", "🔎");
+  std::cout << "  Running benchmark..." << std::endl;
+  presentFrame();
+  RetrievalBenchmark retrieval = runRetrievalBenchmark();
+
+  std::ostringstream indexed;
+  indexed << retrieval.rows / 1000 << "k rows in " << std::fixed << std::setprecision(0)
+          << retrieval.indexMs << " ms";
+  drawInfoLine("📦", "Index built", indexed.str());
+  std::ostringstream query;
+  query << std::fixed << std::setprecision(1) << retrieval.queryMs << " ms / question";
+  drawInfoLine("🚀", "Top matches", query.str(), COLOR_GREEN);
+  drawInfoLine("🔍", "\"" + retrieval.question + "\"",
+               retrieval.topMatch.empty() ? "no match" : retrieval.topMatch, COLOR_CYAN);
+
+  // AI request transport benchmark
+  std::cout << std::endl;
+  drawSectionTitle("AI request transport (loopback server)", "🌐");
+  std::cout << "  Running benchmark..." << std::endl;
+  presentFrame();
+  HttpTransportBenchmark http = runHttpTransportBenchmark();
+
+  if (!http.serverStarted) {
+    drawStatusMessage("Could not start the loopback server.", "error");
+  } else {
+    std::ostringstream payload;
+    payload << std::fixed << std::setprecision(1) << http.payloadBytes / 1024.0 << " KB";
+    drawInfoLine("📦", "Payload per turn", payload.str());
+    drawInfoLine("🐢", "curl.exe spawn per turn (old)", formatLatency(http.curlSpawnMs), COLOR_YELLOW);
+    drawInfoLine("🔌", "New connection per turn", formatLatency(http.freshConnectionMs));
+    drawInfoLine("🚀", "Keep-alive connection", formatLatency(http.keepAliveMs), COLOR_GREEN);
+#ifdef _WIN32
+    drawInfoLine("🪟", "WinHTTP session", formatLatency(http.winHttpMs), COLOR_GREEN);
+#endif
+    drawInfoLine("🔗", "Connections opened for " + std::to_string(http.keepAliveTurns) + " turns",
+                 std::to_string(http.keepAliveConnections), COLOR_CYAN);
+    std::ostringstream streamed;
+    streamed << http.streamTokens << " tokens: first after "
+             << std::fixed << std::setprecision(0) << http.streamFirstTokenMs << " ms, all after "
+             << http.streamReplyMs << " ms";
+    drawInfoLine("⚡", "Streamed reply", streamed.str(), COLOR_GREEN);
+    std::ostringstream concurrent;
+    concurrent << http.concurrentRequests << " at once in " << std::fixed << std::setprecision(0)
+               << http.concurrentMs << " ms";
+    drawInfoLine("🧵", "Background requests", concurrent.str(), COLOR_GREEN);
+    std::ostringstream cancel;
+    cancel << std::fixed << std::setprecision(1) << http.cancelMs << " ms";
+    drawInfoLine("🛑", "Cancel to stop", cancel.str(), COLOR_GREEN);
+    if (http.curlSpawnMs > 0 && http.keepAliveMs > 0) {
+      std::ostringstream speedup;
+      speedup << std::fixed << std::setprecision(0) << http.curlSpawnMs / http.keepAliveMs << "x";
+      drawInfoLine("📈", "Overhead saved vs curl.exe", speedup.str(), COLOR_CYAN);
+    }
+  }
+
+  // Response cache: this session's hit rate and a repeated question
+  std::cout << std::endl;
+  drawSectionTitle("AI response cache", "🗃");
+  ensureResponseCache();
+  std::shared_ptr<ResponseCache> cache = AIModule::currentResponseCache();
+  if (cache) {
+    drawInfoLine("📦", "Cached replies",
+                 std::to_string(cache->size()) + " (" + formatBytes(cache->getBytes()) + ")");
+    std::ostringstream hitRate;
+    hitRate << std::fixed << std::setprecision(0) << cache->getHitRate() * 100 << "% ("
+            << cache->getHits() << " of " << cache->getHits() + cache->getMisses()
+            << " questions this session)";
+    drawInfoLine("🎯", "Hit rate", hitRate.str(), COLOR_CYAN);
+  }
+  if (http.serverStarted) {
+    std::ostringstream repeat;
+    repeat << std::fixed << std::setprecision(1) << http.cacheHitMs << " ms vs "
+           << std::setprecision(0) << http.cacheMissMs << " ms asked";
+    drawInfoLine("🚀", "Repeated question", repeat.str(), COLOR_GREEN);
+  }
+
+  // Local intent router: sample questions, then this session's chat
+  std::cout << std::endl;
+  drawSectionTitle("Questions answered without the model", "🧭");
+  IntentRouterBenchmark router = runIntentRouterBenchmark();
+  drawInfoLine("📋", "Sample questions answered locally",
+               std::to_string(router.answeredLocally) + " of " +
+                   std::to_string(router.questions));
+  std::ostringstream local;
+  local << std::fixed << std::setprecision(1) << router.localMs * 1000 << " µs";
+  if (http.serverStarted) {
+    local << " vs " << std::setprecision(0) << http.cacheMissMs << " ms asking (loopback)";
+  }
+  drawInfoLine("🚀", "Local answer", local.str(), COLOR_GREEN);
+  drawInfoLine("🔍", "\"" + router.question + "\"", router.answer, COLOR_CYAN);
+  IntentRouter::Stats chats = IntentRouter::getStats();
+  std::ostringstream rate;
+  rate << std::fixed << std::setprecision(0) << IntentRouter::getLocalAnswerRate(chats) * 100
+       << "% (" << chats.answeredLocally << " of " << chats.questions
+       << " questions this session)";
+  drawInfoLine("🎯", "Local-answer rate", rate.str(), COLOR_CYAN);
+  if (chats.modelReplies > 0) {
+    std::ostringstream saved;
+    saved << std::fixed << std::setprecision(1) << IntentRouter::getLatencySavedMs(chats) / 1000
+          << " s (model replies average " << std::setprecision(0)
+          << chats.modelMs / chats.modelReplies << " ms)";
+    drawInfoLine("⏳", "Waiting saved", saved.str(), COLOR_GREEN);
+  }
+
+  drawNavFooter();
+  drawPrompt("Press ENTER to go back");
+  std::string input = getInput();
+  if (handleNavigation(input)) return Route::Quit;
+  return Route::MainMenu;
+}
@@ -144,7 +144,7 @@ inline bool exportToJSON(const std::vector<Transaction> &transactions, const std
   return true;
 }
 
-inline void showExportScreen() {
+inline Route showExportScreen() {
   clearScreen();
 
   // Header
@@ -161,8 +161,7 @@ inline void showExportScreen() {
     drawNavFooter();
     drawPrompt("Press ENTER to go back");
     getInput();
-    showMainMenu();
-    return;
+    return Route::MainMenu;
   }
 
   // Info box
@@ -190,10 +189,9 @@ inline void showExportScreen() {
 
   // Handle navigation
   if (choice == "b" || choice == "B" || choice == "back") {
-    showMainMenu();
-    return;
+    return Route::MainMenu;
   }
-  if (handleNavigation(choice)) return;
+  if (handleNavigation(choice)) return Route::Quit;
 
   std::cout << std::endl;
 
@@ -228,32 +226,26 @@ inline void showExportScreen() {
   if (choice != "1" && choice != "2" && choice != "3" && choice != "4") {
     drawStatusMessage("Invalid choice.", "error");
   } else if (success) {
-    std::cout << "  ┌";
-    for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-    std::cout << "┐" << std::endl;
+    std::cout << "  ┌" << glyphRun("─", BOX_WIDTH) << "┐" << std::endl;
     
     std::string successMsg = "✓ Export successful!";
     int successPad = BOX_INNER - static_cast<int>(successMsg.length());
     std::cout << "  │ " << successMsg;
-    for (int i = 0; i < successPad; i++) std::cout << " ";
+    std::cout << std::string(successPad, ' ');
     std::cout << " │" << std::endl;
     
-    std::cout << "  ├";
-    for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-    std::cout << "┤" << std::endl;
+    std::cout << "  ├" << glyphRun("─", BOX_WIDTH) << "┤" << std::endl;
     
     for (const auto &file : exportedFiles) {
       std::string fileEntry = "📁 " + file;
       int filePad = BOX_INNER - static_cast<int>(fileEntry.length());
       if (filePad < 0) filePad = 0;
       std::cout << "  │ " << fileEntry;
-      for (int i = 0; i < filePad; i++) std::cout << " ";
+      std::cout << std::string(filePad, ' ');
       std::cout << " │" << std::endl;
     }
     
-    std::cout << "  └";
-    for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-    std::cout << "┘" << std::endl;
+    std::cout << "  └" << glyphRun("─", BOX_WIDTH) << "┘" << std::endl;
   } else {
     drawStatusMessage("Export failed. Check file permissions.", "error");
   }
@@ -261,5 +253,5 @@ inline void showExportScreen() {
   drawNavFooter();
   drawPrompt("Press ENTER to continue");
   getInput();
-  showMainMenu();
+  return Route::MainMenu;
 }
@@ -9,8 +9,12 @@
 #include <string>
 #include <vector>
 
+#include "../modules/Categorizer.h"
+#include "../modules/Downsample.h"
+#include "../modules/LedgerIndex.h"
 #include "../modules/Transaction.h"
 #include "../modules/TransactionManager.h"
+#include "ChartCanvas.h"
 #include "ScreenRoutes.h"
 #include "ScreenUtils.h"
 
@@ -23,45 +27,41 @@ inline std::string getMonthName(int month) {
   return "???";
 }
 
-// Parse date string "15 Nov, 25" to month index and year
-inline bool parseDateToMonthYear(const std::string &dateStr, int &month,
-                                  int &year) {
-  const std::map<std::string, int> monthMap = {
-      {"Jan", 0}, {"Feb", 1}, {"Mar", 2},  {"Apr", 3},
-      {"May", 4}, {"Jun", 5}, {"Jul", 6},  {"Aug", 7},
-      {"Sep", 8}, {"Oct", 9}, {"Nov", 10}, {"Dec", 11}};
-
-  // Format: "15 Nov, 25"
-  std::istringstream iss(dateStr);
-  int day;
-  std::string monthStr;
-  char comma;
-  int yr;
-
-  if (iss >> day >> monthStr) {
-    // Remove comma if present
-    if (!monthStr.empty() && monthStr.back() == ',') {
-      monthStr.pop_back();
-    }
+// Month groups in the income vs expenses chart (7 cells each)
+const size_t MONTH_CHART_GROUPS = 9;
 
-    auto it = monthMap.find(monthStr);
-    if (it != monthMap.end()) {
-      month = it->second;
+// Size of the expense trend chart in cells
+const int TREND_CHART_COLS = 60;
+const int TREND_CHART_ROWS = 12;
 
-      // Try to read year
-      if (iss >> comma >> yr || iss >> yr) {
-        year = 2000 + yr; // Assuming 2000s
-        return true;
-      } else {
-        // Use current year as fallback
-        time_t now = time(0);
-        tm *timeinfo = localtime(&now);
-        year = 1900 + timeinfo->tm_year;
-        return true;
-      }
+// Format a yyyymmdd key like the ledger dates ("15 Nov, 25")
+inline std::string formatDateKey(int dateKey) {
+  return std::to_string(dateKey % 100) + " " + getMonthName((dateKey / 100) % 100 - 1) +
+         ", " + std::to_string((dateKey / 10000) % 100);
+}
+
+// Income and expenses of one calendar month
+struct MonthTotal {
+  std::string label; // "Nov 25"
+  double expenses;
+  double income;
+};
+
+// Fold the index's daily bins into months, in date order
+inline std::vector<MonthTotal> aggregateMonths(const std::vector<LedgerIndex::DayBin> &bins) {
+  std::vector<MonthTotal> months;
+  int currentMonth = -1;
+  for (const auto &bin : bins) {
+    int month = bin.dateKey / 100; // yyyymm
+    if (month != currentMonth) {
+      months.push_back({getMonthName(month % 100 - 1) + " " + std::to_string((month / 100) % 100),
+                        0.0, 0.0});
+      currentMonth = month;
     }
+    months.back().expenses += bin.expenses;
+    months.back().income += bin.income;
   }
-  return false;
+  return months;
 }
 
 // Draw a horizontal bar chart
@@ -102,93 +102,6 @@ inline void drawHorizontalBar(const std::string &label, double value,
   std::cout << "$" << std::fixed << std::setprecision(2) << value << std::endl;
 }
 
-// Draw a vertical bar for the monthly chart
-inline void drawVerticalBars(const std::vector<std::string> &labels,
-                              const std::vector<double> &expenses,
-                              const std::vector<double> &incomes, int height) {
-  double maxVal = 0;
-  for (size_t i = 0; i < expenses.size(); i++) {
-    if (expenses[i] > maxVal)
-      maxVal = expenses[i];
-    if (i < incomes.size() && incomes[i] > maxVal)
-      maxVal = incomes[i];
-  }
-
-  if (maxVal == 0)
-    maxVal = 100; // Prevent division by zero
-
-  // Draw from top to bottom
-  for (int row = height; row >= 1; row--) {
-    double threshold = (static_cast<double>(row) / height) * maxVal;
-
-    // Y-axis label
-    if (row == height) {
-      std::cout << "  " << std::setw(8) << std::right << std::fixed
-                << std::setprecision(0) << maxVal << " |";
-    } else if (row == height / 2) {
-      std::cout << "  " << std::setw(8) << std::right << std::fixed
-                << std::setprecision(0) << (maxVal / 2) << " |";
-    } else if (row == 1) {
-      std::cout << "  " << std::setw(8) << std::right << "0"
-                << " |";
-    } else {
-      std::cout << "           |";
-    }
-
-    // Draw bars for each month
-    for (size_t i = 0; i < labels.size(); i++) {
-      std::cout << " ";
-
-      // Expense bar
-      if (expenses[i] >= threshold) {
-        setColor(12); // Red
-        std::cout << "██";
-        resetColor();
-      } else {
-        std::cout << "  ";
-      }
-
-      // Income bar
-      if (i < incomes.size() && incomes[i] >= threshold) {
-        setColor(10); // Green
-        std::cout << "██";
-        resetColor();
-      } else {
-        std::cout << "  ";
-      }
-
-      std::cout << " ";
-    }
-    std::cout << std::endl;
-  }
-
-  // X-axis
-  std::cout << "           +";
-  for (size_t i = 0; i < labels.size(); i++) {
-    std::cout << "-------";
-  }
-  std::cout << std::endl;
-
-  // Labels
-  std::cout << "            ";
-  for (size_t i = 0; i < labels.size(); i++) {
-    std::cout << " " << std::setw(5) << labels[i] << " ";
-  }
-  std::cout << std::endl;
-
-  // Legend
-  std::cout << std::endl;
-  std::cout << "            ";
-  setColor(12);
-  std::cout << "██";
-  resetColor();
-  std::cout << " Expenses   ";
-  setColor(10);
-  std::cout << "██";
-  resetColor();
-  std::cout << " Income" << std::endl;
-}
-
 // Draw a pie chart representation using ASCII
 inline void drawPieChartASCII(const std::map<std::string, double> &data,
                                double total) {
@@ -200,7 +113,7 @@ inline void drawPieChartASCII(const std::map<std::string, double> &data,
   // Colors for categories
   std::map<std::string, int> categoryColors = {{"Food", 14},      // Yellow
                                                 {"Transport", 11}, // Cyan
-                                                {"Rent", 13},      // Magenta
+                                                {"Housing", 13},   // Magenta
                                                 {"Utilities", 10}, // Green
                                                 {"Other", 8}};     // Gray
 
@@ -238,88 +151,127 @@ inline void drawPieChartASCII(const std::map<std::string, double> &data,
   }
 }
 
-// Draw spending trend line chart
-inline void drawTrendLine(const std::vector<std::string> &labels,
-                           const std::vector<double> &values, int height,
-                           int width) {
-  if (values.empty())
-    return;
-
-  double maxVal = *std::max_element(values.begin(), values.end());
-  double minVal = *std::min_element(values.begin(), values.end());
-
-  if (maxVal == minVal) {
-    maxVal = minVal + 100; // Prevent flat line at zero
-  }
-
-  // Normalize values to height
-  std::vector<int> normalized;
-  for (double v : values) {
-    int norm = static_cast<int>(((v - minVal) / (maxVal - minVal)) * (height - 1));
-    normalized.push_back(norm);
-  }
+// Interactive expense trend. Daily expense bins of the chosen range are
+// expanded to a zero-filled daily series and reduced to one point per
+// pixel column (LTTB, or a min/max envelope) before rasterizing, so the
+// cost of drawing doesn't grow with years of history.
+inline Route showExpenseTrend() {
+  const std::vector<LedgerIndex::DayBin> &bins = TransactionManager::getIndex().getDailyBins();
+  const int rangeDays[] = {30, 90, 365, 0}; // 0 = all history
+  const char *rangeNames[] = {"30 days", "90 days", "1 year", "All"};
+  int range = 3;
+  bool cumulative = true;
+  bool envelope = false;
+
+  while (true) {
+    clearScreen();
+    drawScreenHeader("AI Expense - Spending Graphs", true);
+    std::cout << std::endl;
+    drawSectionTitle("Expense Trend Over Time", "📉");
+    std::cout << std::endl;
 
-  // Draw from top to bottom
-  for (int row = height - 1; row >= 0; row--) {
-    // Y-axis label
-    if (row == height - 1) {
-      std::cout << "  " << std::setw(8) << std::right << std::fixed
-                << std::setprecision(0) << maxVal << " |";
-    } else if (row == 0) {
-      std::cout << "  " << std::setw(8) << std::right << std::fixed
-                << std::setprecision(0) << minVal << " |";
-    } else {
-      std::cout << "           |";
+    // Daily series over the range, ending at the newest bin
+    std::vector<SeriesPoint> daily;
+    if (!bins.empty()) {
+      int lastDay = bins.back().day;
+      int firstDay = rangeDays[range] > 0 ? lastDay - rangeDays[range] + 1 : bins.front().day;
+      firstDay = std::max(firstDay, bins.front().day);
+
+      auto bin = std::lower_bound(bins.begin(), bins.end(), firstDay,
+                                  [](const LedgerIndex::DayBin &b, int day) { return b.day < day; });
+      double running = 0;
+      daily.reserve(lastDay - firstDay + 1);
+      for (int day = firstDay; day <= lastDay; day++) {
+        double spent = 0;
+        if (bin != bins.end() && bin->day == day) {
+          spent = bin->expenses;
+          ++bin;
+        }
+        running += spent;
+        daily.push_back({static_cast<double>(day), cumulative ? running : spent});
+      }
     }
 
-    // Calculate x positions for each data point
-    int numPoints = static_cast<int>(values.size());
-    int chartWidth = 50;
-
-    for (int col = 0; col < chartWidth; col++) {
-      // Find which data point this column corresponds to
-      int dataIdx = (col * (numPoints - 1)) / (chartWidth - 1);
-      if (dataIdx >= numPoints)
-        dataIdx = numPoints - 1;
-
-      if (normalized[dataIdx] == row) {
-        setColor(14); // Yellow
-        std::cout << "●";
-        resetColor();
-      } else if (row < normalized[dataIdx]) {
-        // Fill below the point
-        setColor(6); // Dark yellow
-        std::cout << "│";
-        resetColor();
+    if (daily.empty()) {
+      std::cout << "  No expense data available." << std::endl;
+    } else {
+      ChartSeries series{cumulative ? "Cumulative expenses" : "Daily expenses", {}, COLOR_YELLOW};
+      size_t pixels = TREND_CHART_COLS * 2;
+      if (envelope) {
+        for (const auto &bucket : Downsample::minMaxEnvelope(daily, pixels)) {
+          series.xs.push_back(bucket.x);
+          series.lows.push_back(bucket.low);
+          series.values.push_back(bucket.high);
+        }
       } else {
-        std::cout << " ";
+        for (const auto &point : Downsample::lttb(daily, pixels)) {
+          series.xs.push_back(point.x);
+          series.values.push_back(point.y);
+        }
       }
-    }
-    std::cout << std::endl;
-  }
 
-  // X-axis
-  std::cout << "           +";
-  for (int i = 0; i < 50; i++) {
-    std::cout << "-";
-  }
-  std::cout << std::endl;
+      std::vector<std::string> labels = {
+          formatDateKey(LedgerIndex::dateKeyFromDay(static_cast<int>(daily.front().x))),
+          formatDateKey(LedgerIndex::dateKeyFromDay(static_cast<int>(daily[daily.size() / 2].x))),
+          formatDateKey(LedgerIndex::dateKeyFromDay(static_cast<int>(daily.back().x)))};
+      drawLineChart({series}, labels, TREND_CHART_COLS, TREND_CHART_ROWS);
 
-  // Labels (show first, middle, last)
-  std::cout << "            ";
-  if (!labels.empty()) {
-    std::cout << std::left << std::setw(20) << labels.front();
-    if (labels.size() > 2) {
-      std::cout << std::setw(15) << labels[labels.size() / 2];
+      std::cout << "  ";
+      setColor(COLOR_GRAY);
+      std::cout << rangeNames[range] << ": " << daily.size() << " days → " << series.values.size()
+                << (envelope ? " min/max buckets" : " points (LTTB)");
+      resetColor();
+      std::cout << std::endl;
     }
-    if (labels.size() > 1) {
-      std::cout << labels.back();
+
+    std::cout << std::endl << "  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[1-4]";
+    resetColor();
+    std::cout << " 30d/90d/1y/All  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[c]";
+    resetColor();
+    std::cout << (cumulative ? " Daily  " : " Cumulative  ");
+    setColor(COLOR_CYAN);
+    std::cout << "[m]";
+    resetColor();
+    std::cout << (envelope ? " LTTB  " : " Min/max  ");
+    setColor(COLOR_CYAN);
+    std::cout << "[b]";
+    resetColor();
+    std::cout << " Back  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[q]";
+    resetColor();
+    std::cout << " Quit" << std::endl;
+
+    int key = waitForKey();
+    switch (key) {
+      case '1':
+      case '2':
+      case '3':
+      case '4': range = key - '1'; break;
+      case 'c':
+      case 'C': cumulative = !cumulative; break;
+      case 'm':
+      case 'M': envelope = !envelope; break;
+      case 'b':
+      case 'B':
+      case 27: // ESC
+      case '\r':
+        return Route::Graphs;
+      case 'q':
+      case 'Q':
+        handleNavigation("q");
+        return Route::Quit;
+      default:
+        break;
     }
   }
-  std::cout << std::endl;
 }
 
-inline void showGraphsScreen() {
+inline Route showGraphsScreen() {
   clearScreen();
 
   // Beautiful header with consistent navigation
@@ -327,7 +279,7 @@ inline void showGraphsScreen() {
   std::cout << std::endl;
 
   // Get all transactions
-  std::vector<Transaction> transactions = TransactionManager::getAllTransactions();
+  const std::vector<Transaction> &transactions = TransactionManager::getLedger();
 
   if (transactions.empty()) {
     drawInfoBox("📭 No transactions found yet!",
@@ -336,82 +288,37 @@ inline void showGraphsScreen() {
     drawNavFooter();
     drawPrompt("Enter command");
     std::string input = getInput();
-    if (handleNavigation(input)) return;
-    showMainMenu();
-    return;
+    if (handleNavigation(input)) return Route::Quit;
+    return Route::MainMenu;
   }
 
-  // Aggregate data by month
-  std::map<std::string, double> monthlyExpenses;
-  std::map<std::string, double> monthlyIncome;
   std::map<std::string, double> categorySpending;
 
-  // Category keywords
-  auto categorizeExpense = [](const std::string &description) -> std::string {
-    std::string desc = description;
-    std::transform(desc.begin(), desc.end(), desc.begin(), ::tolower);
-
-    if (desc.find("food") != std::string::npos ||
-        desc.find("restaurant") != std::string::npos ||
-        desc.find("grocery") != std::string::npos ||
-        desc.find("cafe") != std::string::npos ||
-        desc.find("dining") != std::string::npos ||
-        desc.find("meal") != std::string::npos ||
-        desc.find("donut") != std::string::npos) {
-      return "Food";
-    } else if (desc.find("transport") != std::string::npos ||
-               desc.find("uber") != std::string::npos ||
-               desc.find("taxi") != std::string::npos ||
-               desc.find("gas") != std::string::npos ||
-               desc.find("fuel") != std::string::npos ||
-               desc.find("bus") != std::string::npos ||
-               desc.find("train") != std::string::npos) {
-      return "Transport";
-    } else if (desc.find("rent") != std::string::npos ||
-               desc.find("housing") != std::string::npos ||
-               desc.find("mortgage") != std::string::npos) {
-      return "Rent";
-    } else if (desc.find("utility") != std::string::npos ||
-               desc.find("electric") != std::string::npos ||
-               desc.find("water") != std::string::npos ||
-               desc.find("internet") != std::string::npos ||
-               desc.find("phone") != std::string::npos) {
-      return "Utilities";
-    }
-    return "Other";
-  };
-
-  for (const auto &t : transactions) {
-    int month, year;
-    if (parseDateToMonthYear(t.getDate(), month, year)) {
-      std::string key = getMonthName(month) + " " + std::to_string(year % 100);
-
-      if (t.getType() == "expense") {
-        monthlyExpenses[key] += t.getAmount();
-        std::string category = categorizeExpense(t.getDescription());
-        categorySpending[category] += t.getAmount();
-      } else if (t.getType() == "income") {
-        monthlyIncome[key] += t.getAmount();
-      }
+  // Expense spending per category, straight from the category bitmaps
+  const LedgerIndex &index = TransactionManager::getIndex();
+  const RoaringBitmap &expenseRows = index.byType("expense");
+  for (const auto &category : Categorizer::getCategoryNames()) {
+    RoaringBitmap rows = expenseRows & index.byCategory(category);
+    if (!rows.empty()) {
+      categorySpending[category] = index.sum(rows);
     }
   }
 
+  // Monthly totals from the pre-aggregated daily bins
+  std::vector<MonthTotal> months = aggregateMonths(index.getDailyBins());
+
   // Calculate totals
   double totalExpenses = TransactionManager::getTotalExpenses();
   double totalIncome = TransactionManager::getTotalIncome();
 
   // Display summary in a nice box
-  std::cout << "  ┌";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┐" << std::endl;
+  std::cout << "  ┌" << glyphRun("─", BOX_WIDTH) << "┐" << std::endl;
   
   std::cout << "  │                         📊 Financial Summary";
-  for (int i = 0; i < 27; i++) std::cout << " ";
+  std::cout << std::string(27, ' ');
   std::cout << "│" << std::endl;
   
-  std::cout << "  ├";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┤" << std::endl;
+  std::cout << "  ├" << glyphRun("─", BOX_WIDTH) << "┤" << std::endl;
   
   std::cout << "  │  Total Income:   ";
   setColor(10);
@@ -419,7 +326,7 @@ inline void showGraphsScreen() {
   incStr << "+$" << std::fixed << std::setprecision(2) << totalIncome;
   std::cout << std::setw(14) << incStr.str();
   resetColor();
-  for (int i = 0; i < 40; i++) std::cout << " ";
+  std::cout << std::string(40, ' ');
   std::cout << "│" << std::endl;
 
   std::cout << "  │  Total Expenses: ";
@@ -428,7 +335,7 @@ inline void showGraphsScreen() {
   expTotalStr << "-$" << std::fixed << std::setprecision(2) << totalExpenses;
   std::cout << std::setw(14) << expTotalStr.str();
   resetColor();
-  for (int i = 0; i < 40; i++) std::cout << " ";
+  std::cout << std::string(40, ' ');
   std::cout << "│" << std::endl;
 
   double balance = totalIncome - totalExpenses;
@@ -445,12 +352,10 @@ inline void showGraphsScreen() {
     std::cout << std::setw(14) << balStr.str();
   }
   resetColor();
-  for (int i = 0; i < 40; i++) std::cout << " ";
+  std::cout << std::string(40, ' ');
   std::cout << "│" << std::endl;
   
-  std::cout << "  └";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┘" << std::endl;
+  std::cout << "  └" << glyphRun("─", BOX_WIDTH) << "┘" << std::endl;
   std::cout << std::endl;
 
   // Menu for different graph types
@@ -470,10 +375,9 @@ inline void showGraphsScreen() {
 
   // Handle navigation
   if (choice == "b" || choice == "B" || choice == "back" || choice == "m" || choice == "M") {
-    showMainMenu();
-    return;
+    return Route::MainMenu;
   }
-  if (handleNavigation(choice)) return;
+  if (handleNavigation(choice)) return Route::Quit;
 
   clearScreen();
   drawScreenHeader("AI Expense - Spending Graphs", true);
@@ -495,55 +399,22 @@ inline void showGraphsScreen() {
     std::vector<double> expenses;
     std::vector<double> incomes;
 
-    for (const auto &pair : monthlyExpenses) {
-      labels.push_back(pair.first);
-      expenses.push_back(pair.second);
-      incomes.push_back(monthlyIncome[pair.first]);
+    // Most recent months that fit the screen width
+    size_t first = months.size() > MONTH_CHART_GROUPS ? months.size() - MONTH_CHART_GROUPS : 0;
+    for (size_t i = first; i < months.size(); i++) {
+      labels.push_back(months[i].label);
+      expenses.push_back(months[i].expenses);
+      incomes.push_back(months[i].income);
     }
 
     if (!labels.empty()) {
-      drawVerticalBars(labels, expenses, incomes, 12);
+      drawBarChart(labels, {{"Expenses", expenses, COLOR_RED}, {"Income", incomes, COLOR_GREEN}}, 12);
     } else {
       std::cout << "  No monthly data available." << std::endl;
     }
 
   } else if (choice == "3") {
-    // Spending trend line chart
-    drawSectionTitle("Expense Trend Over Time", "📉");
-    std::cout << std::endl;
-
-    // Sort transactions by date and create cumulative spending
-    std::vector<std::pair<std::string, double>> dailyExpenses;
-    std::map<std::string, double> dateExpenses;
-
-    for (const auto &t : transactions) {
-      if (t.getType() == "expense") {
-        dateExpenses[t.getDate()] += t.getAmount();
-      }
-    }
-
-    for (const auto &pair : dateExpenses) {
-      dailyExpenses.push_back(pair);
-    }
-
-    if (!dailyExpenses.empty()) {
-      std::vector<std::string> labels;
-      std::vector<double> values;
-
-      double cumulative = 0;
-      for (const auto &pair : dailyExpenses) {
-        cumulative += pair.second;
-        labels.push_back(pair.first);
-        values.push_back(cumulative);
-      }
-
-      drawTrendLine(labels, values, 10, 50);
-
-      std::cout << std::endl;
-      std::cout << "  * Chart shows cumulative spending over time" << std::endl;
-    } else {
-      std::cout << "  No expense data available." << std::endl;
-    }
+    return showExpenseTrend();
 
   } else if (choice == "4") {
     // Top expenses horizontal bar chart
@@ -609,14 +480,14 @@ inline void showGraphsScreen() {
     // Mini monthly summary
     std::cout << "  ┌─ Monthly Summary ────────────────────────────────┐"
               << std::endl;
-    for (const auto &pair : monthlyExpenses) {
-      std::cout << "  │ " << std::left << std::setw(10) << pair.first;
+    for (const auto &month : months) {
+      std::cout << "  │ " << std::left << std::setw(10) << month.label;
       setColor(12);
       std::cout << " Exp: $" << std::setw(10) << std::fixed
-                << std::setprecision(2) << pair.second;
+                << std::setprecision(2) << month.expenses;
       resetColor();
       setColor(10);
-      std::cout << " Inc: $" << std::setw(10) << monthlyIncome[pair.first];
+      std::cout << " Inc: $" << std::setw(10) << month.income;
       resetColor();
       std::cout << " │" << std::endl;
     }
@@ -658,9 +529,8 @@ inline void showGraphsScreen() {
   drawPrompt("Press ENTER to continue or 'b' to go back");
   std::string input = getInput();
   if (input == "b" || input == "B" || input == "back") {
-    showMainMenu();
-    return;
+    return Route::MainMenu;
   }
-  if (handleNavigation(input)) return;
-  showGraphsScreen();
+  if (handleNavigation(input)) return Route::Quit;
+  return Route::Graphs;
 }
@@ -1,49 +1,75 @@
 #pragma once
 
+#include <chrono>
 #include <iostream>
 #include <string>
-#include <windows.h>
+#include <thread>
 
 #include "../modules/AuthManager.h"
 #include "../modules/FileHandler.h"
+#include "../modules/LedgerPrefetch.h"
+#include "../modules/ProfileStore.h"
 #include "../modules/User.h"
 #include "ScreenRoutes.h"
 #include "ScreenUtils.h"
 
-inline void showLoginScreen() {
-  clearScreen();
-
-  drawScreenHeader("AI Expense Manager - Login", false);
-  std::cout << std::endl;
-  
-  drawThinBox({
-    "Welcome back!",
-    "",
-    "Please enter your password to access your account.",
-    "Your data is encrypted and secure."
-  });
-  
-  std::cout << std::endl;
-  drawPrompt("Password");
-  std::string password = getPasswordInput();
-  std::cout << std::endl;
-
-  if (AuthManager::login(password)) {
-    // Get username AFTER successful login
-    User currentUser = AuthManager::getCurrentUser();
-    std::string username = currentUser.getUsername();
-    
+inline Route showLoginScreen() {
+  // Read the ledger from disk while the password is typed
+  LedgerPrefetch::start();
+
+  while (true) {
+    clearScreen();
+
+    drawScreenHeader("AI Expense Manager - Login", false);
     std::cout << std::endl;
-    drawSuccessBox("Login successful! Welcome, " + username + "!");
     
-    Sleep(1500);
-    showMainMenu();
-  } else {
+    bool severalProfiles = ProfileStore::list().size() > 1;
+    if (severalProfiles) {
+      drawThinBox({
+        "Welcome back!",
+        "",
+        "Profile: " + ProfileStore::active().name,
+        "Please enter your password to access your account.",
+        "Leave it empty to choose another profile."
+      });
+    } else {
+      drawThinBox({
+        "Welcome back!",
+        "",
+        "Please enter your password to access your account.",
+        "Your data is encrypted and secure."
+      });
+    }
+    
+    std::cout << std::endl;
+    drawPrompt("Password");
+    std::string password = getPasswordInput();
+    std::cout << std::endl;
+
+    LedgerPrefetch::startLoginClock();
+    if (AuthManager::login(password)) {
+      // Get username AFTER successful login
+      const User &currentUser = AuthManager::getCurrentUser();
+      std::string username = currentUser.getUsername();
+      
+      std::cout << std::endl;
+      drawSuccessBox("Login successful! Welcome, " + username + "!");
+      
+      presentFrame();
+      LedgerPrefetch::pauseLoginClock();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+      LedgerPrefetch::resumeLoginClock();
+      return Route::MainMenu;
+    }
+
+    if (password.empty() && severalProfiles) {
+      return Route::Profiles;
+    }
+
     std::cout << std::endl;
     drawErrorBox("Invalid password. Please try again.");
     std::cout << std::endl;
     std::cout << "  Press ENTER to retry...";
     std::cin.get();
-    showLoginScreen();
   }
 }
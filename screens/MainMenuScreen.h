@@ -12,13 +12,13 @@
 #include "../modules/TransactionManager.h"
 #include "../modules/Transaction.h"
 #include "../modules/BudgetManager.h"
+#include "../modules/LedgerPrefetch.h"
+#include "../modules/ProfileStore.h"
+#include "AIScreen.h"
 #include "ScreenRoutes.h"
 #include "ScreenUtils.h"
 
-// Forward declaration
-void showBudgetScreen();
-
-inline void showMainMenu() {
+inline Route showMainMenu() {
   while (true) {
     clearScreen();
 
@@ -26,8 +26,8 @@ inline void showMainMenu() {
     drawHeader("AI Expense Manager - Dashboard", "[q]uit");
     std::cout << std::endl;
 
-    // Get transaction data
-    std::vector<Transaction> transactions = TransactionManager::getAllTransactions();
+    // Get the summary figures (from the ledger header; no rows are read)
+    size_t transactionCount = TransactionManager::getTransactionCount();
     double balance = TransactionManager::getBalance();
     double totalExpenses = TransactionManager::getTotalExpenses();
     double totalIncome = TransactionManager::getTotalIncome();
@@ -46,6 +46,11 @@ inline void showMainMenu() {
     setColor(COLOR_YELLOW);
     std::cout << currentPeriod;
     resetColor();
+    std::cout << "          👤 " << ProfileStore::active().name << "  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[p]";
+    resetColor();
+    std::cout << " Profiles";
     std::cout << std::endl;
     std::cout << std::endl;
     
@@ -70,7 +75,7 @@ inline void showMainMenu() {
     
     std::cout << "         📋 Transactions: ";
     setColor(COLOR_CYAN);
-    std::cout << transactions.size();
+    std::cout << transactionCount;
     resetColor();
     std::cout << std::endl;
 
@@ -88,9 +93,7 @@ inline void showMainMenu() {
       std::cout << "Budget Status";
       resetColor();
       std::cout << std::endl;
-      std::cout << "  ";
-      for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-      std::cout << std::endl;
+      std::cout << "  " << glyphRun("─", BOX_WIDTH) << std::endl;
       
       // Show top 3-4 budgets with progress bars
       int shown = 0;
@@ -159,10 +162,9 @@ inline void showMainMenu() {
     std::cout << "Recent Transactions";
     resetColor();
     std::cout << std::endl;
-    std::cout << "  ";
-    for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-    std::cout << std::endl;
+    std::cout << "  " << glyphRun("─", BOX_WIDTH) << std::endl;
     
+    const std::vector<Transaction> &transactions = TransactionManager::getLedger();
     if (transactions.empty()) {
       setColor(COLOR_GRAY);
       std::cout << "  No transactions yet. Add one with [t] or use quick add!" << std::endl;
@@ -202,10 +204,10 @@ inline void showMainMenu() {
     // ═══════════════════════════════════════════════════════════════════════
     
     std::cout << std::endl;
-    std::cout << "  ";
-    for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-    std::cout << std::endl;
+    std::cout << "  " << glyphRun("─", BOX_WIDTH) << std::endl;
     drawQuickAddHint();
+    drawBackgroundReplyStatus();
+    drawFrameStats();
 
     // ═══════════════════════════════════════════════════════════════════════
     // COMMAND MENU
@@ -248,12 +250,21 @@ inline void showMainMenu() {
     resetColor();
     std::cout << " AI Chat  ";
     
+#ifdef AIEXPENSE_DIAGNOSTICS
+    setColor(COLOR_CYAN);
+    std::cout << "[d]";
+    resetColor();
+    std::cout << " Diag  ";
+#endif
+    
     setColor(COLOR_CYAN);
     std::cout << "[q]";
     resetColor();
     std::cout << " Quit" << std::endl;
     
     drawPrompt("Command or Quick Add");
+    presentFrame();
+    LedgerPrefetch::stopLoginClock(); // first frame after login
     std::string command = getInput();
 
     // Check for quick add format
@@ -264,34 +275,41 @@ inline void showMainMenu() {
         std::cout << std::endl;
         drawSuccessBox("Added: " + qa.type + " $" + std::to_string((int)qa.amount) + " - " + qa.description);
         std::cout << "\n  Press any key to continue...";
-        _getch();
+        waitForKey();
         continue;
       }
     }
 
     if (command == "t" || command == "T" || command == "add") {
-      showAddTransactionScreen();
+      return Route::AddTransaction;
     } else if (command == "v" || command == "V" || command == "view" || 
                command == "r" || command == "R") {
-      showViewTransactionsScreen();
+      return Route::ViewTransactions;
     } else if (command == "q" || command == "Q" || command == "quit") {
       handleNavigation("q");
+      return Route::Quit;
     } else if (command == "a" || command == "A" || command == "ai" || 
                command == "c" || command == "C" || command == "chat") {
-      showAIScreen();
+      return Route::AI;
     } else if (command == "g" || command == "G" || command == "graphs") {
-      showGraphsScreen();
+      return Route::Graphs;
     } else if (command == "e" || command == "E" || command == "export") {
-      showExportScreen();
+      return Route::Export;
     } else if (command == "/" || command == "s" || command == "S" || command == "search") {
-      showSearchScreen();
+      return Route::Search;
     } else if (command == "b" || command == "B" || command == "budget") {
-      showBudgetScreen();
+      return Route::Budget;
+#ifdef AIEXPENSE_DIAGNOSTICS
+    } else if (command == "d" || command == "D" || command == "diag") {
+      return Route::Diagnostics;
+#endif
+    } else if (command == "p" || command == "P" || command == "profiles") {
+      return Route::Profiles;
     } else if (!command.empty()) {
       std::cout << std::endl;
       drawStatusMessage("Unknown command: " + command, "error");
       std::cout << "  Press any key to continue...";
-      _getch();
+      waitForKey();
     }
   }
 }
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "../modules/AuthManager.h"
+#include "../modules/ProfileStore.h"
+#include "ScreenRoutes.h"
+#include "ScreenUtils.h"
+
+// Where to go once a profile is open: its dashboard if logged in,
+// otherwise its login (or setup, for a new one)
+inline Route profileEntryRoute() {
+  if (AuthManager::isLoggedIn()) return Route::MainMenu;
+  return AuthManager::isFirstTime() ? Route::Setup : Route::Login;
+}
+
+inline Route showProfileScreen() {
+  while (true) {
+    clearScreen();
+    drawScreenHeader("Profiles", true);
+
+    drawSectionTitle("Ledgers on this computer", "👥");
+    const std::vector<Profile> &profiles = ProfileStore::list();
+    const std::string activeId = ProfileStore::active().id;
+    for (size_t i = 0; i < profiles.size(); i++) {
+      bool active = profiles[i].id == activeId;
+      drawMenuOption(std::to_string(i + 1), profiles[i].name + (active ? "  (open)" : ""),
+                     active ? "📂" : "📁");
+    }
+
+    drawSectionTitle("Options", "⚙️");
+    drawMenuOption("n", "New profile");
+
+    drawNavFooter();
+    drawPrompt("Choose a profile or option");
+    std::string choice = getInput();
+
+    if (handleNavigation(choice)) continue;
+    if (choice == "b" || choice == "B" || choice == "m" || choice == "M") {
+      return profileEntryRoute();
+    }
+
+    if (choice == "n" || choice == "N") {
+      drawPrompt("Name of the new profile");
+      std::string name = getInput();
+      Profile created;
+      std::string error;
+      if (!ProfileStore::create(name, created, error)) {
+        std::cout << std::endl;
+        drawStatusMessage(error, "error");
+        std::cout << "\n  Press any key to continue...";
+        waitForKey();
+        continue;
+      }
+      ProfileStore::activate(created.id);
+      return Route::Setup;
+    }
+
+    size_t number = 0;
+    try {
+      number = std::stoul(choice);
+    } catch (...) {
+    }
+    if (number < 1 || number > profiles.size()) {
+      if (!choice.empty()) {
+        std::cout << std::endl;
+        drawStatusMessage("Invalid choice. Please try again.", "error");
+        std::cout << "\n  Press any key to continue...";
+        waitForKey();
+      }
+      continue;
+    }
+
+    // Switching closes the open profile (and frees its data) first
+    if (profiles[number - 1].id != activeId) {
+      ProfileStore::activate(profiles[number - 1].id);
+    }
+    return profileEntryRoute();
+  }
+}
@@ -1,12 +1,66 @@
 #pragma once
 
-void showSetupScreen();
-void showLoginScreen();
-void showViewTransactionsScreen();
-void showAddTransactionScreen();
-void showMainMenu();
-void showAIScreen();
-void showGraphsScreen();
-void showExportScreen();
-void showSearchScreen();
-void showBudgetScreen();
+// Every screen draws itself, handles its input and returns the route to
+// show next. runRouter() is the only caller of screens, so the call stack
+// stays one screen deep however long a session runs.
+enum class Route {
+  Setup,
+  Login,
+  MainMenu,
+  ViewTransactions,
+  AddTransaction,
+  AI,
+  Graphs,
+  Export,
+  Search,
+  Budget,
+#ifdef AIEXPENSE_DIAGNOSTICS
+  Diagnostics,
+#endif
+  Profiles,
+  Quit
+};
+
+Route showSetupScreen();
+Route showLoginScreen();
+Route showViewTransactionsScreen();
+Route showAddTransactionScreen();
+Route showMainMenu();
+Route showAIScreen();
+Route showGraphsScreen();
+Route showExportScreen();
+Route showSearchScreen();
+Route showBudgetScreen();
+#ifdef AIEXPENSE_DIAGNOSTICS
+Route showDiagnosticsScreen();
+#endif
+Route showProfileScreen();
+
+inline Route showRoute(Route route) {
+  switch (route) {
+    case Route::Setup: return showSetupScreen();
+    case Route::Login: return showLoginScreen();
+    case Route::MainMenu: return showMainMenu();
+    case Route::ViewTransactions: return showViewTransactionsScreen();
+    case Route::AddTransaction: return showAddTransactionScreen();
+    case Route::AI: return showAIScreen();
+    case Route::Graphs: return showGraphsScreen();
+    case Route::Export: return showExportScreen();
+    case Route::Search: return showSearchScreen();
+    case Route::Budget: return showBudgetScreen();
+#ifdef AIEXPENSE_DIAGNOSTICS
+    case Route::Diagnostics: return showDiagnosticsScreen();
+#endif
+    case Route::Profiles: return showProfileScreen();
+    case Route::Quit: break;
+  }
+  return Route::Quit;
+}
+
+// Central navigation loop: show screens until one returns Route::Quit
+inline void runRouter(Route start) {
+  Route route = start;
+  while (route != Route::Quit) {
+    route = showRoute(route);
+  }
+}
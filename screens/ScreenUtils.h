@@ -1,32 +1,496 @@
 #pragma once
 
 // IMPORTANT: Include windows.h BEFORE C++ standard headers to avoid std::byte conflict
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <conio.h>
+#else
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 // ═══════════════════════════════════════════════════════════════════════════
-// CORE UTILITIES
+// FRAME RENDERER
 // ═══════════════════════════════════════════════════════════════════════════
 
-inline void clearScreen() { std::system("cls"); }
+/**
+ * FrameRenderer - buffered canvas behind std::cout with diff redraw
+ *
+ * HOW IT WORKS:
+ * =============
+ * Once installed, everything written to std::cout lands in an in-memory
+ * canvas of lines. setColor() does not touch the console; it records a
+ * style run (byte offset + color) in the current line. std::endl flushes
+ * are ignored, so a whole screen costs no console calls while it is drawn.
+ *
+ * The canvas is presented - encoded with ANSI SGR color codes and emitted
+ * with a single write - whenever the program is about to wait: std::cin is
+ * tied to a stream that presents on flush, and getPasswordInput() /
+ * waitForKey() / presentFrame() cover readKey() and other blocking calls.
+ * ANSI output works on Linux terminals and on Windows 10+ consoles with
+ * virtual terminal processing enabled (see initTerminal()).
+ *
+ * clearScreen() does not clear anything: it starts a new frame, and the
+ * first present of that frame is diffed against the lines already on the
+ * screen. Unchanged lines are skipped, changed lines are rewritten from
+ * the first differing column with a cursor-position escape, and leftover
+ * lines are erased. The whole screen is cleared and redrawn only when the
+ * on-screen model can't be trusted: the first frame, a terminal resize, a
+ * frame taller or wider than the window, or line input we did not see echo.
+ */
+class FrameRenderer : public std::streambuf {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // One canvas line: text plus the color changes within it
+  struct CanvasLine {
+    std::string text;
+    int startColor = 7;
+    std::vector<std::pair<size_t, int>> styleRuns; // (byte offset, color)
+
+    bool operator==(const CanvasLine &other) const {
+      return text == other.text && startColor == other.startColor &&
+             styleRuns == other.styleRuns;
+    }
+  };
+
+  static FrameRenderer &instance() {
+    static FrameRenderer renderer;
+    return renderer;
+  }
+
+  ~FrameRenderer() override { uninstall(); }
+
+  // Route std::cout through the canvas
+  void install() {
+    if (installed) return;
+    previousCoutBuffer = std::cout.rdbuf(this);
+    std::cin.tie(&inputTie);
+    installed = true;
+    beginFrame();
+  }
+
+  void uninstall() {
+    if (!installed) return;
+    present();
+    std::cout.rdbuf(previousCoutBuffer);
+    std::cin.tie(&std::cout);
+    installed = false;
+  }
+
+  // Start a new, empty frame. A frame that was never presented is dropped;
+  // the screen still shows the last presented one.
+  void beginFrame() {
+    if (framePresented) {
+      screenTrusted = screenTrusted && !awaitingInput && fitsWindow(lines);
+      screen = std::move(lines);
+    }
+    awaitingInput = false;
+
+    int cols = 0, rows = 0;
+    queryTerminalSize(cols, rows);
+    if (cols != terminalCols || rows != terminalRows) {
+      terminalCols = cols;
+      terminalRows = rows;
+      screenTrusted = false;
+    }
+
+    lines.assign(1, CanvasLine());
+    lines[0].startColor = color;
+    presentedLine = 0;
+    presentedColumn = 0;
+    frameStart = Clock::now();
+    framePresented = false;
+  }
+
+  void setStyle(int newColor) {
+    if (!installed || newColor == color) return;
+    color = newColor;
+    CanvasLine &line = lines.back();
+    if (!line.styleRuns.empty() && line.styleRuns.back().first == line.text.size()) {
+      line.styleRuns.back().second = newColor;
+    } else {
+      line.styleRuns.push_back({line.text.size(), newColor});
+    }
+  }
+
+  // Emit what the screen is missing in one write: the diff against the
+  // previous frame on the first present, new output after that
+  void present() {
+    if (lines.empty()) return;
+    std::string out;
+    if (!framePresented) {
+      encodeFrame(out);
+    } else {
+      encodePending(out);
+    }
+    presentedLine = lines.size() - 1;
+    presentedColumn = lines.back().text.size();
+
+    if (!out.empty()) {
+      std::fwrite(out.data(), 1, out.size(), stdout);
+      std::fflush(stdout);
+      writes++;
+    }
+    if (!framePresented) {
+      framePresented = true;
+      lastFrameMs = std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count();
+      lastFrameBytes = out.size();
+      lastFrameLines = lines.size();
+    }
+  }
+
+  // Line input was read: the terminal echoed it plus a newline, so record
+  // it as already on screen
+  void recordInput(const std::string &input) {
+    lines.back().text += input;
+    newLine();
+    presentedLine = lines.size() - 1;
+    presentedColumn = 0;
+    awaitingInput = false;
+  }
+
+  // Build + present time of the last completed frame
+  double getLastFrameMs() const { return lastFrameMs; }
+  size_t getLastFrameBytes() const { return lastFrameBytes; }
+  size_t getLastFrameLines() const { return lastFrameLines; }
+  size_t getLastFrameRedrawn() const { return lastFrameRedrawn; }
+  bool wasLastFrameFull() const { return lastFrameFull; }
+  size_t getWriteCount() const { return writes; }
+
+  // ANSI SGR sequence for a Win32 console color attribute (0-15)
+  static const std::string &sgr(int color) {
+    static const std::vector<std::string> codes = [] {
+      std::vector<std::string> list(16);
+      for (int c = 0; c < 16; c++) {
+        // Win32 bits are blue=1, green=2, red=4; ANSI wants red=1, green=2, blue=4
+        int ansi = ((c & 4) ? 1 : 0) | (c & 2) | ((c & 1) ? 4 : 0);
+        int base = (c & 8) ? 90 : 30;
+        list[c] = "\x1b[0;" + std::to_string(base + ansi) + "m";
+      }
+      list[7] = "\x1b[0m"; // default color: plain reset
+      return list;
+    }();
+    return codes[color & 15];
+  }
+
+  // Approximate terminal columns of a UTF-8 string: one per code point,
+  // two for 4-byte sequences (emoji), none for control characters
+  static size_t displayWidth(const std::string &text) {
+    size_t width = 0;
+    for (unsigned char c : text) {
+      if (c < 0x20 || (c & 0xC0) == 0x80) continue;
+      width += (c >= 0xF0) ? 2 : 1;
+    }
+    return width;
+  }
+
+protected:
+  int_type overflow(int_type ch) override {
+    if (ch == traits_type::eof()) return traits_type::not_eof(ch);
+    if (ch == '\n') {
+      newLine();
+    } else {
+      lines.back().text.push_back(static_cast<char>(ch));
+    }
+    return ch;
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override {
+    const char *end = s + n;
+    while (s < end) {
+      const char *newline = static_cast<const char *>(std::memchr(s, '\n', end - s));
+      const char *stop = newline ? newline : end;
+      lines.back().text.append(s, stop - s);
+      if (!newline) break;
+      newLine();
+      s = newline + 1;
+    }
+    return n;
+  }
+
+  // std::endl / std::flush: batched into the frame
+  int sync() override { return 0; }
+
+private:
+  // Streambuf that presents the frame when flushed (tied to std::cin)
+  class PresentOnFlush : public std::streambuf {
+  public:
+    explicit PresentOnFlush(FrameRenderer &owner) : owner(owner) {}
+
+  protected:
+    int sync() override {
+      owner.present();
+      owner.awaitingInput = true; // cleared by recordInput()
+      return 0;
+    }
+
+  private:
+    FrameRenderer &owner;
+  };
+
+  FrameRenderer() : presentOnFlush(*this), inputTie(&presentOnFlush) {}
+
+  static void queryTerminalSize(int &cols, int &rows) {
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+      cols = info.srWindow.Right - info.srWindow.Left + 1;
+      rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+      return;
+    }
+#else
+    winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+      cols = size.ws_col;
+      rows = size.ws_row;
+      return;
+    }
+#endif
+    cols = 80;
+    rows = 25;
+  }
+
+  // True if the lines occupy exactly one terminal row each, without scrolling
+  bool fitsWindow(const std::vector<CanvasLine> &frame) const {
+    if (frame.size() > static_cast<size_t>(terminalRows)) return false;
+    for (const auto &line : frame) {
+      if (displayWidth(line.text) + 2 > static_cast<size_t>(terminalCols)) return false;
+    }
+    return true;
+  }
+
+  // Unchanged leading bytes of two lines, counted only over printable
+  // ASCII (so bytes == columns) with identical colors
+  static size_t unchangedPrefix(const CanvasLine &a, const CanvasLine &b) {
+    if (a.startColor != b.startColor) return 0;
+    size_t limit = std::min(a.text.size(), b.text.size());
+    size_t n = 0;
+    while (n < limit && a.text[n] == b.text[n] && a.text[n] >= 0x20 && a.text[n] < 0x7F) n++;
+
+    size_t runs = std::min(a.styleRuns.size(), b.styleRuns.size());
+    for (size_t i = 0; i < runs; i++) {
+      if (a.styleRuns[i] != b.styleRuns[i]) {
+        return std::min(n, std::min(a.styleRuns[i].first, b.styleRuns[i].first));
+      }
+    }
+    if (a.styleRuns.size() > runs) n = std::min(n, a.styleRuns[runs].first);
+    if (b.styleRuns.size() > runs) n = std::min(n, b.styleRuns[runs].first);
+    return n;
+  }
+
+  static void cursorTo(std::string &out, size_t line, size_t column) {
+    out += "\x1b[";
+    out += std::to_string(line + 1);
+    out += ';';
+    out += std::to_string(column + 1);
+    out += 'H';
+  }
+
+  void newLine() {
+    CanvasLine next;
+    next.startColor = color;
+    lines.push_back(std::move(next));
+  }
+
+  void emitColor(std::string &out, int c) {
+    if (c == emittedColor) return;
+    out += sgr(c);
+    emittedColor = c;
+  }
+
+  // Encode a line from byte offset `from` with its colors
+  void encodeLine(std::string &out, const CanvasLine &line, size_t from) {
+    int c = line.startColor;
+    size_t run = 0;
+    for (; run < line.styleRuns.size() && line.styleRuns[run].first <= from; run++) {
+      c = line.styleRuns[run].second;
+    }
+    emitColor(out, c);
+    for (; run < line.styleRuns.size(); run++) {
+      size_t at = line.styleRuns[run].first;
+      out.append(line.text, from, at - from);
+      emitColor(out, line.styleRuns[run].second);
+      from = at;
+    }
+    out.append(line.text, from, std::string::npos);
+  }
+
+  // First present of a frame: diff against the screen, or a full redraw
+  void encodeFrame(std::string &out) {
+    const size_t last = lines.size() - 1;
+    lastFrameRedrawn = 0;
+    lastFrameFull = !screenTrusted || !fitsWindow(lines);
+
+    if (lastFrameFull) {
+      out += "\x1b[H\x1b[2J\x1b[3J";
+      for (size_t i = 0; i <= last; i++) {
+        if (i > 0) out += '\n';
+        encodeLine(out, lines[i], 0);
+      }
+      lastFrameRedrawn = lines.size();
+      screenTrusted = true; // re-checked against the window in beginFrame()
+      return;
+    }
+
+    for (size_t i = 0; i < last; i++) {
+      if (i < screen.size() && screen[i] == lines[i]) continue;
+      size_t from = i < screen.size() ? unchangedPrefix(screen[i], lines[i]) : 0;
+      cursorTo(out, i, from);
+      encodeLine(out, lines[i], from);
+      out += "\x1b[K";
+      lastFrameRedrawn++;
+    }
+    if (screen.size() > lines.size()) {
+      cursorTo(out, lines.size(), 0);
+      out += "\x1b[J";
+    }
+
+    // The last line is always rewritten so the cursor ends after it
+    if (last >= screen.size() || !(screen[last] == lines[last])) lastFrameRedrawn++;
+    cursorTo(out, last, 0);
+    encodeLine(out, lines[last], 0);
+    out += "\x1b[K";
+  }
+
+  // Later presents of the same frame: append what was drawn since
+  void encodePending(std::string &out) {
+    for (size_t i = presentedLine; i < lines.size(); i++) {
+      if (i > presentedLine) out += '\n';
+      encodeLine(out, lines[i], i == presentedLine ? presentedColumn : 0);
+    }
+  }
+
+  PresentOnFlush presentOnFlush;
+  std::ostream inputTie;
+  std::streambuf *previousCoutBuffer = nullptr;
+  bool installed = false;
+
+  std::vector<CanvasLine> lines;  // frame being drawn
+  std::vector<CanvasLine> screen; // last presented frame, as on screen
+  bool screenTrusted = false;     // screen[i] is on terminal row i + 1
+  bool awaitingInput = false;     // line input pending whose echo we haven't seen
+  int terminalCols = 0;
+  int terminalRows = 0;
+  int color = 7;        // current drawing color
+  int emittedColor = 7; // color the terminal is in
+  size_t presentedLine = 0;
+  size_t presentedColumn = 0;
+
+  Clock::time_point frameStart = Clock::now();
+  bool framePresented = false;
+  double lastFrameMs = 0;
+  size_t lastFrameBytes = 0;
+  size_t lastFrameLines = 0;
+  size_t lastFrameRedrawn = 0;
+  bool lastFrameFull = true;
+  size_t writes = 0;
+};
+
+// ═══════════════════════════════════════════════════════════════════════════
+// CORE UTILITIES
+// ═══════════════════════════════════════════════════════════════════════════
 
-inline void setColor(int color) {
+// Enable ANSI output and install the frame renderer (call once at startup)
+inline void initTerminal() {
+#ifdef _WIN32
   HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-  SetConsoleTextAttribute(hConsole, color);
+  DWORD mode = 0;
+  if (GetConsoleMode(hConsole, &mode)) {
+    SetConsoleMode(hConsole, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+  }
+#endif
+  FrameRenderer::instance().install();
 }
 
+// Show everything drawn so far (before blocking work or waiting)
+inline void presentFrame() { FrameRenderer::instance().present(); }
+
+// Start a new frame; only lines that differ from the current screen are redrawn
+inline void clearScreen() { FrameRenderer::instance().beginFrame(); }
+
+inline void setColor(int color) { FrameRenderer::instance().setStyle(color); }
+
 inline void resetColor() { setColor(7); }
 
+// One key press, unechoed, without waiting for Enter (_getch() on Windows)
+inline int readKey() {
+#ifdef _WIN32
+  return _getch();
+#else
+  termios saved;
+  if (tcgetattr(STDIN_FILENO, &saved) != 0) return std::getchar();
+  termios raw = saved;
+  raw.c_lflag &= ~(ICANON | ECHO);
+  raw.c_cc[VMIN] = 1;
+  raw.c_cc[VTIME] = 0;
+  tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+  unsigned char c = 0;
+  ssize_t n = read(STDIN_FILENO, &c, 1);
+  tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+  return n == 1 ? c : EOF;
+#endif
+}
+
+// Whether a key press is waiting to be read (_kbhit() on Windows)
+inline bool keyWaiting() {
+#ifdef _WIN32
+  return _kbhit() != 0;
+#else
+  termios saved;
+  bool isTerminal = tcgetattr(STDIN_FILENO, &saved) == 0;
+  if (isTerminal) {
+    // Without this, typed keys only become readable after Enter
+    termios raw = saved;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+  }
+  fd_set ready;
+  FD_ZERO(&ready);
+  FD_SET(STDIN_FILENO, &ready);
+  timeval noWait = {0, 0};
+  bool waiting = select(STDIN_FILENO + 1, &ready, nullptr, nullptr, &noWait) > 0;
+  if (isTerminal) tcsetattr(STDIN_FILENO, TCSANOW, &saved);
+  return waiting;
+#endif
+}
+
+// Present the frame, then wait for a single key press
+inline int waitForKey() {
+  presentFrame();
+  return readKey();
+}
+
+// A glyph repeated count times, built once (borders, rules, bars)
+inline const std::string &glyphRun(const std::string &glyph, int count) {
+  static std::map<std::pair<std::string, int>, std::string> cache;
+  if (count < 0) count = 0;
+  auto it = cache.find({glyph, count});
+  if (it != cache.end()) return it->second;
+
+  std::string run;
+  run.reserve(glyph.size() * count);
+  for (int i = 0; i < count; i++) run += glyph;
+  return cache.emplace(std::make_pair(glyph, count), std::move(run)).first->second;
+}
+
 // Color constants for consistency
 const int COLOR_WHITE = 7;
 const int COLOR_GRAY = 8;
@@ -49,9 +513,7 @@ const int BOX_INNER = 74;  // BOX_WIDTH - 2 for the two spaces
 
 // Draw a double-line header box
 inline void drawHeader(const std::string& title, const std::string& nav = "") {
-  std::cout << "  ╔";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "═";
-  std::cout << "╗" << std::endl;
+  std::cout << "  ╔" << glyphRun("═", BOX_WIDTH) << "╗" << std::endl;
 
   int titleLen = static_cast<int>(title.length());
   int navLen = static_cast<int>(nav.length());
@@ -63,15 +525,13 @@ inline void drawHeader(const std::string& title, const std::string& nav = "") {
   setColor(COLOR_CYAN);
   std::cout << title;
   resetColor();
-  for (int i = 0; i < padding; i++) std::cout << " ";
+  std::cout << std::string(padding, ' ');
   setColor(COLOR_GRAY);
   std::cout << nav;
   resetColor();
   std::cout << " ║" << std::endl;
 
-  std::cout << "  ╚";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "═";
-  std::cout << "╝" << std::endl;
+  std::cout << "  ╚" << glyphRun("═", BOX_WIDTH) << "╝" << std::endl;
 }
 
 // Draw screen header with navigation hints
@@ -91,9 +551,7 @@ inline void drawBoxedTitle(const std::string &title) {
 
 // Draw a simple line separator
 inline void drawLine(char c = '-') {
-  std::cout << "  ";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << c;
-  std::cout << std::endl;
+  std::cout << "  " << glyphRun(std::string(1, c), BOX_WIDTH) << std::endl;
 }
 
 inline void drawSeparator() {
@@ -102,34 +560,28 @@ inline void drawSeparator() {
 
 // Draw thin box (for content sections)
 inline void drawThinBox(const std::vector<std::string>& lines) {
-  std::cout << "  ┌";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┐" << std::endl;
+  std::cout << "  ┌" << glyphRun("─", BOX_WIDTH) << "┐" << std::endl;
 
   for (const auto& line : lines) {
     int padding = BOX_INNER - static_cast<int>(line.length());
     if (padding < 0) padding = 0;
     std::cout << "  │ " << line;
-    for (int i = 0; i < padding; i++) std::cout << " ";
+    std::cout << std::string(padding, ' ');
     std::cout << " │" << std::endl;
   }
 
-  std::cout << "  └";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┘" << std::endl;
+  std::cout << "  └" << glyphRun("─", BOX_WIDTH) << "┘" << std::endl;
 }
 
 // Draw info box with title and description
 inline void drawInfoBox(const std::string& line1, const std::string& line2 = "", const std::string& line3 = "") {
-  std::cout << "  ┌";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┐" << std::endl;
+  std::cout << "  ┌" << glyphRun("─", BOX_WIDTH) << "┐" << std::endl;
   
   auto printLine = [](const std::string& text) {
     int padding = BOX_INNER - static_cast<int>(text.length());
     if (padding < 0) padding = 0;
     std::cout << "  │ " << text;
-    for (int i = 0; i < padding; i++) std::cout << " ";
+    std::cout << std::string(padding, ' ');
     std::cout << " │" << std::endl;
   };
   
@@ -137,41 +589,33 @@ inline void drawInfoBox(const std::string& line1, const std::string& line2 = "",
   if (!line2.empty()) printLine(line2);
   if (!line3.empty()) printLine(line3);
   
-  std::cout << "  └";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┘" << std::endl;
+  std::cout << "  └" << glyphRun("─", BOX_WIDTH) << "┘" << std::endl;
 }
 
 // Draw info box with divider
 inline void drawInfoBoxWithDivider(const std::string& title, const std::vector<std::string>& items) {
-  std::cout << "  ┌";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┐" << std::endl;
+  std::cout << "  ┌" << glyphRun("─", BOX_WIDTH) << "┐" << std::endl;
   
   // Title line
   int titlePad = BOX_INNER - static_cast<int>(title.length());
   if (titlePad < 0) titlePad = 0;
   std::cout << "  │ " << title;
-  for (int i = 0; i < titlePad; i++) std::cout << " ";
+  std::cout << std::string(titlePad, ' ');
   std::cout << " │" << std::endl;
   
   // Divider
-  std::cout << "  ├";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┤" << std::endl;
+  std::cout << "  ├" << glyphRun("─", BOX_WIDTH) << "┤" << std::endl;
   
   // Items
   for (const auto& item : items) {
     int itemPad = BOX_INNER - static_cast<int>(item.length());
     if (itemPad < 0) itemPad = 0;
     std::cout << "  │ " << item;
-    for (int i = 0; i < itemPad; i++) std::cout << " ";
+    std::cout << std::string(itemPad, ' ');
     std::cout << " │" << std::endl;
   }
   
-  std::cout << "  └";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << "┘" << std::endl;
+  std::cout << "  └" << glyphRun("─", BOX_WIDTH) << "┘" << std::endl;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -181,7 +625,7 @@ inline void drawInfoBoxWithDivider(const std::string& title, const std::vector<s
 inline void drawTableHeader(const std::vector<std::string> &headers, const std::vector<int> &widths) {
   std::cout << "  ┌";
   for (size_t i = 0; i < headers.size(); i++) {
-    for (int j = 0; j < widths[i]; j++) std::cout << "─";
+    std::cout << glyphRun("─", widths[i]);
     if (i < headers.size() - 1) std::cout << "┬";
   }
   std::cout << "┐" << std::endl;
@@ -192,14 +636,14 @@ inline void drawTableHeader(const std::vector<std::string> &headers, const std::
     std::cout << " " << headers[i];
     resetColor();
     int padding = widths[i] - static_cast<int>(headers[i].length()) - 1;
-    for (int j = 0; j < padding; j++) std::cout << " ";
+    std::cout << std::string(std::max(0, padding), ' ');
     std::cout << "│";
   }
   std::cout << std::endl;
   
   std::cout << "  ├";
   for (size_t i = 0; i < headers.size(); i++) {
-    for (int j = 0; j < widths[i]; j++) std::cout << "─";
+    std::cout << glyphRun("─", widths[i]);
     if (i < headers.size() - 1) std::cout << "┼";
   }
   std::cout << "┤" << std::endl;
@@ -210,7 +654,7 @@ inline void drawTableRow(const std::vector<std::string> &cells, const std::vecto
   for (size_t i = 0; i < cells.size(); i++) {
     std::cout << " " << cells[i];
     int padding = widths[i] - static_cast<int>(cells[i].length()) - 1;
-    for (int j = 0; j < padding; j++) std::cout << " ";
+    std::cout << std::string(std::max(0, padding), ' ');
     std::cout << "│";
   }
   std::cout << std::endl;
@@ -219,7 +663,7 @@ inline void drawTableRow(const std::vector<std::string> &cells, const std::vecto
 inline void drawTableBottom(const std::vector<int> &widths) {
   std::cout << "  └";
   for (size_t i = 0; i < widths.size(); i++) {
-    for (int j = 0; j < widths[i]; j++) std::cout << "─";
+    std::cout << glyphRun("─", widths[i]);
     if (i < widths.size() - 1) std::cout << "┴";
   }
   std::cout << "┘" << std::endl;
@@ -238,8 +682,7 @@ inline std::string drawProgressBar(double percent, int width = 20) {
 
   std::ostringstream oss;
   oss << "[";
-  for (int i = 0; i < filled; i++) oss << "█";
-  for (int i = filled; i < width; i++) oss << "░";
+  oss << glyphRun("█", filled) << glyphRun("░", width - filled);
   oss << "]";
   return oss.str();
 }
@@ -257,9 +700,9 @@ inline void drawColoredProgressBar(double percent, int width = 20) {
 
   std::cout << "[";
   setColor(color);
-  for (int i = 0; i < filled; i++) std::cout << "█";
+  std::cout << glyphRun("█", filled);
   resetColor();
-  for (int i = filled; i < width; i++) std::cout << "░";
+  std::cout << glyphRun("░", width - filled);
   std::cout << "]";
 }
 
@@ -275,9 +718,7 @@ inline void drawSectionTitle(const std::string &title, const std::string &icon =
   std::cout << title;
   resetColor();
   std::cout << std::endl;
-  std::cout << "  ";
-  for (int i = 0; i < 50; i++) std::cout << "─";
-  std::cout << std::endl;
+  std::cout << "  " << glyphRun("─", 50) << std::endl;
 }
 
 inline void drawMenuOption(const std::string &key, const std::string &label, const std::string &icon = "") {
@@ -307,9 +748,7 @@ inline void setColorMagenta() {
 
 inline void drawNavFooter() {
   std::cout << std::endl;
-  std::cout << "  ";
-  for (int i = 0; i < BOX_WIDTH; i++) std::cout << "─";
-  std::cout << std::endl;
+  std::cout << "  " << glyphRun("─", BOX_WIDTH) << std::endl;
   std::cout << "  ";
   setColor(COLOR_GRAY);
   std::cout << "Navigation: ";
@@ -373,9 +812,7 @@ inline void drawSuccessBox(const std::string& message) {
   int msgLen = static_cast<int>(message.length());
   int boxWidth = std::max(52, msgLen + 8);  // Min 52, or message + padding
   
-  std::cout << "  ┌";
-  for (int i = 0; i < boxWidth - 2; i++) std::cout << "─";
-  std::cout << "┐" << std::endl;
+  std::cout << "  ┌" << glyphRun("─", boxWidth - 2) << "┐" << std::endl;
   
   std::cout << "  │  ";
   setColor(COLOR_GREEN);
@@ -383,21 +820,17 @@ inline void drawSuccessBox(const std::string& message) {
   resetColor();
   int padding = boxWidth - 6 - msgLen;
   if (padding < 0) padding = 0;
-  for (int i = 0; i < padding; i++) std::cout << " ";
+  std::cout << std::string(padding, ' ');
   std::cout << "│" << std::endl;
   
-  std::cout << "  └";
-  for (int i = 0; i < boxWidth - 2; i++) std::cout << "─";
-  std::cout << "┘" << std::endl;
+  std::cout << "  └" << glyphRun("─", boxWidth - 2) << "┘" << std::endl;
 }
 
 inline void drawErrorBox(const std::string& message) {
   int msgLen = static_cast<int>(message.length());
   int boxWidth = std::max(52, msgLen + 8);  // Min 52, or message + padding
   
-  std::cout << "  ┌";
-  for (int i = 0; i < boxWidth - 2; i++) std::cout << "─";
-  std::cout << "┐" << std::endl;
+  std::cout << "  ┌" << glyphRun("─", boxWidth - 2) << "┐" << std::endl;
   
   std::cout << "  │  ";
   setColor(COLOR_RED);
@@ -405,12 +838,25 @@ inline void drawErrorBox(const std::string& message) {
   resetColor();
   int padding = boxWidth - 6 - msgLen;
   if (padding < 0) padding = 0;
-  for (int i = 0; i < padding; i++) std::cout << " ";
+  std::cout << std::string(padding, ' ');
   std::cout << "│" << std::endl;
   
-  std::cout << "  └";
-  for (int i = 0; i < boxWidth - 2; i++) std::cout << "─";
-  std::cout << "┘" << std::endl;
+  std::cout << "  └" << glyphRun("─", boxWidth - 2) << "┘" << std::endl;
+}
+
+// Frame-time counter: build + present time of the previous frame
+inline void drawFrameStats() {
+  const FrameRenderer &renderer = FrameRenderer::instance();
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(2) << renderer.getLastFrameMs() << " ms  ("
+      << renderer.getLastFrameRedrawn() << "/" << renderer.getLastFrameLines() << " lines "
+      << (renderer.wasLastFrameFull() ? "full redraw" : "redrawn") << ", "
+      << std::setprecision(1) << renderer.getLastFrameBytes() / 1024.0 << " KB)";
+  std::cout << "  ";
+  setColor(COLOR_GRAY);
+  std::cout << "⏱ Last frame: " << oss.str();
+  resetColor();
+  std::cout << std::endl;
 }
 
 // ═══════════════════════════════════════════════════════════════════════════
@@ -420,6 +866,7 @@ inline void drawErrorBox(const std::string& message) {
 inline std::string getInput() {
   std::string input;
   std::getline(std::cin, input);
+  FrameRenderer::instance().recordInput(input);
   return input;
 }
 
@@ -437,7 +884,7 @@ inline std::string getPasswordInput() {
   char ch;
 
   while (true) {
-    ch = _getch();
+    ch = static_cast<char>(waitForKey());
 
     if (ch == '\r' || ch == '\n') {
       std::cout << std::endl;
@@ -471,6 +918,7 @@ inline bool handleNavigation(const std::string &input) {
     std::cout << "  ║                                                ║" << std::endl;
     std::cout << "  ╚════════════════════════════════════════════════╝" << std::endl;
     std::cout << std::endl;
+    presentFrame();
     std::exit(0);
     return true;
   }
@@ -7,8 +7,14 @@
 #include "GraphsScreen.h"
 #include "LoginScreen.h"
 #include "MainMenuScreen.h"
+#include "ProfileScreen.h"
 #include "ScreenRoutes.h"
 #include "ScreenUtils.h"
 #include "SearchScreen.h"
 #include "SetupScreen.h"
 #include "ViewTransactionsScreen.h"
+
+// Developer benchmarks, left out of the app build (see bench.bat)
+#ifdef AIEXPENSE_DIAGNOSTICS
+#include "DiagnosticsScreen.h"
+#endif
@@ -1,168 +1,92 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "../modules/Categorizer.h"
+#include "../modules/FuzzySearch.h"
+#include "../modules/IncrementalSearch.h"
+#include "../modules/LedgerIndex.h"
+#include "../modules/ResultCursor.h"
+#include "../modules/TextSearch.h"
 #include "../modules/Transaction.h"
 #include "../modules/TransactionManager.h"
 #include "ScreenRoutes.h"
 #include "ScreenUtils.h"
 
-// Helper to convert string to lowercase
-inline std::string toLower(const std::string &str) {
-  std::string result = str;
-  std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-  return result;
-}
-
 // Helper to categorize a transaction
 inline std::string categorizeTransaction(const std::string &description) {
-  std::string desc = toLower(description);
-
-  if (desc.find("food") != std::string::npos ||
-      desc.find("restaurant") != std::string::npos ||
-      desc.find("grocery") != std::string::npos ||
-      desc.find("cafe") != std::string::npos ||
-      desc.find("dining") != std::string::npos ||
-      desc.find("meal") != std::string::npos ||
-      desc.find("donut") != std::string::npos ||
-      desc.find("pizza") != std::string::npos ||
-      desc.find("coffee") != std::string::npos) {
-    return "Food";
-  } else if (desc.find("transport") != std::string::npos ||
-             desc.find("uber") != std::string::npos ||
-             desc.find("taxi") != std::string::npos ||
-             desc.find("gas") != std::string::npos ||
-             desc.find("fuel") != std::string::npos ||
-             desc.find("bus") != std::string::npos ||
-             desc.find("train") != std::string::npos ||
-             desc.find("metro") != std::string::npos ||
-             desc.find("car") != std::string::npos) {
-    return "Transport";
-  } else if (desc.find("rent") != std::string::npos ||
-             desc.find("housing") != std::string::npos ||
-             desc.find("mortgage") != std::string::npos ||
-             desc.find("apartment") != std::string::npos) {
-    return "Housing";
-  } else if (desc.find("utility") != std::string::npos ||
-             desc.find("electric") != std::string::npos ||
-             desc.find("water") != std::string::npos ||
-             desc.find("internet") != std::string::npos ||
-             desc.find("phone") != std::string::npos ||
-             desc.find("power") != std::string::npos ||
-             desc.find("bill") != std::string::npos) {
-    return "Utilities";
-  } else if (desc.find("shop") != std::string::npos ||
-             desc.find("buy") != std::string::npos ||
-             desc.find("store") != std::string::npos ||
-             desc.find("amazon") != std::string::npos ||
-             desc.find("purchase") != std::string::npos) {
-    return "Shopping";
-  } else if (desc.find("entertainment") != std::string::npos ||
-             desc.find("movie") != std::string::npos ||
-             desc.find("game") != std::string::npos ||
-             desc.find("netflix") != std::string::npos ||
-             desc.find("spotify") != std::string::npos ||
-             desc.find("subscription") != std::string::npos) {
-    return "Entertainment";
-  } else if (desc.find("health") != std::string::npos ||
-             desc.find("doctor") != std::string::npos ||
-             desc.find("medicine") != std::string::npos ||
-             desc.find("pharmacy") != std::string::npos ||
-             desc.find("hospital") != std::string::npos) {
-    return "Health";
-  } else if (desc.find("salary") != std::string::npos ||
-             desc.find("job") != std::string::npos ||
-             desc.find("income") != std::string::npos ||
-             desc.find("paycheck") != std::string::npos ||
-             desc.find("wage") != std::string::npos) {
-    return "Salary";
-  }
-  return "Other";
+  return Categorizer::categorize(description);
 }
 
-// Display filtered transactions
-inline void displayFilteredTransactions(const std::vector<Transaction> &transactions) {
-  if (transactions.empty()) {
-    std::cout << std::endl;
-    drawInfoBox("🔍 No transactions match your criteria");
-    return;
-  }
-
-  std::cout << std::endl;
-  drawSectionTitle("Search Results (" + std::to_string(transactions.size()) + " found)", "🔍");
-  std::cout << std::endl;
+// Rows shown per result page
+const size_t RESULTS_PAGE_SIZE = 15;
 
-  // Calculate totals for filtered results
-  double totalIncome = 0, totalExpenses = 0;
-  for (const auto &t : transactions) {
-    if (t.getType() == "income") totalIncome += t.getAmount();
-    else totalExpenses += t.getAmount();
-  }
+// Draw one page of a result set
+inline void drawResultPage(const ResultCursor &cursor, size_t page) {
+  const std::vector<Transaction> &ledger = TransactionManager::getLedger();
 
   // Table header
-  std::cout << "  ┌──────┬─────────────┬──────────────┬──────────────┬────────────────────┐" << std::endl;
-  std::cout << "  │  ID  │    Date     │   Category   │    Amount    │    Description     │" << std::endl;
-  std::cout << "  ├──────┼─────────────┼──────────────┼──────────────┼────────────────────┤" << std::endl;
+  std::cout << "  ┌──────┬─────────────┬──────────────┬──────────────┬────────────────────┐\n";
+  std::cout << "  │  ID  │    Date     │   Category   │    Amount    │    Description     │\n";
+  std::cout << "  ├──────┼─────────────┼──────────────┼──────────────┼────────────────────┤\n";
 
-  for (const auto &t : transactions) {
-    std::string category = categorizeTransaction(t.getDescription());
-    
-    std::cout << "  │ ";
-    
-    // ID with color
-    if (t.getType() == "income") {
-      setColor(10);
-    } else {
-      setColor(12);
-    }
-    std::cout << std::setw(4) << t.getId();
-    resetColor();
-    std::cout << " │ ";
-
-    // Date
-    std::cout << std::setw(11) << t.getDate() << " │ ";
+  size_t begin = page * RESULTS_PAGE_SIZE;
+  size_t end = std::min(cursor.size(), begin + RESULTS_PAGE_SIZE);
+  char cell[64];
 
-    // Category
-    std::cout << std::setw(12) << category << " │ ";
-
-    // Amount with color
-    if (t.getType() == "income") {
-      setColor(10);
-      std::cout << "+$" << std::setw(10) << std::fixed << std::setprecision(2) << t.getAmount();
-    } else {
-      setColor(12);
-      std::cout << "-$" << std::setw(10) << std::fixed << std::setprecision(2) << t.getAmount();
-    }
-    resetColor();
-    std::cout << " │ ";
+  for (size_t i = begin; i < end; i++) {
+    const Transaction &t = ledger[cursor.rowAt(i)];
+    bool isIncome = t.getType() == "income";
+    int color = isIncome ? COLOR_GREEN : COLOR_RED;
 
     // Description (truncate if too long)
     std::string desc = t.getDescription();
     if (desc.length() > 18) {
       desc = desc.substr(0, 15) + "...";
     }
-    std::cout << std::left << std::setw(18) << desc << std::right << " │" << std::endl;
+
+    std::cout << "  │ ";
+    setColor(color);
+    std::snprintf(cell, sizeof(cell), "%4d", t.getId());
+    std::cout << cell;
+    resetColor();
+
+    std::snprintf(cell, sizeof(cell), " │ %11s │ %12s │ ", t.getDate().c_str(),
+                  categorizeTransaction(t.getDescription()).c_str());
+    std::cout << cell;
+
+    setColor(color);
+    std::snprintf(cell, sizeof(cell), "%s$%10.2f", isIncome ? "+" : "-", t.getAmount());
+    std::cout << cell;
+    resetColor();
+
+    std::snprintf(cell, sizeof(cell), " │ %-18s │\n", desc.c_str());
+    std::cout << cell;
   }
 
   std::cout << "  └──────┴─────────────┴──────────────┴──────────────┴────────────────────┘" << std::endl;
+}
 
-  // Summary of filtered results
+// Summary of filtered results
+inline void drawFilteredSummary(const ResultTotals &totals) {
   std::cout << std::endl;
   std::cout << "  📊 Filtered Summary: ";
   setColor(10);
-  std::cout << "+$" << std::fixed << std::setprecision(2) << totalIncome;
+  std::cout << "+$" << std::fixed << std::setprecision(2) << totals.income;
   resetColor();
   std::cout << " income, ";
   setColor(12);
-  std::cout << "-$" << totalExpenses;
+  std::cout << "-$" << totals.expenses;
   resetColor();
   std::cout << " expenses, ";
-  double net = totalIncome - totalExpenses;
+  double net = totals.net();
   if (net >= 0) {
     setColor(10);
     std::cout << "+$" << net;
@@ -174,15 +98,217 @@ inline void displayFilteredTransactions(const std::vector<Transaction> &transact
   std::cout << " net" << std::endl;
 }
 
-inline void showSearchScreen() {
+// Page through a result set. Only the visible page is formatted, and the
+// totals are computed once in a separate pass over the index columns,
+// after the first page is on screen.
+inline void browseSearchResults(const ResultCursor &cursor, const std::string &note = "") {
+  if (cursor.empty()) {
+    std::cout << std::endl;
+    drawInfoBox("🔍 No transactions match your criteria");
+    drawNavFooter();
+    drawPrompt("Press ENTER to continue");
+    std::string input = getInput();
+    handleNavigation(input);
+    return;
+  }
+
+  const size_t pages = cursor.pageCount(RESULTS_PAGE_SIZE);
+  size_t page = 0;
+  bool haveTotals = false;
+  ResultTotals totals;
+
+  while (true) {
+    clearScreen();
+    drawScreenHeader("AI Expense - Search Results", true);
+
+    drawSectionTitle("Search Results (" + std::to_string(cursor.size()) + " found)", "🔍");
+    std::cout << std::endl;
+    drawResultPage(cursor, page);
+
+    if (!note.empty()) {
+      std::cout << "  ";
+      setColor(COLOR_GRAY);
+      std::cout << note;
+      resetColor();
+      std::cout << std::endl;
+    }
+
+    if (!haveTotals) {
+      // Show the first page before the totals pass; the summary and
+      // footer follow in the same frame once they are known
+      presentFrame();
+      totals = cursor.computeTotals(TransactionManager::getIndex());
+      haveTotals = true;
+    }
+    drawFilteredSummary(totals);
+
+    std::cout << std::endl;
+    std::cout << "  Page " << (page + 1) << " of " << pages << "   ";
+    setColor(COLOR_CYAN);
+    std::cout << "[n]";
+    resetColor();
+    std::cout << " Next  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[p]";
+    resetColor();
+    std::cout << " Prev  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[#]";
+    resetColor();
+    std::cout << " Go to page  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[ENTER]";
+    resetColor();
+    std::cout << " Done" << std::endl;
+
+    drawPrompt("Page");
+    std::string input = getInput();
+
+    if (input.empty() || input == "b" || input == "B" || input == "m" || input == "M") {
+      return;
+    }
+    if (handleNavigation(input)) return;
+
+    if (input == "n" || input == "N" || input == ">") {
+      if (page + 1 < pages) page++;
+    } else if (input == "p" || input == "P" || input == "<") {
+      if (page > 0) page--;
+    } else {
+      try {
+        int target = std::stoi(input);
+        if (target >= 1 && static_cast<size_t>(target) <= pages) page = target - 1;
+      } catch (...) {
+        // Unknown command: stay on this page
+      }
+    }
+  }
+}
+
+// Browse a filtered row set (rows are ledger positions)
+inline void displayFilteredTransactions(const RoaringBitmap &rows) {
+  browseSearchResults(ResultCursor::fromBitmap(rows));
+}
+
+// Rows scanned between keyboard checks while a live query is evaluated
+const size_t LIVE_SEARCH_CHUNK = 65536;
+
+// Redraw the live search view for the current (finished) query
+inline void drawLiveSearch(const IncrementalSearch &search, double elapsedMs) {
+  const std::vector<Transaction> &ledger = TransactionManager::getLedger();
+
+  clearScreen();
+  drawScreenHeader("AI Expense - Live Search", true);
+  std::cout << std::endl;
+
+  std::cout << "  Type to search descriptions. ";
+  setColor(COLOR_GRAY);
+  std::cout << "[ENTER] browse all results  [ESC] back";
+  resetColor();
+  std::cout << std::endl << std::endl;
+
+  std::cout << "  ";
+  setColor(COLOR_CYAN);
+  std::cout << "► ";
+  resetColor();
+  std::cout << search.getQuery() << "_" << std::endl;
+
+  std::cout << "  ";
+  setColor(COLOR_GRAY);
+  std::cout << search.resultCount() << " matches (" << std::fixed << std::setprecision(1)
+            << elapsedMs << " ms)";
+  resetColor();
+  std::cout << std::endl << std::endl;
+
+  // Newest matches first
+  size_t shown = std::min(search.resultCount(), RESULTS_PAGE_SIZE);
+  char line[128];
+  for (size_t i = 0; i < shown; i++) {
+    const Transaction &t = ledger[search.newestResult(i)];
+    bool isIncome = t.getType() == "income";
+
+    std::string desc = t.getDescription();
+    if (desc.length() > 40) desc = desc.substr(0, 37) + "...";
+
+    std::snprintf(line, sizeof(line), "  %11s  ", t.getDate().c_str());
+    std::cout << line;
+    setColor(isIncome ? COLOR_GREEN : COLOR_RED);
+    std::snprintf(line, sizeof(line), "%s$%10.2f", isIncome ? "+" : "-", t.getAmount());
+    std::cout << line;
+    resetColor();
+    std::cout << "  " << desc << "\n";
+  }
+  std::cout << std::flush;
+}
+
+// Search-as-you-type. Each key press restarts evaluation; the scan runs in
+// chunks and checks the keyboard between chunks, so a stale query is
+// abandoned as soon as the next key arrives.
+inline void showLiveSearch() {
+  using Clock = std::chrono::steady_clock;
+
+  IncrementalSearch search(TransactionManager::getIndex());
+  std::string query;
+  auto started = Clock::now();
+  bool drawn = false;
+
+  search.setQuery(query);
+
+  while (true) {
+    if (!search.done()) {
+      if (keyWaiting()) {
+        // Fall through to read the key; the unfinished scan is discarded
+      } else {
+        search.step(LIVE_SEARCH_CHUNK);
+        continue;
+      }
+    } else if (!drawn) {
+      double elapsedMs =
+          std::chrono::duration<double, std::milli>(Clock::now() - started).count();
+      drawLiveSearch(search, elapsedMs);
+      drawn = true;
+    }
+
+    int ch = waitForKey();
+    if (ch == 0 || ch == 224) {
+      readKey(); // arrow / function key: ignore
+      continue;
+    }
+    if (ch == 27) return; // ESC
+    if (ch == '\r' || ch == '\n') {
+      if (!search.done()) {
+        while (!search.step(LIVE_SEARCH_CHUNK)) {
+        }
+      }
+      browseSearchResults(ResultCursor::fromRows(search.results()));
+      drawn = false;
+      continue;
+    }
+
+    if (ch == '\b' || ch == 127) {
+      if (query.empty()) continue;
+      query.pop_back();
+    } else if (ch >= 32 && ch < 256) {
+      query += static_cast<char>(ch);
+    } else {
+      continue;
+    }
+
+    started = Clock::now();
+    search.setQuery(query);
+    drawn = false;
+  }
+}
+
+inline Route showSearchScreen() {
   clearScreen();
 
   // Header
   drawScreenHeader("AI Expense - Search & Filter", true);
   std::cout << std::endl;
 
-  // Get all transactions
-  std::vector<Transaction> allTransactions = TransactionManager::getAllTransactions();
+  // Loaded ledger and its type / category indexes
+  const std::vector<Transaction> &allTransactions = TransactionManager::getLedger();
+  const LedgerIndex &index = TransactionManager::getIndex();
 
   if (allTransactions.empty()) {
     drawInfoBox("📭 No transactions to search!",
@@ -191,8 +317,7 @@ inline void showSearchScreen() {
     drawNavFooter();
     drawPrompt("Press ENTER to go back");
     getInput();
-    showMainMenu();
-    return;
+    return Route::MainMenu;
   }
 
   // Info box
@@ -213,6 +338,8 @@ inline void showSearchScreen() {
   drawMenuOption("4", "Filter by amount range", "💵");
   drawMenuOption("5", "Filter by date", "📅");
   drawMenuOption("6", "Advanced search (multiple filters)", "⚙️");
+  drawMenuOption("7", "Fuzzy search (tolerates typos)", "🔡");
+  drawMenuOption("8", "Live search (results as you type)", "⚡");
   std::cout << std::endl;
   drawMenuOption("b", "Go Back", "←");
 
@@ -221,12 +348,11 @@ inline void showSearchScreen() {
 
   // Handle navigation
   if (choice == "b" || choice == "B" || choice == "back") {
-    showMainMenu();
-    return;
+    return Route::MainMenu;
   }
-  if (handleNavigation(choice)) return;
+  if (handleNavigation(choice)) return Route::Quit;
 
-  std::vector<Transaction> results;
+  RoaringBitmap results;
 
   if (choice == "1") {
     // Search by keyword
@@ -239,18 +365,17 @@ inline void showSearchScreen() {
     std::string keyword = getInput();
 
     if (keyword.empty()) {
-      results = allTransactions;
+      // Everything matches: a lazy range instead of a materialized row list
+      browseSearchResults(ResultCursor::allRows(static_cast<uint32_t>(index.size())));
     } else {
-      std::string keywordLower = toLower(keyword);
-      for (const auto &t : allTransactions) {
-        if (toLower(t.getDescription()).find(keywordLower) != std::string::npos) {
-          results.push_back(t);
+      for (size_t row = 0; row < allTransactions.size(); row++) {
+        if (TextSearch::containsIgnoreCase(allTransactions[row].getDescription(), keyword)) {
+          results.add(static_cast<uint32_t>(row));
         }
       }
+      displayFilteredTransactions(results);
     }
 
-    displayFilteredTransactions(results);
-
   } else if (choice == "2") {
     // Filter by type
     clearScreen();
@@ -264,12 +389,7 @@ inline void showSearchScreen() {
     std::string typeChoice = getInput();
 
     std::string filterType = (typeChoice == "1") ? "income" : "expense";
-    
-    for (const auto &t : allTransactions) {
-      if (t.getType() == filterType) {
-        results.push_back(t);
-      }
-    }
+    results = index.byType(filterType);
 
     displayFilteredTransactions(results);
 
@@ -305,11 +425,7 @@ inline void showSearchScreen() {
       default: filterCategory = "Other"; break;
     }
 
-    for (const auto &t : allTransactions) {
-      if (categorizeTransaction(t.getDescription()) == filterCategory) {
-        results.push_back(t);
-      }
-    }
+    results = index.byCategory(filterCategory);
 
     displayFilteredTransactions(results);
 
@@ -330,9 +446,10 @@ inline void showSearchScreen() {
     std::string maxStr = getInput();
     double maxAmount = maxStr.empty() ? 999999999 : std::stod(maxStr);
 
-    for (const auto &t : allTransactions) {
-      if (t.getAmount() >= minAmount && t.getAmount() <= maxAmount) {
-        results.push_back(t);
+    for (size_t row = 0; row < allTransactions.size(); row++) {
+      double amount = allTransactions[row].getAmount();
+      if (amount >= minAmount && amount <= maxAmount) {
+        results.add(static_cast<uint32_t>(row));
       }
     }
 
@@ -348,12 +465,9 @@ inline void showSearchScreen() {
     drawPrompt("Month");
     std::string monthFilter = getInput();
 
-    std::string monthLower = toLower(monthFilter);
-
-    for (const auto &t : allTransactions) {
-      std::string dateLower = toLower(t.getDate());
-      if (dateLower.find(monthLower) != std::string::npos) {
-        results.push_back(t);
+    for (size_t row = 0; row < allTransactions.size(); row++) {
+      if (TextSearch::containsIgnoreCase(allTransactions[row].getDate(), monthFilter)) {
+        results.add(static_cast<uint32_t>(row));
       }
     }
 
@@ -390,25 +504,22 @@ inline void showSearchScreen() {
     std::cout << "  Month filter (e.g., Nov): ";
     std::string monthFilter = getInput();
 
-    // Apply all filters
-    std::string keywordLower = toLower(keyword);
-    std::string monthLower = toLower(monthFilter);
+    // Apply all filters. The type filter narrows the candidate rows through
+    // the type bitmap; the remaining filters are checked per candidate.
+    RoaringBitmap candidates = index.all();
+    if (!typeFilter.empty() && typeFilter != "a" && typeFilter != "A" && typeFilter != "all") {
+      std::string expectedType = (typeFilter == "i" || typeFilter == "I" || typeFilter == "income") 
+                                 ? "income" : "expense";
+      candidates = index.byType(expectedType);
+    }
 
-    for (const auto &t : allTransactions) {
+    candidates.forEach([&](uint32_t row) {
+      const Transaction &t = allTransactions[row];
       bool matches = true;
 
       // Keyword filter
       if (!keyword.empty()) {
-        if (toLower(t.getDescription()).find(keywordLower) == std::string::npos) {
-          matches = false;
-        }
-      }
-
-      // Type filter
-      if (!typeFilter.empty() && typeFilter != "a" && typeFilter != "A" && typeFilter != "all") {
-        std::string expectedType = (typeFilter == "i" || typeFilter == "I" || typeFilter == "income") 
-                                   ? "income" : "expense";
-        if (t.getType() != expectedType) {
+        if (!TextSearch::containsIgnoreCase(t.getDescription(), keyword)) {
           matches = false;
         }
       }
@@ -420,25 +531,56 @@ inline void showSearchScreen() {
 
       // Month filter
       if (!monthFilter.empty()) {
-        if (toLower(t.getDate()).find(monthLower) == std::string::npos) {
+        if (!TextSearch::containsIgnoreCase(t.getDate(), monthFilter)) {
           matches = false;
         }
       }
 
       if (matches) {
-        results.push_back(t);
+        results.add(row);
       }
-    }
+    });
 
     displayFilteredTransactions(results);
 
+  } else if (choice == "7") {
+    // Typo-tolerant keyword search
+    clearScreen();
+    drawScreenHeader("AI Expense - Fuzzy Search", true);
+    std::cout << std::endl;
+
+    std::cout << "  Enter a merchant or keyword, typos allowed (e.g. 'starbuks'):" << std::endl;
+    drawPrompt("Keyword");
+    std::string keyword = getInput();
+
+    if (keyword.empty()) {
+      browseSearchResults(ResultCursor::allRows(static_cast<uint32_t>(index.size())));
+    } else {
+      int maxDistance = FuzzySearch::defaultMaxDistance(keyword.size());
+      std::vector<FuzzyMatch> matches =
+          FuzzySearch::search(allTransactions, index, keyword, maxDistance);
+
+      std::vector<uint32_t> rows;
+      rows.reserve(matches.size());
+      for (const auto &m : matches) rows.push_back(m.row);
+
+      browseSearchResults(ResultCursor::fromRows(std::move(rows)),
+                          "Closest matches first (up to " + std::to_string(maxDistance) +
+                              (maxDistance == 1 ? " typo)" : " typos)"));
+    }
+
+  } else if (choice == "8") {
+    showLiveSearch();
+
   } else {
     drawStatusMessage("Invalid choice.", "error");
+
+    drawNavFooter();
+    drawPrompt("Press ENTER to continue or 'b' to go back");
+    std::string input = getInput();
+    if (input == "b" || input == "B" || input == "back") return Route::MainMenu;
+    if (handleNavigation(input)) return Route::Quit;
   }
 
-  drawNavFooter();
-  drawPrompt("Press ENTER to continue or 'b' to go back");
-  std::string input = getInput();
-  if (handleNavigation(input)) return;
-  showSearchScreen();
+  return Route::Search;
 }
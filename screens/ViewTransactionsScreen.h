@@ -1,134 +1,119 @@
 #pragma once
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <vector>
 
 #include "../modules/AI.h"
+#include "../modules/Bm25Retriever.h"
+#include "../modules/ConversationManager.h"
+#include "../modules/FinancialContext.h"
+#include "../modules/LedgerTools.h"
+#include "../modules/LedgerIndex.h"
 #include "../modules/Transaction.h"
 #include "../modules/TransactionManager.h"
+#include "AIScreen.h"
 #include "ScreenRoutes.h"
 #include "ScreenUtils.h"
 
-inline void showViewTransactionsScreen() {
-  clearScreen();
+// Rows shown at once in the transaction list
+const size_t VIEW_WINDOW_ROWS = 15;
 
-  // Beautiful header
-  drawScreenHeader("AI Expense - Transaction History", true);
-  std::cout << std::endl;
+// Ledger summary budget in the chat; the model calls tools for details
+const size_t LEDGER_CHAT_CONTEXT_TOKENS = 600;
 
-  std::vector<Transaction> transactions =
-      TransactionManager::getAllTransactions();
+// Draw one table row of the list
+inline void drawTransactionRow(const Transaction &t) {
+  std::cout << "  │ ";
 
-  if (transactions.empty()) {
-    drawInfoBox("No transactions found yet!",
-                "Add your first transaction to get started.");
-    
-    drawNavFooter();
-    drawPrompt("Enter command");
-    std::string input = getInput();
-    if (handleNavigation(input)) return;
-    showMainMenu();
-    return;
+  // ID
+  if (t.getType() == "income") {
+    setColor(10);
+  } else {
+    setColor(12);
   }
+  std::cout << std::setw(4) << t.getId();
+  resetColor();
+  std::cout << " │ ";
 
-  // Transaction list with beautiful formatting
-  drawSectionTitle("Recent Transactions", "📋");
-  std::cout << std::endl;
+  // Date
+  std::cout << std::setw(11) << t.getDate() << " │ ";
 
-  // Table header
+  // Amount with color
+  if (t.getType() == "income") {
+    setColor(10);
+    std::cout << "+$" << std::setw(10) << std::fixed << std::setprecision(2) << t.getAmount();
+  } else {
+    setColor(12);
+    std::cout << "-$" << std::setw(10) << std::fixed << std::setprecision(2) << t.getAmount();
+  }
+  resetColor();
+  std::cout << " │ ";
+
+  // Description (truncate if too long)
+  const std::string &desc = t.getDescription();
+  if (desc.length() > 30) {
+    std::cout << std::left << std::setw(30) << desc.substr(0, 27) + "..." << std::right << " │" << std::endl;
+  } else {
+    std::cout << std::left << std::setw(30) << desc << std::right << " │" << std::endl;
+  }
+}
+
+// Draw the visible window of the newest-first list. Only these rows are
+// read from the ledger (by index), so the cost doesn't depend on its size.
+inline void drawTransactionWindow(const std::vector<Transaction> &ledger, size_t top) {
   std::cout << "  ┌──────┬─────────────┬──────────────┬────────────────────────────────┐" << std::endl;
   std::cout << "  │  ID  │    Date     │    Amount    │          Description           │" << std::endl;
   std::cout << "  ├──────┼─────────────┼──────────────┼────────────────────────────────┤" << std::endl;
 
-  for (int i = static_cast<int>(transactions.size()) - 1; i >= 0; i--) {
-    const Transaction &t = transactions[i];
-
-    std::cout << "  │ ";
-    
-    // ID
-    if (t.getType() == "income") {
-      setColor(10);
-    } else {
-      setColor(12);
-    }
-    std::cout << std::setw(4) << t.getId();
-    resetColor();
-    std::cout << " │ ";
-
-    // Date
-    std::cout << std::setw(11) << t.getDate() << " │ ";
-
-    // Amount with color
-    if (t.getType() == "income") {
-      setColor(10);
-      std::cout << "+$" << std::setw(10) << std::fixed << std::setprecision(2) << t.getAmount();
-    } else {
-      setColor(12);
-      std::cout << "-$" << std::setw(10) << std::fixed << std::setprecision(2) << t.getAmount();
-    }
-    resetColor();
-    std::cout << " │ ";
-
-    // Description (truncate if too long)
-    std::string desc = t.getDescription();
-    if (desc.length() > 30) {
-      desc = desc.substr(0, 27) + "...";
-    }
-    std::cout << std::left << std::setw(30) << desc << std::right << " │" << std::endl;
+  size_t end = std::min(ledger.size(), top + VIEW_WINDOW_ROWS);
+  for (size_t i = top; i < end; i++) {
+    drawTransactionRow(ledger[ledger.size() - 1 - i]);
+  }
+  for (size_t i = end; i < top + VIEW_WINDOW_ROWS; i++) {
+    std::cout << "  │      │             │              │                                │" << std::endl;
   }
 
   std::cout << "  └──────┴─────────────┴──────────────┴────────────────────────────────┘" << std::endl;
-  std::cout << std::endl;
-
-  // Summary section
-  double totalIncome = TransactionManager::getTotalIncome();
-  double totalExpenses = TransactionManager::getTotalExpenses();
-  double balance = TransactionManager::getBalance();
-
-  drawSectionTitle("Summary", "📊");
-  
-  std::cout << "  │ Total Income:   ";
-  setColor(10);
-  std::cout << "+$" << std::fixed << std::setprecision(2) << totalIncome << std::endl;
-  resetColor();
+}
 
-  std::cout << "  │ Total Expenses: ";
-  setColor(12);
-  std::cout << "-$" << std::fixed << std::setprecision(2) << totalExpenses << std::endl;
-  resetColor();
+// List position (newest first) of the newest row on or before a date.
+// Accepts "15 Nov, 25" or a whole month like "Nov, 25".
+inline bool findDatePosition(const std::string &text, size_t &position) {
+  const LedgerIndex &index = TransactionManager::getIndex();
+  int key = Transaction::parseDateKey(text);
+  if (key == 0) {
+    key = Transaction::parseDateKey("31 " + text); // month: jump to its end
+  }
+  if (key == 0) return false;
 
-  std::cout << "  │" << std::endl;
-  std::cout << "  │ Net Balance:    ";
-  if (balance >= 0) {
-    setColor(10);
-    std::cout << "+$" << std::fixed << std::setprecision(2) << balance << std::endl;
+  int row = index.lastRowThroughDate(key);
+  if (row < 0) {
+    position = index.size() - 1; // before the first row: show the oldest
   } else {
-    setColor(12);
-    std::cout << "-$" << std::fixed << std::setprecision(2) << (-balance) << std::endl;
+    position = index.size() - 1 - row;
   }
-  resetColor();
-  std::cout << std::endl;
+  return true;
+}
 
-  // AI Analysis section
+// Chat with the AI about the ledger. Returns false if the user quit.
+inline bool chatAboutTransactions() {
   drawInfoBox("Ask AI about your finances (or press ENTER to go back)");
 
-  // Prepare AI Context
-  json conversation_history = json::array();
-  conversation_history.push_back(
-      {{"role", "system"},
-       {"content", "You are a helpful financial advisor. You have access to "
-                   "the user's transaction history provided below. Use this "
-                   "data to answer questions and give advice. Keep responses concise."}});
-
-  // Serialize transactions to JSON for context
-  json trans_json = json::array();
-  for (const auto &t : transactions) {
-    trans_json.push_back(t.toJson());
-  }
-  conversation_history.push_back(
-      {{"role", "system"},
-       {"content", "Transaction History: " + trans_json.dump()}});
+  // Prepare AI Context (only once the user asks for it): a short summary
+  // of the ledger, with tools for the model to look up the details
+  auto conversation = std::make_shared<ConversationManager>();
+  conversation->addSystem("You are a helpful financial advisor. You have a summary of "
+                          "the user's transaction history provided below. Use this "
+                          "data, the transactions attached to a question and the tools "
+                          "(totals, largest expenses, budgets, search) to answer "
+                          "questions and give advice. Keep responses concise.");
+  conversation->addSystem(FinancialContextBuilder::build(TransactionManager::getLedger(),
+                                                         TransactionManager::getIndex(),
+                                                         LEDGER_CHAT_CONTEXT_TOKENS));
+  std::shared_ptr<const ToolRegistry> tools = LedgerTools::create();
 
   // Chat Loop
   while (true) {
@@ -141,25 +126,176 @@ inline void showViewTransactionsScreen() {
 
     // Handle navigation
     if (input.empty() || input == "b" || input == "B" || input == "back") {
-      break;
+      return true;
     }
     if (input == "m" || input == "M" || input == "menu") {
-      break;
+      return true;
     }
-    if (handleNavigation(input)) return;
+    if (handleNavigation(input)) return false;
 
-    setColor(8);
-    std::cout << "  ⏳ AI is analyzing your transactions..." << std::endl;
-    resetColor();
+    std::cout << std::endl;
+    if (printLocalAnswer(input, *conversation)) continue;
 
-    std::string response = AIModule::chat(input, conversation_history);
+    // Attach the rows that match the question best
+    std::string matches = Bm25Retriever::describe(TransactionManager::getLedger(),
+                                                  TransactionManager::getIndex(), input);
+    std::string message = matches.empty() ? input : input + "\n\n" + matches;
 
+    if (!printStreamedReply(message, conversation, tools, input)) return true;
+  }
+}
+
+inline Route showViewTransactionsScreen() {
+  const std::vector<Transaction> &ledger = TransactionManager::getLedger();
+
+  if (ledger.empty()) {
+    clearScreen();
+    drawScreenHeader("AI Expense - Transaction History", true);
     std::cout << std::endl;
+    drawInfoBox("No transactions found yet!",
+                "Add your first transaction to get started.");
+
+    drawNavFooter();
+    drawPrompt("Enter command");
+    std::string input = getInput();
+    if (handleNavigation(input)) return Route::Quit;
+    return Route::MainMenu;
+  }
+
+  size_t top = 0; // list position of the first visible row (0 = newest)
+  std::string status;
+
+  while (true) {
+    size_t total = ledger.size();
+    size_t lastTop = total > VIEW_WINDOW_ROWS ? total - VIEW_WINDOW_ROWS : 0;
+    top = std::min(top, lastTop);
+
+    clearScreen();
+
+    // Beautiful header
+    drawScreenHeader("AI Expense - Transaction History", true);
+    std::cout << std::endl;
+
+    std::ostringstream range;
+    range << "Transactions " << top + 1 << "-" << std::min(total, top + VIEW_WINDOW_ROWS)
+          << " of " << total << " (newest first)";
+    drawSectionTitle(range.str(), "📋");
+    std::cout << std::endl;
+
+    drawTransactionWindow(ledger, top);
+    std::cout << std::endl;
+
+    // Summary section (running totals kept by the index)
+    double totalIncome = TransactionManager::getTotalIncome();
+    double totalExpenses = TransactionManager::getTotalExpenses();
+    double balance = TransactionManager::getBalance();
+
+    std::cout << "  Income: ";
     setColor(10);
-    std::cout << "  🤖 AI: ";
+    std::cout << "+$" << std::fixed << std::setprecision(2) << totalIncome;
     resetColor();
-    std::cout << response << std::endl;
-  }
+    std::cout << "   Expenses: ";
+    setColor(12);
+    std::cout << "-$" << std::fixed << std::setprecision(2) << totalExpenses;
+    resetColor();
+    std::cout << "   Net: ";
+    setColor(balance >= 0 ? 10 : 12);
+    std::cout << (balance >= 0 ? "+$" : "-$") << std::fixed << std::setprecision(2)
+              << (balance >= 0 ? balance : -balance) << std::endl;
+    resetColor();
+
+    drawFrameStats();
+    std::cout << std::endl;
+
+    // Key hints
+    std::cout << "  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[j/k ↓↑]";
+    resetColor();
+    std::cout << " Scroll  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[n/p PgDn/PgUp]";
+    resetColor();
+    std::cout << " Page  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[Home/End]";
+    resetColor();
+    std::cout << " Newest/Oldest  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[/]";
+    resetColor();
+    std::cout << " Jump to date" << std::endl;
+    std::cout << "  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[a]";
+    resetColor();
+    std::cout << " Ask AI  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[b]";
+    resetColor();
+    std::cout << " Back  ";
+    setColor(COLOR_CYAN);
+    std::cout << "[q]";
+    resetColor();
+    std::cout << " Quit" << std::endl;
+
+    if (!status.empty()) {
+      drawStatusMessage(status, "error");
+      status.clear();
+    }
+
+    int key = waitForKey();
+    if (key == 0 || key == 224) {
+      // Arrow / navigation keys arrive as a prefix plus a scan code
+      switch (readKey()) {
+        case 72: key = 'k'; break; // Up
+        case 80: key = 'j'; break; // Down
+        case 73: key = 'p'; break; // PgUp
+        case 81: key = 'n'; break; // PgDn
+        case 71: key = 'g'; break; // Home
+        case 79: key = 'G'; break; // End
+        default: continue;
+      }
+    }
 
-  showMainMenu();
+    switch (key) {
+      case 'j': top = std::min(top + 1, lastTop); break;
+      case 'k': top = top > 0 ? top - 1 : 0; break;
+      case 'n':
+      case ' ': top = std::min(top + VIEW_WINDOW_ROWS, lastTop); break;
+      case 'p': top = top > VIEW_WINDOW_ROWS ? top - VIEW_WINDOW_ROWS : 0; break;
+      case 'g': top = 0; break;
+      case 'G': top = lastTop; break;
+      case '/': {
+        drawPrompt("Jump to date (e.g. 15 Nov, 25 or Nov, 25)");
+        std::string text = getInput();
+        size_t position = 0;
+        if (text.empty()) break;
+        if (findDatePosition(text, position)) {
+          top = position;
+        } else {
+          status = "Unrecognized date: " + text;
+        }
+        break;
+      }
+      case 'a':
+      case 'A':
+        std::cout << std::endl;
+        if (!chatAboutTransactions()) return Route::Quit;
+        break;
+      case 'b':
+      case 'B':
+      case 'm':
+      case 'M':
+      case 27: // ESC
+      case '\r':
+        return Route::MainMenu;
+      case 'q':
+      case 'Q':
+        handleNavigation("q");
+        return Route::Quit;
+      default:
+        break;
+    }
+  }
 }
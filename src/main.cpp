@@ -1,8 +1,10 @@
 #include <iostream>
-#include <windows.h> // For Windows console functions - must be FIRST
+#include <winsock2.h> // Before windows.h, which would pull in the old winsock.h
+#include <windows.h> // For Windows console functions - before the modules
 
 #include "../modules/AuthManager.h"
 #include "../modules/FileHandler.h"
+#include "../modules/ProfileStore.h"
 #include "../screens/Screens.h"
 
 int main() {
@@ -11,16 +13,19 @@ int main() {
   // Posted by SeanTolstoyevski
   // Retrieved 2025-11-27, License - CC BY-SA 4.0
   SetConsoleOutputCP(CP_UTF8);
+  initTerminal();
   
   std::cout << "Starting AI Expense Manager...\n";
-  FileHandler::ensureDataDirectory();
+  ProfileStore::load(); // opens the active profile's data folder
 
-  if (AuthManager::isFirstTime()) {
+  if (ProfileStore::list().size() > 1) {
+    runRouter(Route::Profiles);
+  } else if (AuthManager::isFirstTime()) {
     std::cout << "User is coming first time";
-    showSetupScreen();
+    runRouter(Route::Setup);
   } else {
     std::cout << "User aint first time";
-    showLoginScreen();
+    runRouter(Route::Login);
   }
 
   return 0;
@@ -0,0 +1,9 @@
+@echo off
+echo Building AI Expense Manager tests...
+g++ -O2 -o tests.exe tests/main.cpp -std=c++17 -lwinhttp -lws2_32
+if %ERRORLEVEL% NEQ 0 (
+    echo Build failed!
+    exit /b 1
+)
+tests.exe
+exit /b %ERRORLEVEL%
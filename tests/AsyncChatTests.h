@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/nlohmann/json.hpp"
+#include "../modules/AI.h"
+#include "Check.h"
+#include "MockModel.h"
+
+// Chat turns on the background workers: cancelling, time limits, and
+// several at once
+
+namespace AsyncChatTests {
+using json = nlohmann::json;
+using Fault = MockModel::Fault;
+
+const std::string REPLY = "Set aside ten percent of each paycheck.";
+
+// The first request waits this long before the model answers
+inline Fault slowFirstAnswer(int delayMs) {
+  Fault fault;
+  fault.delayMs = delayMs;
+  return fault;
+}
+
+inline void cancelsWhileWaiting() {
+  MockModel model(MockModel::replying(REPLY), nullptr, slowFirstAnswer(10000));
+  CHECK(model.started);
+  json conversation = json::array();
+  std::shared_ptr<AIRequest> request = AIModule::chatAsync("How do I save?", conversation);
+  CHECK(!request->waitFor(100));
+  CHECK(!request->isFinished());
+
+  request->cancel();
+  CHECK(request->waitFor(2000)); // not the server's ten seconds
+  CHECK(request->getState() == AIRequest::State::Cancelled);
+  CHECK(request->getElapsedMs() < 2000);
+
+  // The question is taken back out of the history
+  CHECK_EQ(conversation.size(), size_t(1));
+  request->finishTurn(conversation);
+  CHECK(conversation.empty());
+}
+
+inline void stopsAtItsTimeLimit() {
+  MockModel model(MockModel::replying(REPLY), nullptr, slowFirstAnswer(10000));
+  CHECK(model.started);
+  json conversation = json::array();
+  std::shared_ptr<AIRequest> request =
+      AIModule::chatAsync("How do I save?", conversation, nullptr, 300);
+  CHECK(request->waitFor(3000));
+  CHECK(request->getState() == AIRequest::State::TimedOut);
+  CHECK(request->getElapsedMs() >= 250);
+  CHECK(request->getElapsedMs() < 3000);
+
+  // Another request with the default limit is unaffected
+  json next = json::array();
+  std::shared_ptr<AIRequest> second = AIModule::chatAsync("How do I save?", next);
+  CHECK(second->waitFor(5000));
+  CHECK(second->getState() == AIRequest::State::Completed);
+  CHECK_EQ(second->getResult().get(), REPLY);
+}
+
+// Each request streams its own answer into its own conversation
+inline void runsSideBySide() {
+  std::atomic<int> inFlight{0};
+  std::atomic<int> mostInFlight{0};
+  MockModel model([&inFlight, &mostInFlight](const json &request) -> json {
+    int now = ++inFlight;
+    int most = mostInFlight;
+    while (now > most && !mostInFlight.compare_exchange_weak(most, now)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    --inFlight;
+    std::string question = request["messages"].back().value("content", "");
+    return {{"role", "assistant"}, {"content", "Answer to " + question}};
+  });
+  CHECK(model.started);
+
+  const std::vector<std::string> questions = {"rent", "food", "travel", "savings"};
+  std::vector<json> conversations(questions.size(), json::array());
+  std::vector<std::shared_ptr<AIRequest>> requests;
+  for (size_t i = 0; i < questions.size(); i++) {
+    requests.push_back(AIModule::chatAsync(questions[i], conversations[i]));
+  }
+
+  for (size_t i = 0; i < questions.size(); i++) {
+    CHECK(requests[i]->waitFor(5000));
+    CHECK(requests[i]->getState() == AIRequest::State::Completed);
+    CHECK_EQ(requests[i]->getResult().get(), "Answer to " + questions[i]);
+    CHECK_EQ(requests[i]->takeNewText(), "Answer to " + questions[i]);
+    requests[i]->finishTurn(conversations[i]);
+    CHECK_EQ(conversations[i].size(), size_t(2));
+    CHECK_EQ(conversations[i].back().value("content", ""), "Answer to " + questions[i]);
+  }
+  CHECK(mostInFlight > 1);
+  CHECK_EQ(model.server.getRequestCount(), questions.size());
+}
+
+inline void run() {
+  TEST_GROUP("AsyncChat");
+  cancelsWhileWaiting();
+  stopsAtItsTimeLimit();
+  runsSideBySide();
+}
+} // namespace AsyncChatTests
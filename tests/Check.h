@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/**
+ * Check - assertions for the test executable
+ *
+ * HOW IT WORKS:
+ * =============
+ * CHECK / CHECK_EQ / CHECK_NEAR record a failure (file, line, what was
+ * expected and what came out) and carry on, so one run lists every
+ * broken case. TEST_GROUP prints the group being run. main() returns
+ * Check::summary(), which is non-zero when anything failed.
+ */
+namespace Check {
+inline int passed = 0;
+inline int failed = 0;
+
+inline void fail(const char *file, int line, const std::string &what) {
+  failed++;
+  std::cout << "  FAIL " << file << ":" << line << ": " << what << std::endl;
+}
+
+inline int summary() {
+  std::cout << std::endl << passed << " passed, " << failed << " failed" << std::endl;
+  return failed == 0 ? 0 : 1;
+}
+} // namespace Check
+
+#define TEST_GROUP(name) std::cout << "[" << name << "]" << std::endl
+
+#define CHECK(condition)                                                                        \
+  do {                                                                                          \
+    if (condition) {                                                                            \
+      Check::passed++;                                                                          \
+    } else {                                                                                    \
+      Check::fail(__FILE__, __LINE__, #condition);                                              \
+    }                                                                                           \
+  } while (0)
+
+#define CHECK_EQ(actual, expected)                                                              \
+  do {                                                                                          \
+    auto checkActual = (actual);                                                                \
+    auto checkExpected = (expected);                                                            \
+    if (checkActual == checkExpected) {                                                         \
+      Check::passed++;                                                                          \
+    } else {                                                                                    \
+      std::ostringstream checkMessage;                                                          \
+      checkMessage << #actual << " is " << checkActual << ", expected " << checkExpected;       \
+      Check::fail(__FILE__, __LINE__, checkMessage.str());                                      \
+    }                                                                                           \
+  } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                 \
+  do {                                                                                          \
+    double checkActual = (actual);                                                              \
+    double checkExpected = (expected);                                                          \
+    if (std::fabs(checkActual - checkExpected) <= (tolerance)) {                                \
+      Check::passed++;                                                                          \
+    } else {                                                                                    \
+      std::ostringstream checkMessage;                                                          \
+      checkMessage << #actual << " is " << checkActual << ", expected " << checkExpected;       \
+      Check::fail(__FILE__, __LINE__, checkMessage.str());                                      \
+    }                                                                                           \
+  } while (0)
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+
+#include "../include/nlohmann/json.hpp"
+#include "../modules/AI.h"
+#include "Check.h"
+#include "MockModel.h"
+
+// How chat turns use their connections to the model
+
+namespace HttpTransportTests {
+using json = nlohmann::json;
+
+const std::string REPLY = "Groceries are your largest variable cost.";
+
+// A conversation's turns go over one kept-alive connection
+inline void reusesOneConnection() {
+  MockModel model(MockModel::replying(REPLY));
+  CHECK(model.started);
+  json conversation = json::array();
+  for (int turn = 0; turn < 4; turn++) {
+    CHECK_EQ(AIModule::chat("Where does my money go?", conversation), REPLY);
+  }
+  CHECK_EQ(conversation.size(), size_t(8));
+
+  // Streamed turns too
+  CHECK_EQ(model.ask("And this month?"), REPLY);
+  CHECK_EQ(model.server.getRequestCount(), size_t(5));
+  CHECK_EQ(model.server.getConnectionCount(), size_t(1));
+}
+
+inline void run() {
+  TEST_GROUP("HttpTransport");
+  reusesOneConnection();
+}
+} // namespace HttpTransportTests
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include "../modules/LedgerIndex.h"
+#include "../modules/Transaction.h"
+#include "Check.h"
+
+// Date lookups on the ledger index, whatever order the rows were saved in
+
+namespace LedgerIndexTests {
+
+inline std::vector<uint32_t> rows(const RoaringBitmap &bitmap) { return bitmap.toVector(); }
+
+inline void findsRowsInDateOrder() {
+  LedgerIndex index;
+  index.rebuild({Transaction(1, "expense", 10.0, "Rent", "1 Jan, 25"),
+                 Transaction(2, "expense", 20.0, "Pizza", "3 Jan, 25"),
+                 Transaction(3, "expense", 30.0, "Uber", "2 Feb, 25")});
+  CHECK(rows(index.byDateRange(20250102, 20250131)) == std::vector<uint32_t>({1}));
+  CHECK(rows(index.byDateRange(20250101, 20251231)) == std::vector<uint32_t>({0, 1, 2}));
+  CHECK(index.byDateRange(20250204, 20250301).cardinality() == 0);
+  CHECK_EQ(index.lastRowThroughDate(20250115), 1);
+  CHECK_EQ(index.lastRowThroughDate(20241231), -1);
+}
+
+// Edited or imported rows, and one whose date doesn't parse
+inline void findsRowsOutOfOrder() {
+  LedgerIndex index;
+  index.rebuild({Transaction(1, "expense", 10.0, "Uber", "2 Feb, 25"),
+                 Transaction(2, "expense", 20.0, "Rent", "1 Jan, 25"),
+                 Transaction(3, "expense", 30.0, "Refund", "someday"),
+                 Transaction(4, "expense", 40.0, "Netflix", "20 Feb, 25"),
+                 Transaction(5, "expense", 50.0, "Pizza", "3 Jan, 25")});
+  CHECK(rows(index.byDateRange(20250101, 20250131)) == std::vector<uint32_t>({1, 4}));
+  CHECK(rows(index.byDateRange(20250201, 20250228)) == std::vector<uint32_t>({0, 3}));
+  CHECK(rows(index.byDateRange(20250102, 20250203)) == std::vector<uint32_t>({0, 4}));
+  CHECK(rows(index.byDateRange(0, 99991231)) == std::vector<uint32_t>({0, 1, 3, 4}));
+  CHECK_NEAR(index.sum(index.byDateRange(20250101, 20250131)), 70.0, 0.001);
+  CHECK_EQ(index.lastRowThroughDate(20250110), 4);
+  CHECK_EQ(index.lastRowThroughDate(20250215), 0);
+
+  // A row added later with an earlier date than the last one
+  index.add(5, Transaction(6, "expense", 60.0, "Grocery", "15 Jan, 25"));
+  CHECK(rows(index.byDateRange(20250101, 20250131)) == std::vector<uint32_t>({1, 4, 5}));
+  CHECK_EQ(index.lastRowThroughDate(20250120), 5);
+}
+
+inline void run() {
+  TEST_GROUP("LedgerIndex");
+  findsRowsInDateOrder();
+  findsRowsOutOfOrder();
+}
+} // namespace LedgerIndexTests
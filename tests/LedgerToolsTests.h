@@ -0,0 +1,137 @@
+#pragma once
+
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "../include/nlohmann/json.hpp"
+#include "../modules/AI.h"
+#include "../modules/LedgerTools.h"
+#include "Check.h"
+#include "MockModel.h"
+#include "TestLedger.h"
+
+// The ledger tools the model calls, and a chat turn that uses them
+
+namespace LedgerToolsTests {
+using json = nlohmann::json;
+
+inline json call(const ToolRegistry &tools, const std::string &name, const json &arguments) {
+  return json::parse(tools.call(name, arguments.dump()));
+}
+
+inline std::vector<int> ids(const json &rows) {
+  std::vector<int> list;
+  for (const auto &row : rows) list.push_back(row.value("id", 0));
+  return list;
+}
+
+inline void sumsTransactions(const ToolRegistry &tools) {
+  json food = call(tools, "sum_transactions", {{"category", "Food"}, {"type", "expense"}});
+  CHECK_NEAR(food.value("total", 0.0), 112.60, 0.001);
+  CHECK_EQ(food.value("count", 0), 3);
+
+  json expenses = call(tools, "sum_transactions", json::object()); // type defaults to expense
+  CHECK_EQ(expenses.value("type", ""), std::string("expense"));
+  CHECK_NEAR(expenses.value("total", 0.0), 1347.84, 0.001);
+  CHECK_EQ(expenses.value("count", 0), 6);
+
+  json income = call(tools, "sum_transactions", {{"type", "income"}});
+  CHECK_NEAR(income.value("total", 0.0), 3000.0, 0.001);
+  CHECK_EQ(income.value("count", 0), 1);
+
+  json february = call(tools, "sum_transactions",
+                       {{"category", "Food"}, {"from", "2025-02"}, {"to", "2025-02"}});
+  CHECK_NEAR(february.value("total", 0.0), 60.10, 0.001);
+  CHECK_EQ(february.value("count", 0), 1);
+
+  json days = call(tools, "sum_transactions", {{"from", "2025-01-02"}, {"to", "2025-01-15"}});
+  CHECK_NEAR(days.value("total", 0.0), 52.50, 0.001);
+  CHECK_EQ(days.value("count", 0), 2);
+}
+
+inline void listsTopExpenses(const ToolRegistry &tools) {
+  json top = call(tools, "top_expenses", {{"n", 2}});
+  CHECK(top["expenses"].size() == 2);
+  CHECK(ids(top["expenses"]) == std::vector<int>({1, 6}));
+  CHECK_NEAR(top["expenses"][0].value("amount", 0.0), 1200.0, 0.001);
+  CHECK_EQ(top["expenses"][0].value("category", ""), std::string("Housing"));
+
+  json food = call(tools, "top_expenses", {{"category", "Food"}, {"n", 10}});
+  CHECK(ids(food["expenses"]) == std::vector<int>({6, 3, 2}));
+
+  json january = call(tools, "top_expenses", {{"from", "2025-01"}, {"to", "2025-01"}});
+  CHECK(ids(january["expenses"]) == std::vector<int>({1, 3, 2}));
+}
+
+inline void searchesTransactions(const ToolRegistry &tools) {
+  json uber = call(tools, "search_transactions", {{"query", "uber"}});
+  CHECK(!uber["transactions"].empty());
+  CHECK_EQ(uber["transactions"][0].value("id", 0), 5);
+  CHECK_EQ(uber["transactions"][0].value("description", ""), std::string("Uber to airport"));
+
+  json one = call(tools, "search_transactions", {{"query", "dinner friends"}, {"k", 1}});
+  CHECK(ids(one["transactions"]) == std::vector<int>({6}));
+
+  json none = call(tools, "search_transactions", {{"query", "mortgage"}});
+  CHECK(none["transactions"].empty());
+}
+
+inline void reportsErrors(const ToolRegistry &tools) {
+  auto isError = [](const std::string &result) {
+    json parsed = json::parse(result);
+    return parsed.is_object() && parsed.contains("error") && parsed["error"].is_string();
+  };
+  CHECK(isError(tools.call("delete_everything", "{}")));
+  CHECK(isError(tools.call("sum_transactions", "not json")));
+  CHECK(isError(tools.call("sum_transactions", "[1, 2]")));
+  CHECK(isError(tools.call("sum_transactions", R"({"category":"Snacks"})")));
+  CHECK(isError(tools.call("sum_transactions", R"({"from":"2025-13"})")));
+  CHECK(isError(tools.call("top_expenses", R"({"n":"five"})")));
+  CHECK(isError(tools.call("search_transactions", "{}"))); // query is required
+}
+
+// A mock model asks for the food total, then answers from the tool result
+inline void answersThroughMockModel() {
+  json toolResult;
+  MockModel model([&toolResult](const json &request) -> json {
+    const json &last = request["messages"].back();
+    if (last.value("role", "") == "tool") {
+      toolResult = json::parse(last["content"].get<std::string>());
+      std::ostringstream answer;
+      answer << "You spent $" << std::fixed << std::setprecision(2)
+             << toolResult.value("total", 0.0) << " on food across "
+             << toolResult.value("count", 0) << " transactions.";
+      return {{"role", "assistant"}, {"content", answer.str()}};
+    }
+    json call = {{"id", "call_1"},
+                 {"type", "function"},
+                 {"function",
+                  {{"name", "sum_transactions"},
+                   {"arguments", R"({"category":"Food","type":"expense"})"}}}};
+    return {{"role", "assistant"}, {"content", nullptr}, {"tool_calls", {call}}};
+  });
+  CHECK(model.started);
+
+  json conversation = json::array();
+  std::string answer = AIModule::chatStream("How much did I spend on food?", conversation,
+                                            [](const std::string &) {}, LedgerTools::create());
+  CHECK_EQ(answer, std::string("You spent $112.60 on food across 3 transactions."));
+  CHECK_NEAR(toolResult.value("total", 0.0), 112.60, 0.001);
+  CHECK_EQ(AIModule::getLastRoundTrips(), size_t(2));
+  CHECK_EQ(model.server.getRequestCount(), size_t(2));
+  CHECK_EQ(conversation.back().value("content", ""), answer);
+}
+
+inline void run() {
+  TEST_GROUP("LedgerTools");
+  TestLedger ledger;
+  std::shared_ptr<const ToolRegistry> tools = LedgerTools::create();
+  sumsTransactions(*tools);
+  listsTopExpenses(*tools);
+  searchesTransactions(*tools);
+  reportsErrors(*tools);
+  answersThroughMockModel();
+}
+} // namespace LedgerToolsTests
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "../include/nlohmann/json.hpp"
+#include "../modules/AI.h"
+#include "../modules/HttpClient.h"
+#include "../modules/LoopbackHttpServer.h"
+#include "../modules/ResponseCache.h"
+#include "../modules/ToolRegistry.h"
+
+// A scripted chat model on the loopback server, with AIModule pointed at
+// it for the life of the object. The transport, endpoint, response cache
+// and data version source are put back by the destructor, so a test that
+// stops part way doesn't leave them swapped for the tests after it.
+class MockModel {
+public:
+  using json = nlohmann::json;
+  using Fault = LoopbackHttpServer::Fault;
+
+  // A model that always answers with text
+  static LoopbackHttpServer::Responder replying(const std::string &text) {
+    return [text](const json &) -> json { return {{"role", "assistant"}, {"content", text}}; };
+  }
+
+  // cache: what AIModule caches replies in (nullptr: no caching).
+  // firstFault: what goes wrong with the first request.
+  explicit MockModel(LoopbackHttpServer::Responder responder,
+                     std::shared_ptr<ResponseCache> cache = nullptr, Fault firstFault = Fault())
+      : server("{}"), cache(cache) {
+    server.setResponder(std::move(responder));
+    server.setFaults([firstFault](size_t request) { return request == 1 ? firstFault : Fault(); });
+    started = server.start();
+    previousTransport = AIModule::setTransport(std::make_shared<SocketHttpTransport>());
+    previousCache = AIModule::setResponseCache(cache);
+    previousEndpoint = AIModule::currentEndpoint();
+    AIModule::setEndpoint(server.url("/api/v1/chat/completions"));
+  }
+
+  ~MockModel() {
+    if (versionSourceSet) AIModule::setDataVersionSource(nullptr);
+    AIModule::setResponseCache(previousCache);
+    AIModule::setTransport(previousTransport);
+    AIModule::setEndpoint(previousEndpoint);
+  }
+
+  MockModel(const MockModel &) = delete;
+  MockModel &operator=(const MockModel &) = delete;
+
+  // Key cached replies on this data version until the model goes away
+  void useDataVersion(std::function<uint64_t()> source) {
+    AIModule::setDataVersionSource(std::move(source));
+    versionSourceSet = true;
+  }
+
+  // One streamed question in a new conversation
+  std::string ask(const std::string &question,
+                  std::shared_ptr<const ToolRegistry> tools = nullptr) {
+    json conversation = json::array();
+    return AIModule::chatStream(question, conversation, [](const std::string &) {}, tools);
+  }
+
+  LoopbackHttpServer server;
+  std::shared_ptr<ResponseCache> cache;
+  bool started = false;
+
+private:
+  std::shared_ptr<HttpTransport> previousTransport;
+  std::shared_ptr<ResponseCache> previousCache;
+  std::string previousEndpoint;
+  bool versionSourceSet = false;
+};
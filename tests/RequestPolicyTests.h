@@ -0,0 +1,190 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "../modules/HttpClient.h"
+#include "../modules/LoopbackHttpServer.h"
+#include "../modules/RequestPolicy.h"
+#include "Check.h"
+
+// PolicyHttpTransport against a loopback server that injects faults
+
+namespace RequestPolicyTests {
+using Fault = LoopbackHttpServer::Fault;
+using Clock = std::chrono::steady_clock;
+
+inline double msSince(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Short waits so the tests run quickly
+inline RequestPolicy fastPolicy() {
+  RequestPolicy policy;
+  policy.backoffBaseMs = 10;
+  policy.backoffMaxMs = 40;
+  policy.readTimeoutMs = 200;
+  return policy;
+}
+
+inline void retriesErrorStatuses() {
+  LoopbackHttpServer server("{\"ok\":true}");
+  server.setFaults([](size_t request) {
+    Fault fault;
+    if (request <= 2) fault.status = 503;
+    return fault;
+  });
+  CHECK(server.start());
+  auto socket = std::make_shared<SocketHttpTransport>();
+
+  HttpResponse plain = socket->post(server.url(), {}, "{}");
+  CHECK_EQ(plain.status, 503);
+  CHECK_EQ(plain.attempts, 1);
+
+  PolicyHttpTransport transport(socket, fastPolicy());
+  HttpResponse retried = transport.post(server.url(), {}, "{}");
+  CHECK_EQ(retried.status, 200);
+  CHECK_EQ(retried.attempts, 2); // the second 503, then the answer
+  CHECK_EQ(retried.body, std::string("{\"ok\":true}"));
+  CHECK_EQ(transport.getRetries(), size_t(1));
+}
+
+inline void givesUpAfterMaxAttempts() {
+  LoopbackHttpServer server("{}");
+  server.setFaults([](size_t) {
+    Fault fault;
+    fault.status = 429;
+    return fault;
+  });
+  CHECK(server.start());
+  PolicyHttpTransport transport(std::make_shared<SocketHttpTransport>(), fastPolicy());
+  HttpResponse response = transport.post(server.url(), {}, "{}");
+  CHECK_EQ(response.status, 429);
+  CHECK_EQ(response.attempts, 3);
+  CHECK_EQ(server.getRequestCount(), size_t(3));
+  CHECK(response.body.find("Injected fault") != std::string::npos); // the last error, handed over
+}
+
+inline void doesNotRetryClientErrors() {
+  LoopbackHttpServer server("{}");
+  server.setFaults([](size_t) {
+    Fault fault;
+    fault.status = 400;
+    return fault;
+  });
+  CHECK(server.start());
+  PolicyHttpTransport transport(std::make_shared<SocketHttpTransport>(), fastPolicy());
+  HttpResponse response = transport.post(server.url(), {}, "{}");
+  CHECK_EQ(response.status, 400);
+  CHECK_EQ(response.attempts, 1);
+}
+
+inline void recoversFromStall() {
+  LoopbackHttpServer server("{}");
+  server.setFaults([](size_t request) {
+    Fault fault;
+    if (request == 1) fault.delayMs = 2000;
+    return fault;
+  });
+  CHECK(server.start());
+  PolicyHttpTransport transport(std::make_shared<SocketHttpTransport>(), fastPolicy());
+  auto started = Clock::now();
+  HttpResponse response = transport.post(server.url(), {}, "{}");
+  double elapsedMs = msSince(started);
+  CHECK_EQ(response.status, 200);
+  CHECK_EQ(response.attempts, 2);
+  CHECK(response.error.empty());
+  CHECK(elapsedMs < 1000); // the read timeout, not the 2 s stall
+}
+
+inline void recoversFromDroppedConnection() {
+  LoopbackHttpServer server("{}");
+  server.setFaults([](size_t request) {
+    Fault fault;
+    fault.drop = request == 1;
+    return fault;
+  });
+  CHECK(server.start());
+  PolicyHttpTransport transport(std::make_shared<SocketHttpTransport>(), fastPolicy());
+  HttpResponse response = transport.post(server.url(), {}, "{}");
+  CHECK_EQ(response.status, 200);
+  CHECK_EQ(response.attempts, 2);
+}
+
+inline void failsSetupErrorsAtOnce() {
+  auto socket = std::make_shared<SocketHttpTransport>();
+  PolicyHttpTransport transport(socket, fastPolicy());
+
+  HttpResponse badUrl = transport.post("not a url", {}, "{}");
+  CHECK(!badUrl.error.empty());
+  CHECK(!badUrl.transient);
+  CHECK_EQ(badUrl.attempts, 1);
+
+  HttpResponse https = transport.post("https://127.0.0.1:1/", {}, "{}");
+  CHECK(!https.error.empty());
+  CHECK(!https.transient);
+  CHECK_EQ(https.attempts, 1);
+
+  // Nothing listens on port 1: a transient failure, tried maxAttempts times
+  HttpResponse refused = transport.post("http://127.0.0.1:1/", {}, "{}");
+  CHECK(refused.transient);
+  CHECK_EQ(refused.attempts, 3);
+  CHECK_EQ(transport.getRetries(), size_t(2));
+}
+
+inline void hedgesSlowRequests() {
+  LoopbackHttpServer server("{}");
+  server.setFaults([](size_t request) {
+    Fault fault;
+    if (request == 1) fault.delayMs = 1000;
+    return fault;
+  });
+  CHECK(server.start());
+  RequestPolicy policy = fastPolicy();
+  policy.readTimeoutMs = 5000;
+  policy.hedge = true;
+  policy.hedgeDelayMs = 50;
+  PolicyHttpTransport transport(std::make_shared<SocketHttpTransport>(), policy);
+
+  auto started = Clock::now();
+  HttpResponse slow = transport.post(server.url(), {}, "{}");
+  double elapsedMs = msSince(started);
+  CHECK_EQ(slow.status, 200);
+  CHECK_EQ(slow.attempts, 2);
+  CHECK(elapsedMs < 800); // the hedge answered, not the delayed original
+  CHECK_EQ(transport.getHedgesSent(), size_t(1));
+  CHECK_EQ(transport.getHedgesWon(), size_t(1));
+
+  // A prompt answer sends no hedge
+  HttpResponse fast = transport.post(server.url(), {}, "{}");
+  CHECK_EQ(fast.status, 200);
+  CHECK_EQ(fast.attempts, 1);
+  CHECK_EQ(transport.getHedgesSent(), size_t(1));
+}
+
+inline void hedgesOnlyAfterEnoughSamples() {
+  LoopbackHttpServer server("{}");
+  CHECK(server.start());
+  RequestPolicy policy = fastPolicy();
+  policy.hedge = true; // delay from the p95
+  PolicyHttpTransport transport(std::make_shared<SocketHttpTransport>(), policy);
+  CHECK(transport.getHedgeDelayMs() < 0);
+  for (size_t i = 0; i < PolicyHttpTransport::MIN_HEDGE_SAMPLES; i++) {
+    transport.post(server.url(), {}, "{}");
+  }
+  CHECK(transport.getHedgeDelayMs() >= 0);
+}
+
+inline void run() {
+  TEST_GROUP("RequestPolicy");
+  retriesErrorStatuses();
+  givesUpAfterMaxAttempts();
+  doesNotRetryClientErrors();
+  recoversFromStall();
+  recoversFromDroppedConnection();
+  failsSetupErrorsAtOnce();
+  hedgesSlowRequests();
+  hedgesOnlyAfterEnoughSamples();
+}
+} // namespace RequestPolicyTests
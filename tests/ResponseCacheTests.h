@@ -0,0 +1,110 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "../include/nlohmann/json.hpp"
+#include "../modules/AI.h"
+#include "../modules/BudgetManager.h"
+#include "../modules/LedgerTools.h"
+#include "../modules/ResponseCache.h"
+#include "Check.h"
+#include "MockModel.h"
+#include "TestLedger.h"
+
+// Which chat replies AIModule keeps in the response cache
+
+namespace ResponseCacheTests {
+using json = nlohmann::json;
+using Fault = MockModel::Fault;
+
+const std::string REPLY = "Your spending is on track this month.";
+
+// The first stream breaks off after this many words
+inline Fault cutAfter(int events) {
+  Fault fault;
+  fault.cutAfter = events;
+  return fault;
+}
+
+inline void cachesCompleteReplies() {
+  MockModel model(MockModel::replying(REPLY), std::make_shared<ResponseCache>());
+  CHECK(model.started);
+  CHECK_EQ(model.ask("Am I on track?"), REPLY);
+  CHECK_EQ(model.cache->size(), size_t(1));
+  CHECK_EQ(model.ask("Am I on track?"), REPLY);
+  CHECK_EQ(model.server.getRequestCount(), size_t(1)); // the repeat came from the cache
+}
+
+inline void skipsInterruptedReplies() {
+  MockModel model(MockModel::replying(REPLY), std::make_shared<ResponseCache>(), cutAfter(3));
+  CHECK(model.started);
+  std::string partial = model.ask("Am I on track?");
+  CHECK_EQ(partial, std::string("Your spending is"));
+  CHECK_EQ(model.cache->size(), size_t(0));
+
+  // Asked again: the model answers in full, and that reply is kept
+  CHECK_EQ(model.ask("Am I on track?"), REPLY);
+  CHECK_EQ(model.server.getRequestCount(), size_t(2));
+  CHECK_EQ(model.cache->size(), size_t(1));
+}
+
+inline void skipsInterruptedBackgroundReplies() {
+  MockModel model(MockModel::replying(REPLY), std::make_shared<ResponseCache>(), cutAfter(2));
+  CHECK(model.started);
+  json conversation = json::array();
+  std::shared_ptr<AIRequest> request = AIModule::chatAsync("Am I on track?", conversation);
+  CHECK(request->waitFor(5000));
+  CHECK_EQ(request->getResult().get(), std::string("Your spending"));
+  CHECK_EQ(model.cache->size(), size_t(0));
+}
+
+// The stream ends cleanly, but without [DONE]: the reply may be short
+inline void skipsRepliesWithoutDone() {
+  Fault noDone;
+  noDone.skipDone = true;
+  MockModel model(MockModel::replying(REPLY), std::make_shared<ResponseCache>(), noDone);
+  CHECK(model.started);
+  CHECK_EQ(model.ask("Am I on track?"), REPLY);
+  CHECK_EQ(model.cache->size(), size_t(0));
+
+  CHECK_EQ(model.ask("Am I on track?"), REPLY);
+  CHECK_EQ(model.server.getRequestCount(), size_t(2));
+  CHECK_EQ(model.cache->size(), size_t(1));
+}
+
+// Replies are keyed on the ledger and the budgets, as the AI screen sets up
+inline void missesAfterDataChanges() {
+  TestLedger ledger;
+  MockModel model(MockModel::replying(REPLY), std::make_shared<ResponseCache>());
+  CHECK(model.started);
+  model.useDataVersion(LedgerTools::getDataVersion);
+
+  uint64_t before = LedgerTools::getDataVersion();
+  model.ask("How are my budgets?");
+  model.ask("How are my budgets?");
+  CHECK_EQ(model.server.getRequestCount(), size_t(1));
+
+  CHECK(BudgetManager::setBudget("Food", 120.0));
+  CHECK(LedgerTools::getDataVersion() != before);
+  model.ask("How are my budgets?");
+  CHECK_EQ(model.server.getRequestCount(), size_t(2)); // budget_status may answer differently
+
+  CHECK(BudgetManager::setBudget("Food", 120.0)); // the same limit again
+  model.ask("How are my budgets?");
+  CHECK_EQ(model.server.getRequestCount(), size_t(2));
+
+  CHECK(BudgetManager::deleteBudget("Food"));
+  model.ask("How are my budgets?");
+  CHECK_EQ(model.server.getRequestCount(), size_t(3));
+}
+
+inline void run() {
+  TEST_GROUP("ResponseCache");
+  cachesCompleteReplies();
+  skipsInterruptedReplies();
+  skipsInterruptedBackgroundReplies();
+  skipsRepliesWithoutDone();
+  missesAfterDataChanges();
+}
+} // namespace ResponseCacheTests
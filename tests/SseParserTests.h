@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../modules/SseParser.h"
+#include "Check.h"
+
+// Decoding text/event-stream input, however the bytes are split
+
+namespace SseParserTests {
+
+// Feeds the pieces in order and collects the events
+struct Collector {
+  std::vector<std::string> events;
+  size_t stopAfter = 0; // 0 = never ask to stop
+  SseParser parser{[this](const std::string &data) {
+    events.push_back(data);
+    return stopAfter == 0 || events.size() < stopAfter;
+  }};
+
+  bool feed(const std::string &text) { return parser.feed(text.data(), text.size()); }
+};
+
+inline void splitsAcrossFeeds() {
+  const std::string stream = "data: {\"a\":1}\n\ndata: {\"b\":\"\xC3\xA9\"}\n\n";
+  // Every split point, including inside the two-byte character
+  for (size_t split = 0; split <= stream.size(); split++) {
+    Collector collector;
+    collector.feed(stream.substr(0, split));
+    collector.feed(stream.substr(split));
+    CHECK(collector.events == std::vector<std::string>({"{\"a\":1}", "{\"b\":\"\xC3\xA9\"}"}));
+  }
+
+  // One byte at a time
+  Collector bytes;
+  for (char c : stream) bytes.feed(std::string(1, c));
+  CHECK_EQ(bytes.events.size(), size_t(2));
+  CHECK_EQ(bytes.parser.getEventCount(), size_t(2));
+}
+
+inline void acceptsCrlf() {
+  Collector collector;
+  collector.feed("data: one\r\n\r\ndata: two\r");
+  collector.feed("\n\r\n");
+  CHECK(collector.events == std::vector<std::string>({"one", "two"}));
+}
+
+inline void skipsCommentsAndOtherFields() {
+  Collector collector;
+  collector.feed(": keep-alive\n\nevent: message\nid: 7\n: still here\ndata: hello\nretry: 10\n\n");
+  CHECK(collector.events == std::vector<std::string>({"hello"}));
+
+  // A comment alone, or fields without data, make no event
+  Collector quiet;
+  quiet.feed(": ping\n\nevent: nothing\n\n");
+  CHECK(quiet.events.empty());
+}
+
+inline void joinsMultiLineData() {
+  Collector collector;
+  collector.feed("data: first\ndata:second\ndata\ndata:  indented\n\n");
+  CHECK_EQ(collector.events.size(), size_t(1));
+  CHECK_EQ(collector.events[0], std::string("first\nsecond\n\n indented"));
+}
+
+inline void finishesWithoutBlankLine() {
+  Collector partial;
+  partial.feed("data: done");
+  CHECK(partial.events.empty());
+  CHECK(partial.parser.finish());
+  CHECK(partial.events == std::vector<std::string>({"done"}));
+
+  Collector unterminated;
+  unterminated.feed("data: a\n\ndata: b\n");
+  CHECK(unterminated.parser.finish());
+  CHECK(unterminated.events == std::vector<std::string>({"a", "b"}));
+
+  // Nothing pending: finish() adds nothing
+  Collector empty;
+  empty.feed("data: x\n\n");
+  CHECK(empty.parser.finish());
+  CHECK_EQ(empty.events.size(), size_t(1));
+}
+
+inline void stopsWhenAsked() {
+  Collector collector;
+  collector.stopAfter = 1;
+  CHECK(!collector.feed("data: 1\n\ndata: 2\n\ndata: 3\n\n"));
+  CHECK(collector.events == std::vector<std::string>({"1"}));
+
+  Collector atFinish;
+  atFinish.stopAfter = 1;
+  CHECK(atFinish.feed("data: last"));
+  CHECK(!atFinish.parser.finish());
+  CHECK_EQ(atFinish.events.size(), size_t(1));
+}
+
+inline void run() {
+  TEST_GROUP("SseParser");
+  splitsAcrossFeeds();
+  acceptsCrlf();
+  skipsCommentsAndOtherFields();
+  joinsMultiLineData();
+  finishesWithoutBlankLine();
+  stopsWhenAsked();
+}
+} // namespace SseParserTests
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../modules/AuthManager.h"
+#include "../modules/FileHandler.h"
+#include "../modules/LedgerHeader.h"
+#include "../modules/Transaction.h"
+#include "../modules/TransactionManager.h"
+
+// A small known ledger in its own data folder (no login: the files are
+// written without encryption). Restores the previous folder when done.
+class TestLedger {
+public:
+  static inline const std::string DIR = "test_data";
+
+  TestLedger() : previousDir(FileHandler::getDataDirectory()) {
+    FileHandler::setDataDirectory(DIR);
+    FileHandler::ensureDataDirectory();
+    FileHandler::writeTransactionsToFile(rows(), LedgerHeader(), AuthManager::getSessionKey());
+    TransactionManager::reload();
+  }
+
+  ~TestLedger() {
+    TransactionManager::unload();
+    std::remove(FileHandler::transactionsFile().c_str());
+    std::remove((DIR + "/budgets.json").c_str());
+    FileHandler::setDataDirectory(previousDir);
+  }
+
+  TestLedger(const TestLedger &) = delete;
+  TestLedger &operator=(const TestLedger &) = delete;
+
+  // In date order, as the app appends them. Food: 12.50 + 40.00 + 60.10
+  // = 112.60 over 3 rows; all expenses 1347.84
+  static std::vector<Transaction> rows() {
+    return {Transaction(1, "expense", 1200.00, "Rent January", "1 Jan, 25"),
+            Transaction(2, "expense", 12.50, "Pizza lunch", "3 Jan, 25"),
+            Transaction(3, "expense", 40.00, "Grocery run", "15 Jan, 25"),
+            Transaction(4, "income", 3000.00, "Salary", "31 Jan, 25"),
+            Transaction(5, "expense", 25.25, "Uber to airport", "2 Feb, 25"),
+            Transaction(6, "expense", 60.10, "Dinner with friends", "14 Feb, 25"),
+            Transaction(7, "expense", 9.99, "Netflix", "20 Feb, 25")};
+  }
+
+private:
+  std::string previousDir;
+};
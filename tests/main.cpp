@@ -0,0 +1,24 @@
+#include <iostream>
+
+#include "AsyncChatTests.h"
+#include "Check.h"
+#include "HttpTransportTests.h"
+#include "LedgerIndexTests.h"
+#include "LedgerToolsTests.h"
+#include "RequestPolicyTests.h"
+#include "ResponseCacheTests.h"
+#include "SseParserTests.h"
+
+// Checks for the modules that the app's screens can't exercise on their
+// own (fault handling, parsing edge cases). Built by test.bat.
+int main() {
+  std::cout << "Running AI Expense Manager tests...\n" << std::endl;
+  RequestPolicyTests::run();
+  LedgerIndexTests::run();
+  LedgerToolsTests::run();
+  SseParserTests::run();
+  HttpTransportTests::run();
+  ResponseCacheTests::run();
+  AsyncChatTests::run();
+  return Check::summary();
+}